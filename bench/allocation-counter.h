@@ -0,0 +1,54 @@
+#pragma once
+
+/*
+ * Implementation of the msdfAllocate / msdfDeallocate hooks that keeps track
+ * of the number of allocations and of the current and peak amount of allocated memory.
+ * The size is stored in front of each block because the size passed to msdfDeallocate
+ * is not guaranteed to match (e.g. when destroying polymorphic objects through a base pointer).
+ * Must only be included by a single translation unit of the benchmark executable.
+ */
+
+#include <cstdlib>
+#include <atomic>
+
+namespace msdfgen {
+
+struct AllocationCounter {
+    static std::atomic<long long> allocations;
+    static std::atomic<long long> currentBytes;
+    static std::atomic<long long> peakBytes;
+
+    /// Resets the allocation count and lowers the peak to the current amount of allocated memory
+    static void reset() {
+        allocations = 0;
+        peakBytes = currentBytes.load();
+    }
+};
+
+std::atomic<long long> AllocationCounter::allocations(0);
+std::atomic<long long> AllocationCounter::currentBytes(0);
+std::atomic<long long> AllocationCounter::peakBytes(0);
+
+}
+
+#define MSDFGEN_ALLOCATION_HEADER_SIZE 16
+
+extern "C" void *msdfAllocate(size_t size) {
+    char *block = (char *) malloc(MSDFGEN_ALLOCATION_HEADER_SIZE+size);
+    if (!block)
+        return NULL;
+    *(size_t *) block = size;
+    ++msdfgen::AllocationCounter::allocations;
+    long long current = msdfgen::AllocationCounter::currentBytes += (long long) size;
+    long long peak = msdfgen::AllocationCounter::peakBytes;
+    while (current > peak && !msdfgen::AllocationCounter::peakBytes.compare_exchange_weak(peak, current));
+    return block+MSDFGEN_ALLOCATION_HEADER_SIZE;
+}
+
+extern "C" void msdfDeallocate(void *ptr, size_t) {
+    if (ptr) {
+        char *block = (char *) ptr-MSDFGEN_ALLOCATION_HEADER_SIZE;
+        msdfgen::AllocationCounter::currentBytes -= (long long) *(size_t *) block;
+        free(block);
+    }
+}
@@ -0,0 +1,366 @@
+
+/*
+ * MSDF ATLAS GENERATOR BENCHMARK
+ * ------------------------------
+ * Builds synthetic fonts of procedurally generated glyphs with controlled complexity
+ * (Latin-like, CJK-scale and icon font corpora) and measures the throughput of each stage of the atlas build:
+ * geometry loading, packing (including the density of the guillotine and skyline packers), edge coloring, bitmap generation with varying thread counts, and export.
+ * Usage: atlas-bench [-size <px per em>] [-scale <glyph count multiplier>] [-threads <max>] [-filter <corpus>] [-json <filename.json>]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include "msdf-atlas-gen/msdf-atlas-gen.h"
+#include "allocation-counter.h"
+#include "procedural-shapes.h"
+
+using namespace msdf_atlas;
+using msdfgen::Shape;
+using msdfgen::Point2;
+using msdfgen::Random;
+using msdfgen::AllocationCounter;
+
+#define UNITS_PER_EM 1000
+#define DEFAULT_EM_SIZE 24
+#define DEFAULT_PX_RANGE 2
+#define DEFAULT_ANGLE_THRESHOLD 3
+#define DEFAULT_MITER_LIMIT 1
+
+struct CorpusProfile {
+    const char *name;
+    int glyphCount;
+    void (*buildGlyph)(Shape &shape, Random &random);
+};
+
+struct StageResult {
+    double seconds;
+    long long peakBytes;
+};
+
+struct GenerateResult {
+    int threadCount;
+    StageResult stage;
+};
+
+/// Glyph resembling a Latin letter - one or two curved outer contours, possibly with a counter and a dot
+static void buildLatinGlyph(Shape &shape, Random &random) {
+    Point2 center(250+100*random(), 350+50*random());
+    double radius = 200+100*random();
+    addBlob(shape, center, radius, random(6, 16), random);
+    if (random() < .5)
+        addBlob(shape, center, .35*radius, random(4, 8), random, true);
+    if (random() < .2)
+        addCircle(shape, center+msdfgen::Vector2(0, radius+120), 60);
+}
+
+/// Glyph resembling a CJK ideograph - many overlapping straight strokes
+static void buildCjkGlyph(Shape &shape, Random &random) {
+    int strokes = random(5, 14);
+    for (int i = 0; i < strokes; ++i) {
+        double x = 80+640*random(), y = 80+640*random(), length = 200+400*random(), width = 50+20*random();
+        switch (random(0, 2)) {
+            case 0:
+                addRectangle(shape, x, y, std::min(x+length, 920.), y+width);
+                break;
+            case 1:
+                addRectangle(shape, x, y, x+width, std::min(y+length, 920.));
+                break;
+            default: {
+                double dx = .5*length, dy = .5*length*(random()-.5);
+                Point2 quad[4] = { Point2(x, y), Point2(x+dx, y+dy), Point2(x+dx, y+dy+width), Point2(x, y+width) };
+                addPolygon(shape, quad, 4);
+            }
+        }
+    }
+}
+
+/// Glyph resembling an icon - combination of circles, rings, stars and blobs
+static void buildIconGlyph(Shape &shape, Random &random) {
+    int primitives = random(2, 5);
+    for (int i = 0; i < primitives; ++i) {
+        Point2 center(200+600*random(), 200+600*random());
+        double radius = 80+120*random();
+        switch (random(0, 3)) {
+            case 0:
+                addCircle(shape, center, radius);
+                break;
+            case 1:
+                addCircle(shape, center, radius);
+                addCircle(shape, center, .6*radius, true);
+                break;
+            case 2:
+                addStar(shape, center, radius, random(5, 12), .4+.3*random());
+                break;
+            default:
+                addBlob(shape, center, radius, random(8, 24), random);
+        }
+    }
+}
+
+static const CorpusProfile corpusProfiles[] = {
+    { "latin", 256, &buildLatinGlyph },
+    { "cjk", 2048, &buildCjkGlyph },
+    { "icons", 512, &buildIconGlyph }
+};
+
+static long long overallPeakBytes = 0;
+
+template <typename FN>
+static StageResult measure(FN fn) {
+    StageResult result;
+    long long baseline = AllocationCounter::currentBytes;
+    AllocationCounter::reset();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    fn();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    result.peakBytes = AllocationCounter::peakBytes-baseline;
+    overallPeakBytes = std::max(overallPeakBytes, AllocationCounter::peakBytes.load());
+    return result;
+}
+
+static void printStage(const char *name, const StageResult &result, int glyphCount) {
+    printf("  %-24s %10.3f ms %12.0f glyphs/s %10.2f MiB\n", name, 1e3*result.seconds, glyphCount/result.seconds, result.peakBytes/1048576.);
+}
+
+static void writeStage(FILE *json, const char *name, const StageResult &result, int glyphCount) {
+    fprintf(json, "\"%s\":{\"seconds\":%.9g,\"glyphsPerSecond\":%.9g,\"peakBytes\":%lld},", name, result.seconds, glyphCount/result.seconds, result.peakBytes);
+}
+
+/// Returns the portion of the atlas area covered by glyph boxes
+static double packingDensity(const std::vector<GlyphGeometry, Allocator<GlyphGeometry>> &glyphs, int width, int height) {
+    double boxArea = 0;
+    for (const GlyphGeometry &glyph : glyphs) {
+        int w = 0, h = 0;
+        if (!glyph.isWhitespace())
+            glyph.getBoxSize(w, h);
+        boxArea += (double) w*h;
+    }
+    return boxArea/((double) width*height);
+}
+
+static bool runCorpus(const CorpusProfile &profile, int glyphCount, double emSize, const std::vector<int> &threadCounts, FILE *json) {
+    // Generate shapes outside of the measured stages
+    Random random(0x61746c73u^(unsigned long long) profile.glyphCount);
+    overallPeakBytes = 0;
+    std::vector<Shape, Allocator<Shape>> shapes(glyphCount);
+    int edgeCount = 0;
+    for (Shape &shape : shapes) {
+        profile.buildGlyph(shape, random);
+        edgeCount += shape.edgeCount();
+    }
+    printf("Corpus %s: %d glyphs, %d edges\n", profile.name, glyphCount, edgeCount);
+
+    std::vector<GlyphGeometry, Allocator<GlyphGeometry>> glyphs;
+    FontGeometry font(&glyphs);
+    StageResult loadResult = measure([&]() {
+        glyphs.reserve(glyphCount);
+        for (int i = 0; i < glyphCount; ++i) {
+            GlyphGeometry glyph;
+            if (glyph.load(shapes[i], 1./UNITS_PER_EM, msdfgen::GlyphIndex(i+1), unicode_t(0x4e00+i), UNITS_PER_EM, false))
+                font.addGlyph((GlyphGeometry &&) glyph);
+        }
+    });
+    if ((int) glyphs.size() != glyphCount) {
+        fprintf(stderr, "Failed to load synthetic glyphs.\n");
+        return false;
+    }
+    printStage("load", loadResult, glyphCount);
+
+    int width = 0, height = 0;
+    StageResult tightPackResult = measure([&]() {
+        TightAtlasPacker packer;
+        packer.setDimensionsConstraint(DimensionsConstraint::MULTIPLE_OF_FOUR_SQUARE);
+        packer.setScale(emSize);
+        packer.setPixelRange(DEFAULT_PX_RANGE);
+        packer.setMiterLimit(DEFAULT_MITER_LIMIT);
+        if (!packer.pack(glyphs.data(), (int) glyphs.size()))
+            packer.getDimensions(width, height);
+    });
+    if (!(width > 0 && height > 0)) {
+        fprintf(stderr, "Failed to pack synthetic glyphs.\n");
+        return false;
+    }
+    printStage("pack (tight)", tightPackResult, glyphCount);
+    double tightDensity = packingDensity(glyphs, width, height);
+    printf("  %-24s %10.1f %% (%d x %d)\n", "  density", 100*tightDensity, width, height);
+
+    std::vector<GlyphGeometry, Allocator<GlyphGeometry>> skylineGlyphs(glyphs);
+    int skylineWidth = 0, skylineHeight = 0;
+    StageResult skylinePackResult = measure([&]() {
+        TightAtlasPacker packer;
+        packer.setSkylinePacking(true);
+        packer.setDimensionsConstraint(DimensionsConstraint::MULTIPLE_OF_FOUR_SQUARE);
+        packer.setScale(emSize);
+        packer.setPixelRange(DEFAULT_PX_RANGE);
+        packer.setMiterLimit(DEFAULT_MITER_LIMIT);
+        if (!packer.pack(skylineGlyphs.data(), (int) skylineGlyphs.size()))
+            packer.getDimensions(skylineWidth, skylineHeight);
+    });
+    if (!(skylineWidth > 0 && skylineHeight > 0)) {
+        fprintf(stderr, "Failed to pack synthetic glyphs.\n");
+        return false;
+    }
+    double skylineDensity = packingDensity(skylineGlyphs, skylineWidth, skylineHeight);
+    skylineGlyphs.clear();
+    skylineGlyphs.shrink_to_fit();
+    printStage("pack (skyline)", skylinePackResult, glyphCount);
+    printf("  %-24s %10.1f %% (%d x %d)\n", "  density", 100*skylineDensity, skylineWidth, skylineHeight);
+
+    std::vector<GlyphGeometry, Allocator<GlyphGeometry>> gridGlyphs(glyphs);
+    StageResult gridPackResult = measure([&]() {
+        GridAtlasPacker packer;
+        packer.setDimensionsConstraint(DimensionsConstraint::MULTIPLE_OF_FOUR_SQUARE);
+        packer.setScale(emSize);
+        packer.setPixelRange(DEFAULT_PX_RANGE);
+        packer.setMiterLimit(DEFAULT_MITER_LIMIT);
+        packer.pack(gridGlyphs.data(), (int) gridGlyphs.size());
+    });
+    gridGlyphs.clear();
+    gridGlyphs.shrink_to_fit();
+    printStage("pack (grid)", gridPackResult, glyphCount);
+
+    StageResult coloringResult = measure([&]() {
+        for (GlyphGeometry &glyph : glyphs)
+            glyph.edgeColoring(&msdfgen::edgeColoringInkTrap, DEFAULT_ANGLE_THRESHOLD, 0);
+    });
+    printStage("edge coloring", coloringResult, glyphCount);
+
+    GeneratorAttributes attributes;
+    attributes.config.overlapSupport = true;
+    attributes.scanlinePass = true;
+    attributes.config.errorCorrection.distanceCheckMode = msdfgen::ErrorCorrectionConfig::DO_NOT_CHECK_DISTANCE;
+    std::vector<GenerateResult> generateResults;
+    BitmapAtlasStorage<byte, 3> atlas;
+    for (int threadCount : threadCounts) {
+        GenerateResult result;
+        result.threadCount = threadCount;
+        result.stage = measure([&]() {
+            ImmediateAtlasGenerator<float, 3, msdfGenerator, BitmapAtlasStorage<byte, 3> > generator(width, height);
+            generator.setAttributes(attributes);
+            generator.setThreadCount(threadCount);
+            generator.generate(glyphs.data(), (int) glyphs.size());
+            atlas = generator.atlasStorage();
+        });
+        generateResults.push_back(result);
+        char name[32];
+        sprintf(name, "generate (%d threads)", threadCount);
+        printStage(name, result.stage, glyphCount);
+        printf("  %-24s %10.1f %%\n", "  scaling efficiency", 100*generateResults.front().stage.seconds/(threadCount*result.stage.seconds));
+    }
+
+    std::string imageFilename = std::string("atlas-bench-")+profile.name+".png";
+    std::string jsonFilename = std::string("atlas-bench-")+profile.name+".json";
+    std::string csvFilename = std::string("atlas-bench-")+profile.name+".csv";
+    bool exported = true;
+    const BitmapAtlasStorage<byte, 3> &atlasImage = atlas;
+    StageResult imageExportResult = measure([&]() {
+        #ifndef MSDFGEN_DISABLE_PNG
+            exported &= saveImage((msdfgen::BitmapConstRef<byte, 3>) atlasImage, ImageFormat::PNG, imageFilename.c_str());
+        #else
+            exported &= saveImage((msdfgen::BitmapConstRef<byte, 3>) atlasImage, ImageFormat::BMP, imageFilename.c_str());
+        #endif
+    });
+    printStage("export image", imageExportResult, glyphCount);
+    StageResult layoutExportResult = measure([&]() {
+        JsonAtlasMetrics metrics = { };
+        metrics.distanceRange = DEFAULT_PX_RANGE;
+        metrics.size = emSize;
+        metrics.width = width, metrics.height = height;
+        metrics.yDirection = YDirection::BOTTOM_UP;
+        exported &= exportJSON(&font, 1, ImageType::MSDF, metrics, jsonFilename.c_str(), false);
+        exported &= exportCSV(&font, 1, width, height, YDirection::BOTTOM_UP, csvFilename.c_str());
+    });
+    printStage("export layout", layoutExportResult, glyphCount);
+    remove(imageFilename.c_str());
+    remove(jsonFilename.c_str());
+    remove(csvFilename.c_str());
+    if (!exported) {
+        fprintf(stderr, "Failed to export atlas.\n");
+        return false;
+    }
+    printf("  atlas %d x %d, peak memory %.2f MiB\n", width, height, overallPeakBytes/1048576.);
+
+    if (json) {
+        fprintf(json, "{\"name\":\"%s\",\"glyphs\":%d,\"edges\":%d,\"width\":%d,\"height\":%d,", profile.name, glyphCount, edgeCount, width, height);
+        writeStage(json, "load", loadResult, glyphCount);
+        writeStage(json, "packTight", tightPackResult, glyphCount);
+        writeStage(json, "packSkyline", skylinePackResult, glyphCount);
+        fprintf(json, "\"densityTight\":%.9g,\"densitySkyline\":%.9g,\"skylineWidth\":%d,\"skylineHeight\":%d,", tightDensity, skylineDensity, skylineWidth, skylineHeight);
+        writeStage(json, "packGrid", gridPackResult, glyphCount);
+        writeStage(json, "edgeColoring", coloringResult, glyphCount);
+        fputs("\"generate\":[", json);
+        for (const GenerateResult &result : generateResults) {
+            fprintf(json, "%s{\"threads\":%d,\"seconds\":%.9g,\"glyphsPerSecond\":%.9g,\"efficiency\":%.9g,\"peakBytes\":%lld}",
+                &result == &generateResults.front() ? "" : ",", result.threadCount, result.stage.seconds, glyphCount/result.stage.seconds,
+                generateResults.front().stage.seconds/(result.threadCount*result.stage.seconds), result.stage.peakBytes
+            );
+        }
+        fputs("],", json);
+        writeStage(json, "exportImage", imageExportResult, glyphCount);
+        writeStage(json, "exportLayout", layoutExportResult, glyphCount);
+        fprintf(json, "\"peakBytes\":%lld}", overallPeakBytes);
+    }
+    return true;
+}
+
+int main(int argc, const char *const *argv) {
+    double emSize = DEFAULT_EM_SIZE;
+    double glyphCountScale = 1;
+    int maxThreads = 0;
+    const char *filter = NULL;
+    const char *jsonFilename = NULL;
+    for (int argPos = 1; argPos < argc; ++argPos) {
+        if (!strcmp(argv[argPos], "-size") && argPos+1 < argc && (emSize = atof(argv[++argPos])) > 0)
+            continue;
+        if (!strcmp(argv[argPos], "-scale") && argPos+1 < argc && (glyphCountScale = atof(argv[++argPos])) > 0)
+            continue;
+        if (!strcmp(argv[argPos], "-threads") && argPos+1 < argc && (maxThreads = atoi(argv[++argPos])) > 0)
+            continue;
+        if (!strcmp(argv[argPos], "-filter") && argPos+1 < argc) {
+            filter = argv[++argPos];
+            continue;
+        }
+        if (!strcmp(argv[argPos], "-json") && argPos+1 < argc) {
+            jsonFilename = argv[++argPos];
+            continue;
+        }
+        fputs("Usage: atlas-bench [-size <px per em>] [-scale <glyph count multiplier>] [-threads <max>] [-filter <corpus>] [-json <filename.json>]\n", stderr);
+        return 1;
+    }
+    if (maxThreads <= 0)
+        maxThreads = std::max((int) std::thread::hardware_concurrency(), 1);
+    std::vector<int> threadCounts;
+    for (int threadCount = 1; threadCount < maxThreads; threadCount *= 2)
+        threadCounts.push_back(threadCount);
+    threadCounts.push_back(maxThreads);
+
+    FILE *json = NULL;
+    if (jsonFilename) {
+        if (!(json = fopen(jsonFilename, "w"))) {
+            fputs("Failed to open JSON output file.\n", stderr);
+            return 1;
+        }
+        fprintf(json, "{\"benchmark\":\"atlas-bench\",\"size\":%.9g,\"pxRange\":%d,\"corpora\":[", emSize, DEFAULT_PX_RANGE);
+    }
+    int result = 0;
+    bool first = true;
+    for (const CorpusProfile &profile : corpusProfiles) {
+        if (filter && strcmp(profile.name, filter))
+            continue;
+        if (json && !first)
+            fputs(",", json);
+        first = false;
+        if (!runCorpus(profile, std::max((int) (glyphCountScale*profile.glyphCount), 1), emSize, threadCounts, json))
+            result = 1;
+    }
+    if (json) {
+        fputs("]}\n", json);
+        fclose(json);
+    }
+    return result;
+}
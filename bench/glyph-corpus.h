@@ -0,0 +1,54 @@
+#pragma once
+
+/*
+ * Glyph outlines of DejaVu Sans in font units (2048 per em) stored as shape descriptions,
+ * used as a fixed real-world corpus by the benchmarks.
+ * DejaVu fonts are derived from Bitstream Vera; see https://dejavu-fonts.github.io/License.html
+ */
+
+namespace msdfgen {
+
+struct CorpusGlyph {
+    const char *name;
+    const char *shapeDescription;
+};
+
+static const CorpusGlyph corpusGlyphs[] = {
+    { "a (U+0061)",
+        "{702,563;(479,563);393,512;(307,461);307,338;(307,240);371,182;(436,125);547,125;(700,125);792,233;(885,342);885,522;885,563;#} "
+        "{1069,639;1069,0;885,0;885,170;(822,68);728,19;(634,-29);498,-29;(326,-29);224,67;(123,164);123,326;(123,515);249,611;(376,707);627,707;885,707;885,725;(885,852);801,921;(718,991);567,991;(471,991);380,968;(289,945);205,899;205,1069;(306,1108);401,1127;(496,1147);586,1147;(829,1147);949,1021;(1069,895);#}" },
+    { "g (U+0067)",
+        "{930,573;(930,773);847,883;(765,993);616,993;(468,993);385,883;(303,773);303,573;(303,374);385,264;(468,154);616,154;(765,154);847,264;(930,374);#} "
+        "{1114,139;(1114,-147);987,-286;(860,-426);598,-426;(501,-426);415,-411;(329,-397);248,-367;248,-188;(329,-232);408,-253;(487,-274);569,-274;(750,-274);840,-179;(930,-85);930,106;930,197;(873,98);784,49;(695,0);571,0;(365,0);239,157;(113,314);113,573;(113,833);239,990;(365,1147);571,1147;(695,1147);784,1098;(873,1049);930,950;930,1120;1114,1120;#}" },
+    { "S (U+0053)",
+        "{1096,1444;1096,1247;(981,1302);879,1329;(777,1356);682,1356;(517,1356);427,1292;(338,1228);338,1110;(338,1011);397,960;(457,910);623,879;745,854;(971,811);1078,702;(1186,594);1186,412;(1186,195);1040,83;(895,-29);614,-29;(508,-29);388,-5;(269,19);141,66;141,274;(264,205);382,170;(500,135);614,135;(787,135);881,203;(975,271);975,397;(975,507);907,569;(840,631);686,662;563,686;(337,731);236,827;(135,923);135,1094;(135,1292);274,1406;(414,1520);659,1520;(764,1520);873,1501;(982,1482);#}" },
+    { "ampersand (U+0026)",
+        "{498,803;(407,722);364,641;(322,561);322,473;(322,327);428,230;(534,133);694,133;(789,133);872,164;(955,196);1028,260;#} "
+        "{639,915;1147,395;(1206,484);1239,585;(1272,687);1278,801;1464,801;(1452,669);1400,540;(1348,411);1255,285;1534,0;1282,0;1139,147;(1035,58);921,14;(807,-29);676,-29;(435,-29);282,108;(129,246);129,461;(129,589);196,701;(263,814);397,913;(349,976);324,1038;(299,1101);299,1161;(299,1323);410,1421;(521,1520);705,1520;(788,1520);870,1502;(953,1484);1038,1448;1038,1266;(951,1313);872,1337;(793,1362);725,1362;(620,1362);554,1306;(489,1251);489,1163;(489,1112);518,1060;(548,1009);#}" },
+    { "at (U+0040)",
+        "{762,537;(762,394);833,312;(904,231);1028,231;(1151,231);1221,313;(1292,395);1292,537;(1292,677);1220,759;(1148,842);1026,842;(905,842);833,760;(762,678);#} "
+        "{1307,238;(1247,161);1169,124;(1092,88);989,88;(817,88);709,212;(602,337);602,537;(602,737);710,862;(818,987);989,987;(1092,987);1170,949;(1248,912);1307,836;1307,967;1450,967;1450,231;(1596,253);1678,364;(1761,476);1761,653;(1761,760);1729,854;(1698,948);1634,1028;(1530,1159);1380,1228;(1231,1298);1055,1298;(932,1298);819,1265;(706,1233);610,1169;(453,1067);364,901;(276,736);276,543;(276,384);333,245;(391,106);500,0;(605,-104);743,-158;(881,-213);1038,-213;(1167,-213);1291,-169;(1416,-126);1520,-45;1610,-156;(1485,-253);1337,-304;(1190,-356);1038,-356;(853,-356);689,-290;(525,-225);397,-100;(269,25);202,189;(135,354);135,543;(135,725);203,890;(271,1055);397,1180;(526,1307);695,1374;(864,1442);1053,1442;(1265,1442);1446,1355;(1628,1268);1751,1108;(1826,1010);1865,895;(1905,780);1905,657;(1905,394);1746,242;(1587,90);1307,84;#}" },
+    { "Q (U+0051)",
+        "{807,1356;(587,1356);457,1192;(328,1028);328,745;(328,463);457,299;(587,135);807,135;(1027,135);1155,299;(1284,463);1284,745;(1284,1028);1155,1192;(1027,1356);#} "
+        "{1090,27;1356,-264;1112,-264;891,-25;(858,-27);840,-28;(823,-29);807,-29;(492,-29);303,181;(115,392);115,745;(115,1099);303,1309;(492,1520);807,1520;(1121,1520);1309,1309;(1497,1099);1497,745;(1497,485);1392,300;(1288,115);#}" },
+    { "eight (U+0038)",
+        "{651,709;(507,709);424,632;(342,555);342,420;(342,285);424,208;(507,131);651,131;(795,131);878,208;(961,286);961,420;(961,555);878,632;(796,709);#} "
+        "{449,795;(319,827);246,916;(174,1005);174,1133;(174,1312);301,1416;(429,1520);651,1520;(874,1520);1001,1416;(1128,1312);1128,1133;(1128,1005);1055,916;(983,827);854,795;(1000,761);1081,662;(1163,563);1163,420;(1163,203);1030,87;(898,-29);651,-29;(404,-29);271,87;(139,203);139,420;(139,563);221,662;(303,761);#} "
+        "{375,1114;(375,998);447,933;(520,868);651,868;(781,868);854,933;(928,998);928,1114;(928,1230);854,1295;(781,1360);651,1360;(520,1360);447,1295;(375,1230);#}" },
+    { "percent (U+0025)",
+        "{1489,657;(1402,657);1352,583;(1303,509);1303,377;(1303,247);1352,172;(1402,98);1489,98;(1574,98);1623,172;(1673,247);1673,377;(1673,508);1623,582;(1574,657);#} "
+        "{1489,784;(1647,784);1740,674;(1833,564);1833,377;(1833,190);1739,80;(1646,-29);1489,-29;(1329,-29);1236,80;(1143,190);1143,377;(1143,565);1236,674;(1330,784);#} "
+        "{457,1393;(371,1393);321,1318;(272,1244);272,1114;(272,982);321,908;(370,834);457,834;(544,834);593,908;(643,982);643,1114;(643,1243);593,1318;(543,1393);#} "
+        "{1360,1520;1520,1520;586,-29;426,-29;#} "
+        "{457,1520;(615,1520);709,1410;(803,1301);803,1114;(803,925);709,816;(616,707);457,707;(298,707);205,816;(113,926);113,1114;(113,1300);206,1410;(299,1520);#}" },
+    { "sharp-s (U+00DF)",
+        "{186,1137;(186,1337);305,1446;(425,1556);643,1556;(851,1556);960,1440;(1070,1324);1073,1100;(922,1092);838,1034;(754,977);754,881;(754,834);783,793;(812,753);877,711;934,674;(1100,568);1148,497;(1196,426);1196,326;(1196,154);1083,62;(971,-29);760,-29;(696,-29);628,-16;(560,-4);487,20;487,184;(567,154);637,139;(707,125);772,125;(888,125);948,172;(1008,220);1008,311;(1008,374);978,416;(949,458);848,520;756,575;(660,634);616,701;(573,769);573,860;(573,987);656,1073;(740,1159);891,1188;(883,1291);817,1347;(752,1403);639,1403;(509,1403);441,1333;(373,1264);373,1133;373,0;186,0;#}" },
+    { "cyrillic-zhe (U+0416)",
+        "{1002,1493;1204,1493;1204,755;1886,1493;2131,1493;1586,904;2166,0;1955,0;1462,769;1204,490;1204,0;1002,0;1002,490;744,769;251,0;40,0;620,904;75,1493;320,1493;1002,755;#}" },
+    { "euro (U+20AC)",
+        "{1167,1378;1167,1165;(1076,1270);991,1315;(907,1360);805,1360;(648,1360);547,1260;(446,1160);414,973;991,973;936,850;398,850;(396,826);395,803;395,745;395,690;(396,667);398,643;844,643;788,520;414,520;(446,333);547,232;(648,131);805,131;(907,131);991,176;(1076,221);1167,326;1167,115;(1078,43);985,7;(893,-29);797,-29;(560,-29);405,116;(251,261);211,520;0,520;55,643;194,643;(194,666);193,689;193,745;193,803;(194,827);194,850;0,850;55,973;211,973;(251,1230);406,1375;(561,1520);797,1520;(895,1520);987,1484;(1080,1449);#}" },
+    { "omega (U+03C9)",
+        "{550,-29;(135,-29);135,565;(135,800);290,1120;488,1120;(345,800);345,560;(345,127);567,127;(770,127);770,665;940,665;(940,127);1143,127;(1365,127);1365,560;(1365,800);1222,1120;1420,1120;(1575,800);1575,565;(1575,-29);1160,-29;(888,-29);855,270;(814,-29);#}" },
+};
+
+}
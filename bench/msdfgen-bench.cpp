@@ -0,0 +1,319 @@
+
+/*
+ * MSDFGEN GENERATOR BENCHMARK
+ * ---------------------------
+ * Runs a fixed corpus of shapes through each distance field generator configuration
+ * and reports throughput in megapixels and edge-pixels per second, as well as the number of allocations.
+ * Usage: msdfgen-bench [-size <px>] [-mintime <seconds>] [-filter <substring>] [-json <filename.json>]
+ */
+
+#define _USE_MATH_DEFINES
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include "msdfgen.h"
+#include "allocation-counter.h"
+#include "procedural-shapes.h"
+#include "glyph-corpus.h"
+
+using namespace msdfgen;
+
+#define DEFAULT_SIZE 64
+#define DEFAULT_MIN_TIME 0.25
+#define DEFAULT_PX_RANGE 4
+#define DEFAULT_ANGLE_THRESHOLD 3
+
+enum Mode {
+    SDF,
+    PSDF,
+    MSDF,
+    MTSDF
+};
+
+struct ErrorCorrectionMode {
+    const char *name;
+    ErrorCorrectionConfig::Mode mode;
+    ErrorCorrectionConfig::DistanceCheckMode distanceCheckMode;
+};
+
+static const ErrorCorrectionMode errorCorrectionModes[] = {
+    { "disabled", ErrorCorrectionConfig::DISABLED, ErrorCorrectionConfig::DO_NOT_CHECK_DISTANCE },
+    { "distance-fast", ErrorCorrectionConfig::INDISCRIMINATE, ErrorCorrectionConfig::DO_NOT_CHECK_DISTANCE },
+    { "distance-full", ErrorCorrectionConfig::INDISCRIMINATE, ErrorCorrectionConfig::ALWAYS_CHECK_DISTANCE },
+    { "edge-fast", ErrorCorrectionConfig::EDGE_ONLY, ErrorCorrectionConfig::DO_NOT_CHECK_DISTANCE },
+    { "edge-full", ErrorCorrectionConfig::EDGE_ONLY, ErrorCorrectionConfig::ALWAYS_CHECK_DISTANCE },
+    { "auto-fast", ErrorCorrectionConfig::EDGE_PRIORITY, ErrorCorrectionConfig::DO_NOT_CHECK_DISTANCE },
+    { "auto-mixed", ErrorCorrectionConfig::EDGE_PRIORITY, ErrorCorrectionConfig::CHECK_DISTANCE_AT_EDGE },
+    { "auto-full", ErrorCorrectionConfig::EDGE_PRIORITY, ErrorCorrectionConfig::ALWAYS_CHECK_DISTANCE }
+};
+
+struct BenchmarkShape {
+    const char *name;
+    Shape shape;
+    SDFTransformation transformation;
+};
+
+struct BenchmarkCase {
+    char name[64];
+    Mode mode;
+    bool overlapSupport;
+    bool scanlinePass;
+    const ErrorCorrectionMode *errorCorrection;
+};
+
+struct BenchmarkResult {
+    int passes;
+    double seconds;
+    double pixels;
+    double edgePixels;
+    long long allocations;
+};
+
+static Shape makeStar(int points, double innerRatio) {
+    Shape shape;
+    addStar(shape, Point2(), 1, points, innerRatio);
+    return shape;
+}
+
+static Shape makeBlob(int segments, Random &random) {
+    Shape shape;
+    addBlob(shape, Point2(), 1, segments, random);
+    return shape;
+}
+
+static Shape makeRing() {
+    Shape shape;
+    addCircle(shape, Point2(), 1);
+    addCircle(shape, Point2(), .6, true);
+    return shape;
+}
+
+static Shape makeOverlappingCircles(int count) {
+    Shape shape;
+    for (int i = 0; i < count; ++i) {
+        double angle = 2*M_PI*i/count;
+        addCircle(shape, Point2(.5*cos(angle), .5*sin(angle)), .6);
+    }
+    return shape;
+}
+
+static Shape makeGrid(int cells) {
+    Shape shape;
+    for (int y = 0; y < cells; ++y) {
+        for (int x = 0; x < cells; ++x)
+            addRectangle(shape, x, y, x+.7, y+.7);
+    }
+    return shape;
+}
+
+static const char *const handwrittenShapes[][2] = {
+    { "description: A", "{ 1471,0; 1149,0; 1021,333; 435,333; 314,0; 0,0; 571,1466; 884,1466; # }{ 926,580; 724,1124; 526,580; # }" },
+    { "description: rounded rectangle", "{ 0,10; 0,50; (0,60); 10,60; 90,60; (100,60); 100,50; 100,10; (100,0); 90,0; 10,0; (0,0); # }" },
+    { "description: crescent", "{ 0,0; (-50,50); 0,100; (20,70); 20,50; (20,30); # }" },
+    { "description: heart", "{ 50,0; (20,30; 0,50); 0,70; (0,95; 25,105); 50,85; (75,105; 100,95); 100,70; (100,50; 80,30); # }" }
+};
+
+static bool frameShape(BenchmarkShape &benchmarkShape, int size) {
+    Shape &shape = benchmarkShape.shape;
+    if (!shape.validate())
+        return false;
+    shape.normalize();
+    Shape::Bounds bounds = shape.getBounds();
+    double frame = size-DEFAULT_PX_RANGE;
+    if (!(bounds.r > bounds.l && bounds.t > bounds.b))
+        return false;
+    double scale = std::min(frame/(bounds.r-bounds.l), frame/(bounds.t-bounds.b));
+    Vector2 translate(.5*(size/scale-bounds.r-bounds.l), .5*(size/scale-bounds.t-bounds.b));
+    benchmarkShape.transformation = SDFTransformation(Projection(scale, translate), Range(DEFAULT_PX_RANGE/scale));
+    edgeColoringSimple(shape, DEFAULT_ANGLE_THRESHOLD);
+    return true;
+}
+
+static bool buildCorpus(std::vector<BenchmarkShape> &corpus, int size) {
+    Random random(0x6d736466u);
+    corpus.resize(8+sizeof(handwrittenShapes)/sizeof(*handwrittenShapes)+sizeof(corpusGlyphs)/sizeof(*corpusGlyphs));
+    std::vector<BenchmarkShape>::iterator it = corpus.begin();
+    it->name = "procedural: star 5", it->shape = makeStar(5, .4), ++it;
+    it->name = "procedural: star 64", it->shape = makeStar(64, .9), ++it;
+    it->name = "procedural: circle", addCircle(it->shape, Point2(), 1), ++it;
+    it->name = "procedural: ring", it->shape = makeRing(), ++it;
+    it->name = "procedural: blob 12", it->shape = makeBlob(12, random), ++it;
+    it->name = "procedural: blob 96", it->shape = makeBlob(96, random), ++it;
+    it->name = "procedural: overlapping circles", it->shape = makeOverlappingCircles(5), ++it;
+    it->name = "procedural: grid 8x8", it->shape = makeGrid(8), ++it;
+    for (const char *const *description : handwrittenShapes) {
+        it->name = description[0];
+        if (!readShapeDescription(description[1], it->shape))
+            return false;
+        ++it;
+    }
+    for (const CorpusGlyph &glyph : corpusGlyphs) {
+        it->name = glyph.name;
+        if (!readShapeDescription(glyph.shapeDescription, it->shape))
+            return false;
+        ++it;
+    }
+    for (BenchmarkShape &benchmarkShape : corpus) {
+        if (!frameShape(benchmarkShape, size)) {
+            fprintf(stderr, "Invalid benchmark shape: %s\n", benchmarkShape.name);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void buildCases(std::vector<BenchmarkCase> &cases) {
+    static const char *const modeNames[] = { "sdf", "psdf", "msdf", "mtsdf" };
+    for (int mode = SDF; mode <= MTSDF; ++mode) {
+        for (int overlapSupport = 1; overlapSupport >= 0; --overlapSupport) {
+            for (int scanlinePass = 0; scanlinePass <= 1; ++scanlinePass) {
+                int errorCorrectionModeCount = mode == MSDF || mode == MTSDF ? (int) (sizeof(errorCorrectionModes)/sizeof(*errorCorrectionModes)) : 1;
+                for (int i = 0; i < errorCorrectionModeCount; ++i) {
+                    BenchmarkCase benchmarkCase;
+                    benchmarkCase.mode = Mode(mode);
+                    benchmarkCase.overlapSupport = overlapSupport != 0;
+                    benchmarkCase.scanlinePass = scanlinePass != 0;
+                    benchmarkCase.errorCorrection = errorCorrectionModes+i;
+                    if (mode == MSDF || mode == MTSDF)
+                        sprintf(benchmarkCase.name, "%s/%s/%s/%s", modeNames[mode], overlapSupport ? "overlap" : "nooverlap", scanlinePass ? "scanline" : "noscanline", errorCorrectionModes[i].name);
+                    else
+                        sprintf(benchmarkCase.name, "%s/%s/%s", modeNames[mode], overlapSupport ? "overlap" : "nooverlap", scanlinePass ? "scanline" : "noscanline");
+                    cases.push_back(benchmarkCase);
+                }
+            }
+        }
+    }
+}
+
+/// Generates the distance field of a single shape the same way the standalone executable does
+static void generate(const BenchmarkCase &benchmarkCase, const BenchmarkShape &benchmarkShape, const BitmapRef<float, 1> &sdf, const BitmapRef<float, 3> &msdf, const BitmapRef<float, 4> &mtsdf) {
+    const Shape &shape = benchmarkShape.shape;
+    const SDFTransformation &transformation = benchmarkShape.transformation;
+    GeneratorConfig config(benchmarkCase.overlapSupport);
+    MSDFGeneratorConfig msdfConfig(benchmarkCase.overlapSupport, ErrorCorrectionConfig(benchmarkCase.errorCorrection->mode, benchmarkCase.errorCorrection->distanceCheckMode));
+    MSDFGeneratorConfig postErrorCorrectionConfig(msdfConfig);
+    if (benchmarkCase.scanlinePass) {
+        msdfConfig.errorCorrection.mode = ErrorCorrectionConfig::DISABLED;
+        postErrorCorrectionConfig.errorCorrection.distanceCheckMode = ErrorCorrectionConfig::DO_NOT_CHECK_DISTANCE;
+    }
+    switch (benchmarkCase.mode) {
+        case SDF:
+            generateSDF(sdf, shape, transformation, config);
+            if (benchmarkCase.scanlinePass)
+                distanceSignCorrection(sdf, shape, transformation);
+            break;
+        case PSDF:
+            generatePSDF(sdf, shape, transformation, config);
+            if (benchmarkCase.scanlinePass)
+                distanceSignCorrection(sdf, shape, transformation);
+            break;
+        case MSDF:
+            generateMSDF(msdf, shape, transformation, msdfConfig);
+            if (benchmarkCase.scanlinePass) {
+                distanceSignCorrection(msdf, shape, transformation);
+                msdfErrorCorrection(msdf, shape, transformation, postErrorCorrectionConfig);
+            }
+            break;
+        case MTSDF:
+            generateMTSDF(mtsdf, shape, transformation, msdfConfig);
+            if (benchmarkCase.scanlinePass) {
+                distanceSignCorrection(mtsdf, shape, transformation);
+                msdfErrorCorrection(mtsdf, shape, transformation, postErrorCorrectionConfig);
+            }
+            break;
+    }
+}
+
+static BenchmarkResult runCase(const BenchmarkCase &benchmarkCase, const std::vector<BenchmarkShape> &corpus, int size, double minTime) {
+    Bitmap<float, 1> sdf(size, size);
+    Bitmap<float, 3> msdf(size, size);
+    Bitmap<float, 4> mtsdf(size, size);
+    double corpusEdges = 0;
+    for (const BenchmarkShape &benchmarkShape : corpus)
+        corpusEdges += benchmarkShape.shape.edgeCount();
+
+    // Warm-up pass
+    for (const BenchmarkShape &benchmarkShape : corpus)
+        generate(benchmarkCase, benchmarkShape, sdf, msdf, mtsdf);
+
+    BenchmarkResult result = { };
+    AllocationCounter::reset();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    do {
+        for (const BenchmarkShape &benchmarkShape : corpus)
+            generate(benchmarkCase, benchmarkShape, sdf, msdf, mtsdf);
+        ++result.passes;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    } while (result.seconds < minTime);
+    result.allocations = AllocationCounter::allocations;
+    result.pixels = (double) result.passes*corpus.size()*size*size;
+    result.edgePixels = (double) result.passes*corpusEdges*size*size;
+    return result;
+}
+
+int main(int argc, const char *const *argv) {
+    int size = DEFAULT_SIZE;
+    double minTime = DEFAULT_MIN_TIME;
+    const char *filter = NULL;
+    const char *jsonFilename = NULL;
+    for (int argPos = 1; argPos < argc; ++argPos) {
+        if (!strcmp(argv[argPos], "-size") && argPos+1 < argc && (size = atoi(argv[++argPos])) > DEFAULT_PX_RANGE)
+            continue;
+        if (!strcmp(argv[argPos], "-mintime") && argPos+1 < argc && (minTime = atof(argv[++argPos])) >= 0)
+            continue;
+        if (!strcmp(argv[argPos], "-filter") && argPos+1 < argc) {
+            filter = argv[++argPos];
+            continue;
+        }
+        if (!strcmp(argv[argPos], "-json") && argPos+1 < argc) {
+            jsonFilename = argv[++argPos];
+            continue;
+        }
+        fputs("Usage: msdfgen-bench [-size <px>] [-mintime <seconds>] [-filter <substring>] [-json <filename.json>]\n", stderr);
+        return 1;
+    }
+
+    std::vector<BenchmarkShape> corpus;
+    if (!buildCorpus(corpus, size))
+        return 1;
+    int corpusEdges = 0;
+    for (const BenchmarkShape &benchmarkShape : corpus)
+        corpusEdges += benchmarkShape.shape.edgeCount();
+    std::vector<BenchmarkCase> cases;
+    buildCases(cases);
+
+    FILE *json = NULL;
+    if (jsonFilename) {
+        if (!(json = fopen(jsonFilename, "w"))) {
+            fputs("Failed to open JSON output file.\n", stderr);
+            return 1;
+        }
+        fprintf(json, "{\"benchmark\":\"msdfgen-bench\",\"size\":%d,\"pxRange\":%d,\"shapes\":%d,\"edges\":%d,\"results\":[", size, DEFAULT_PX_RANGE, (int) corpus.size(), corpusEdges);
+    }
+    printf("Corpus: %d shapes, %d edges, %d x %d pixels each\n", (int) corpus.size(), corpusEdges, size, size);
+    printf("%-40s %10s %14s %14s\n", "configuration", "Mpixel/s", "Medge*px/s", "allocs/pass");
+    bool first = true;
+    for (const BenchmarkCase &benchmarkCase : cases) {
+        if (filter && !strstr(benchmarkCase.name, filter))
+            continue;
+        BenchmarkResult result = runCase(benchmarkCase, corpus, size, minTime);
+        double mpixelsPerSecond = 1e-6*result.pixels/result.seconds;
+        double medgePixelsPerSecond = 1e-6*result.edgePixels/result.seconds;
+        double allocationsPerPass = (double) result.allocations/result.passes;
+        printf("%-40s %10.3f %14.3f %14.1f\n", benchmarkCase.name, mpixelsPerSecond, medgePixelsPerSecond, allocationsPerPass);
+        fflush(stdout);
+        if (json) {
+            fprintf(json, "%s\n{\"name\":\"%s\",\"passes\":%d,\"seconds\":%.9g,\"mpixelsPerSecond\":%.9g,\"medgePixelsPerSecond\":%.9g,\"allocationsPerPass\":%.9g}", first ? "" : ",", benchmarkCase.name, result.passes, result.seconds, mpixelsPerSecond, medgePixelsPerSecond, allocationsPerPass);
+            first = false;
+        }
+    }
+    if (json) {
+        fputs("\n]}\n", json);
+        fclose(json);
+    }
+    return 0;
+}
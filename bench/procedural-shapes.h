@@ -0,0 +1,100 @@
+#pragma once
+
+/*
+ * Building blocks for the procedurally generated shapes used by the benchmarks.
+ * Filled contours are oriented clockwise and holes counter-clockwise, as in TrueType fonts.
+ */
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include "msdfgen.h"
+
+#define CUBIC_ARC_FACTOR .5522847498
+
+namespace msdfgen {
+
+/// Deterministic pseudo-random sequence so that the procedural corpus is identical across runs and platforms
+class Random {
+    unsigned long long state;
+public:
+    explicit Random(unsigned long long seed) : state(seed) { }
+    /// Returns a uniformly distributed value in [0, 1)
+    double operator()() {
+        state = 6364136223846793005ull*state+1442695040888963407ull;
+        return (double) (state>>11)/(double) (1ull<<53);
+    }
+    /// Returns a uniformly distributed integer in [min, max]
+    int operator()(int min, int max) {
+        return min+(int) ((*this)()*(max-min+1));
+    }
+};
+
+/// Adds a polygon given by points in counter-clockwise order
+inline void addPolygon(Shape &shape, const Point2 *points, int count, bool hole = false) {
+    Contour &contour = shape.addContour();
+    if (hole) {
+        for (int i = 0; i < count; ++i)
+            contour.addEdge(EdgeHolder(points[i], points[(i+1)%count]));
+    } else {
+        for (int i = count; i > 0; --i)
+            contour.addEdge(EdgeHolder(points[i%count], points[i-1]));
+    }
+}
+
+inline void addRectangle(Shape &shape, double l, double b, double r, double t, bool hole = false) {
+    Point2 corners[4] = { Point2(l, b), Point2(r, b), Point2(r, t), Point2(l, t) };
+    addPolygon(shape, corners, 4, hole);
+}
+
+inline void addCircle(Shape &shape, Point2 center, double radius, bool hole = false) {
+    Contour &contour = shape.addContour();
+    double k = (hole ? 1 : -1)*CUBIC_ARC_FACTOR*radius;
+    Vector2 axis[4] = { Vector2(radius, 0), Vector2(0, radius), Vector2(-radius, 0), Vector2(0, -radius) };
+    if (!hole) {
+        Vector2 tmp = axis[1];
+        axis[1] = axis[3];
+        axis[3] = tmp;
+    }
+    for (int i = 0; i < 4; ++i) {
+        Vector2 a = axis[i], b = axis[(i+1)%4];
+        contour.addEdge(EdgeHolder(center+a, center+a+k*a.getOrthonormal(), center+b-k*b.getOrthonormal(), center+b));
+    }
+}
+
+inline void addStar(Shape &shape, Point2 center, double radius, int points, double innerRatio) {
+    std::vector<Point2> vertices(2*points);
+    for (int i = 0; i < 2*points; ++i) {
+        double angle = M_PI*i/points, r = i&1 ? innerRatio*radius : radius;
+        vertices[i] = center+Vector2(r*cos(angle), r*sin(angle));
+    }
+    addPolygon(shape, vertices.data(), (int) vertices.size());
+}
+
+/// Adds an irregular closed curve consisting of a mix of linear, quadratic, and cubic segments
+inline void addBlob(Shape &shape, Point2 center, double radius, int segments, Random &random, bool hole = false) {
+    Contour &contour = shape.addContour();
+    std::vector<Point2> vertices(2*segments);
+    for (int i = 0; i < 2*segments; ++i) {
+        double angle = M_PI*i/segments, r = (.6+.4*random())*radius;
+        vertices[i] = center+Vector2(r*cos(angle), r*sin(angle));
+    }
+    if (!hole) {
+        for (int i = 0, j = 2*segments-1; i < j; ++i, --j) {
+            Point2 tmp = vertices[i];
+            vertices[i] = vertices[j];
+            vertices[j] = tmp;
+        }
+    }
+    for (int i = 0; i < segments; ++i) {
+        Point2 p0 = vertices[2*i], p1 = vertices[2*i+1], p2 = vertices[(2*i+2)%vertices.size()];
+        if (i%3 == 2)
+            contour.addEdge(EdgeHolder(p0, p2));
+        else if (i%3 == 1)
+            contour.addEdge(EdgeHolder(p0, p1, p2));
+        else
+            contour.addEdge(EdgeHolder(p0, p0+.5*(p1-p0)+.25*(p2-p0), p1+.5*(p2-p1), p2));
+    }
+}
+
+}
@@ -143,23 +143,36 @@ pub fn build(b: *std.Build) !void {
         .root = b.path("msdf-atlas-gen"),
         .files = &.{
             "artery-font-export.cpp",
+            "AtlasLayoutState.cpp",
             "bitmap-blit.cpp",
+            "block-compression.cpp",
             "charset-parser.cpp",
             "Charset.cpp",
             "csv-export.cpp",
+            "FileMapping.cpp",
+            "FontFile.cpp",
             "FontGeometry.cpp",
             "glyph-generators.cpp",
             "GlyphGeometry.cpp",
             "GridAtlasPacker.cpp",
             "image-encode.cpp",
+            "image-load.cpp",
             "json-export.cpp",
+            "kerning-tables.cpp",
             "main.cpp",
+            "mipmap-generation.cpp",
             "msdf-atlas-gen-c.cpp",
             "Padding.cpp",
+            "PngWriter.cpp",
             "RectanglePacker.cpp",
             "shadron-preview-generator.cpp",
+            "ShapeCache.cpp",
             "size-selectors.cpp",
+            "SkylinePacker.cpp",
+            "texture-export.cpp",
+            "ThreadPool.cpp",
             "TightAtlasPacker.cpp",
+            "Tracer.cpp",
             "utf8.cpp",
             "Workload.cpp",
         },
@@ -175,6 +188,66 @@ pub fn build(b: *std.Build) !void {
     b.installArtifact(libgen);
     b.installArtifact(libatlasgen);
 
+    // benchmark of the core generators (provides its own allocation hooks)
+    const bench = b.addExecutable(.{
+        .name = "msdfgen-bench",
+        .root_module = b.createModule(.{
+            .target = target,
+            .optimize = optimize,
+            .link_libc = true,
+        }),
+    });
+    if (target.result.abi != .msvc) {
+        bench.root_module.link_libcpp = true;
+    }
+    bench.root_module.addCMacro("MSDFGEN_USE_CPP11", "1");
+    bench.addIncludePath(b.path("."));
+    bench.addCSourceFile(.{
+        .file = b.path("bench/msdfgen-bench.cpp"),
+        .flags = &.{
+            "-std=c++17",
+            "-fno-sanitize=undefined",
+        },
+    });
+    bench.linkLibrary(libgen);
+    const run_bench = b.addRunArtifact(bench);
+    if (b.args) |args| {
+        run_bench.addArgs(args);
+    }
+    const bench_step = b.step("bench", "Run the core generator benchmark");
+    bench_step.dependOn(&run_bench.step);
+
+    // end-to-end atlas generation benchmark on synthetic glyph corpora
+    const atlas_bench = b.addExecutable(.{
+        .name = "msdf-atlas-bench",
+        .root_module = b.createModule(.{
+            .target = target,
+            .optimize = optimize,
+            .link_libc = true,
+        }),
+    });
+    if (target.result.abi != .msvc) {
+        atlas_bench.root_module.link_libcpp = true;
+    }
+    atlas_bench.root_module.addCMacro("MSDFGEN_USE_CPP11", "1");
+    atlas_bench.root_module.addCMacro("MSDF_ATLAS_NO_ARTERY_FONT", "1");
+    atlas_bench.addIncludePath(b.path("."));
+    atlas_bench.addCSourceFile(.{
+        .file = b.path("bench/atlas-bench.cpp"),
+        .flags = &.{
+            "-std=c++17",
+            "-fno-sanitize=undefined",
+        },
+    });
+    atlas_bench.linkLibrary(libatlasgen);
+    atlas_bench.linkLibrary(libgen);
+    const run_atlas_bench = b.addRunArtifact(atlas_bench);
+    if (b.args) |args| {
+        run_atlas_bench.addArgs(args);
+    }
+    const atlas_bench_step = b.step("bench-atlas", "Run the end-to-end atlas generation benchmark");
+    atlas_bench_step.dependOn(&run_atlas_bench.step);
+
     // includes both atlasgen and msdfgen
     const msdfgen = b.addModule("msdfgen", .{
         .root_source_file = b.path("src/msdfgen.zig"),
@@ -38,6 +38,12 @@ public:
 #endif
     operator BitmapRef<T, N>();
     operator BitmapConstRef<T, N>() const;
+    operator BitmapSection<T, N>();
+    operator BitmapConstSection<T, N>() const;
+    /// Returns a reference to a rectangular section of the bitmap specified by bounds (excluding xMax, yMax).
+    BitmapSection<T, N> getSection(int xMin, int yMin, int xMax, int yMax);
+    /// Returns a constant reference to a rectangular section of the bitmap specified by bounds (excluding xMax, yMax).
+    BitmapConstSection<T, N> getConstSection(int xMin, int yMin, int xMax, int yMax) const;
 
 private:
     T *pixels;
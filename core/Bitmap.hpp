@@ -130,4 +130,24 @@ Bitmap<T, N>::operator BitmapConstRef<T, N>() const {
     return BitmapConstRef<T, N>(pixels, w, h);
 }
 
+template <typename T, int N>
+Bitmap<T, N>::operator BitmapSection<T, N>() {
+    return BitmapSection<T, N>(pixels, w, h);
+}
+
+template <typename T, int N>
+Bitmap<T, N>::operator BitmapConstSection<T, N>() const {
+    return BitmapConstSection<T, N>(pixels, w, h);
+}
+
+template <typename T, int N>
+BitmapSection<T, N> Bitmap<T, N>::getSection(int xMin, int yMin, int xMax, int yMax) {
+    return BitmapSection<T, N>(pixels+N*(w*yMin+xMin), xMax-xMin, yMax-yMin, N*w);
+}
+
+template <typename T, int N>
+BitmapConstSection<T, N> Bitmap<T, N>::getConstSection(int xMin, int yMin, int xMax, int yMax) const {
+    return BitmapConstSection<T, N>(pixels+N*(w*yMin+xMin), xMax-xMin, yMax-yMin, N*w);
+}
+
 }
@@ -1,10 +1,14 @@
-
 #pragma once
 
 #include "base.h"
 
 namespace msdfgen {
 
+template <typename T, int N>
+struct BitmapSection;
+template <typename T, int N>
+struct BitmapConstSection;
+
 /// Reference to a 2D image bitmap or a buffer acting as one. Pixel storage not owned or managed by the object.
 template <typename T, int N = 1>
 struct BitmapRef {
@@ -19,6 +23,11 @@ struct BitmapRef {
         return pixels+N*(width*y+x);
     }
 
+    /// Returns a reference to a rectangular section of the bitmap specified by bounds (excluding xMax, yMax).
+    inline BitmapSection<T, N> getSection(int xMin, int yMin, int xMax, int yMax) const {
+        return BitmapSection<T, N>(pixels+N*(width*yMin+xMin), xMax-xMin, yMax-yMin, N*width);
+    }
+
 };
 
 /// Constant reference to a 2D image bitmap or a buffer acting as one. Pixel storage not owned or managed by the object.
@@ -36,6 +45,63 @@ struct BitmapConstRef {
         return pixels+N*(width*y+x);
     }
 
+    /// Returns a reference to a rectangular section of the bitmap specified by bounds (excluding xMax, yMax).
+    inline BitmapConstSection<T, N> getSection(int xMin, int yMin, int xMax, int yMax) const {
+        return BitmapConstSection<T, N>(pixels+N*(width*yMin+xMin), xMax-xMin, yMax-yMin, N*width);
+    }
+
+};
+
+/// Reference to a 2D image bitmap with non-contiguous rows of pixels, such as a rectangular section of a larger bitmap. Pixel storage not owned or managed by the object.
+template <typename T, int N = 1>
+struct BitmapSection {
+
+    T *pixels;
+    int width, height;
+    /// Difference between the addresses of the first value of two consecutive rows in units of T (not pixels).
+    int rowStride;
+
+    inline BitmapSection() : pixels(NULL), width(0), height(0), rowStride(0) { }
+    inline BitmapSection(T *pixels, int width, int height) : pixels(pixels), width(width), height(height), rowStride(N*width) { }
+    inline BitmapSection(T *pixels, int width, int height, int rowStride) : pixels(pixels), width(width), height(height), rowStride(rowStride) { }
+    inline BitmapSection(const BitmapRef<T, N> &orig) : pixels(orig.pixels), width(orig.width), height(orig.height), rowStride(N*orig.width) { }
+
+    inline T *operator()(int x, int y) const {
+        return pixels+rowStride*y+N*x;
+    }
+
+    /// Returns a reference to a rectangular section of the bitmap specified by bounds (excluding xMax, yMax).
+    inline BitmapSection<T, N> getSection(int xMin, int yMin, int xMax, int yMax) const {
+        return BitmapSection<T, N>(pixels+rowStride*yMin+N*xMin, xMax-xMin, yMax-yMin, rowStride);
+    }
+
+};
+
+/// Constant reference to a 2D image bitmap with non-contiguous rows of pixels, such as a rectangular section of a larger bitmap. Pixel storage not owned or managed by the object.
+template <typename T, int N = 1>
+struct BitmapConstSection {
+
+    const T *pixels;
+    int width, height;
+    /// Difference between the addresses of the first value of two consecutive rows in units of T (not pixels).
+    int rowStride;
+
+    inline BitmapConstSection() : pixels(NULL), width(0), height(0), rowStride(0) { }
+    inline BitmapConstSection(const T *pixels, int width, int height) : pixels(pixels), width(width), height(height), rowStride(N*width) { }
+    inline BitmapConstSection(const T *pixels, int width, int height, int rowStride) : pixels(pixels), width(width), height(height), rowStride(rowStride) { }
+    inline BitmapConstSection(const BitmapRef<T, N> &orig) : pixels(orig.pixels), width(orig.width), height(orig.height), rowStride(N*orig.width) { }
+    inline BitmapConstSection(const BitmapConstRef<T, N> &orig) : pixels(orig.pixels), width(orig.width), height(orig.height), rowStride(N*orig.width) { }
+    inline BitmapConstSection(const BitmapSection<T, N> &orig) : pixels(orig.pixels), width(orig.width), height(orig.height), rowStride(orig.rowStride) { }
+
+    inline const T *operator()(int x, int y) const {
+        return pixels+rowStride*y+N*x;
+    }
+
+    /// Returns a reference to a rectangular section of the bitmap specified by bounds (excluding xMax, yMax).
+    inline BitmapConstSection<T, N> getSection(int xMin, int yMin, int xMax, int yMax) const {
+        return BitmapConstSection<T, N>(pixels+rowStride*yMin+N*xMin, xMax-xMin, yMax-yMin, rowStride);
+    }
+
 };
 
 }
@@ -5,6 +5,13 @@
 
 using namespace msdfgen;
 
+/// Checks that a row pitch in bytes is a whole number of floats and spans at least a row of w pixels with n channels
+static bool isValidPitch(int pitch, int w, int n)
+{
+  long long absPitch = pitch < 0 ? -(long long) pitch : (long long) pitch;
+  return pitch%(int) sizeof(float) == 0 && absPitch >= (long long) w*n*(long long) sizeof(float);
+}
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -98,6 +105,42 @@ extern "C"
     generateMTSDF(bitmap, *shape, range, Vector2(sx, sy), Vector2(dx, dy));
   }
 
+  MSDFGEN_PUBLIC void msGenerateSDFPitched(float *data, int w, int h, int pitch, msShape *cShape, double range, double sx, double sy, double dx, double dy)
+  {
+    if (!isValidPitch(pitch, w, 1))
+      return;
+    Shape *shape = reinterpret_cast<Shape *>(cShape);
+    const BitmapSection<float, 1> bitmap(data, w, h, pitch/(int) sizeof(float));
+    generateSDF(bitmap, *shape, range, Vector2(sx, sy), Vector2(dx, dy));
+  }
+
+  MSDFGEN_PUBLIC void msGeneratePseudoSDFPitched(float *data, int w, int h, int pitch, msShape *cShape, double range, double sx, double sy, double dx, double dy)
+  {
+    if (!isValidPitch(pitch, w, 1))
+      return;
+    Shape *shape = reinterpret_cast<Shape *>(cShape);
+    const BitmapSection<float, 1> bitmap(data, w, h, pitch/(int) sizeof(float));
+    generatePseudoSDF(bitmap, *shape, range, Vector2(sx, sy), Vector2(dx, dy));
+  }
+
+  MSDFGEN_PUBLIC void msGenerateMSDFPitched(float *data, int w, int h, int pitch, msShape *cShape, double range, double sx, double sy, double dx, double dy)
+  {
+    if (!isValidPitch(pitch, w, 3))
+      return;
+    Shape *shape = reinterpret_cast<Shape *>(cShape);
+    const BitmapSection<float, 3> bitmap(data, w, h, pitch/(int) sizeof(float));
+    generateMSDF(bitmap, *shape, range, Vector2(sx, sy), Vector2(dx, dy));
+  }
+
+  MSDFGEN_PUBLIC void msGenerateMTSDFPitched(float *data, int w, int h, int pitch, msShape *cShape, double range, double sx, double sy, double dx, double dy)
+  {
+    if (!isValidPitch(pitch, w, 4))
+      return;
+    Shape *shape = reinterpret_cast<Shape *>(cShape);
+    const BitmapSection<float, 4> bitmap(data, w, h, pitch/(int) sizeof(float));
+    generateMTSDF(bitmap, *shape, range, Vector2(sx, sy), Vector2(dx, dy));
+  }
+
 #ifdef __cplusplus
 }
 #endif
@@ -12,7 +12,7 @@ static float distVal(float dist, DistanceMapping mapping) {
     return (float) clamp(mapping(dist)+.5);
 }
 
-void renderSDF(const BitmapRef<float, 1> &output, const BitmapConstRef<float, 1> &sdf, Range sdfPxRange, float sdThreshold) {
+void renderSDF(const BitmapSection<float, 1> &output, const BitmapConstSection<float, 1> &sdf, Range sdfPxRange, float sdThreshold) {
     Vector2 scale((double) sdf.width/output.width, (double) sdf.height/output.height);
     if (sdfPxRange.lower == sdfPxRange.upper) {
         for (int y = 0; y < output.height; ++y) {
@@ -37,7 +37,7 @@ void renderSDF(const BitmapRef<float, 1> &output, const BitmapConstRef<float, 1>
 
 }
 
-void renderSDF(const BitmapRef<float, 3> &output, const BitmapConstRef<float, 1> &sdf, Range sdfPxRange, float sdThreshold) {
+void renderSDF(const BitmapSection<float, 3> &output, const BitmapConstSection<float, 1> &sdf, Range sdfPxRange, float sdThreshold) {
     Vector2 scale((double) sdf.width/output.width, (double) sdf.height/output.height);
     if (sdfPxRange.lower == sdfPxRange.upper) {
         for (int y = 0; y < output.height; ++y) {
@@ -67,7 +67,7 @@ void renderSDF(const BitmapRef<float, 3> &output, const BitmapConstRef<float, 1>
     }
 }
 
-void renderSDF(const BitmapRef<float, 1> &output, const BitmapConstRef<float, 3> &sdf, Range sdfPxRange, float sdThreshold) {
+void renderSDF(const BitmapSection<float, 1> &output, const BitmapConstSection<float, 3> &sdf, Range sdfPxRange, float sdThreshold) {
     Vector2 scale((double) sdf.width/output.width, (double) sdf.height/output.height);
     if (sdfPxRange.lower == sdfPxRange.upper) {
         for (int y = 0; y < output.height; ++y) {
@@ -91,7 +91,7 @@ void renderSDF(const BitmapRef<float, 1> &output, const BitmapConstRef<float, 3>
     }
 }
 
-void renderSDF(const BitmapRef<float, 3> &output, const BitmapConstRef<float, 3> &sdf, Range sdfPxRange, float sdThreshold) {
+void renderSDF(const BitmapSection<float, 3> &output, const BitmapConstSection<float, 3> &sdf, Range sdfPxRange, float sdThreshold) {
     Vector2 scale((double) sdf.width/output.width, (double) sdf.height/output.height);
     if (sdfPxRange.lower == sdfPxRange.upper) {
         for (int y = 0; y < output.height; ++y) {
@@ -119,7 +119,7 @@ void renderSDF(const BitmapRef<float, 3> &output, const BitmapConstRef<float, 3>
     }
 }
 
-void renderSDF(const BitmapRef<float, 1> &output, const BitmapConstRef<float, 4> &sdf, Range sdfPxRange, float sdThreshold) {
+void renderSDF(const BitmapSection<float, 1> &output, const BitmapConstSection<float, 4> &sdf, Range sdfPxRange, float sdThreshold) {
     Vector2 scale((double) sdf.width/output.width, (double) sdf.height/output.height);
     if (sdfPxRange.lower == sdfPxRange.upper) {
         for (int y = 0; y < output.height; ++y) {
@@ -143,7 +143,7 @@ void renderSDF(const BitmapRef<float, 1> &output, const BitmapConstRef<float, 4>
     }
 }
 
-void renderSDF(const BitmapRef<float, 4> &output, const BitmapConstRef<float, 4> &sdf, Range sdfPxRange, float sdThreshold) {
+void renderSDF(const BitmapSection<float, 4> &output, const BitmapConstSection<float, 4> &sdf, Range sdfPxRange, float sdThreshold) {
     Vector2 scale((double) sdf.width/output.width, (double) sdf.height/output.height);
     if (sdfPxRange.lower == sdfPxRange.upper) {
         for (int y = 0; y < output.height; ++y) {
@@ -173,22 +173,28 @@ void renderSDF(const BitmapRef<float, 4> &output, const BitmapConstRef<float, 4>
     }
 }
 
-void simulate8bit(const BitmapRef<float, 1> &bitmap) {
-    const float *end = bitmap.pixels+1*bitmap.width*bitmap.height;
-    for (float *p = bitmap.pixels; p < end; ++p)
-        *p = pixelByteToFloat(pixelFloatToByte(*p));
+void simulate8bit(const BitmapSection<float, 1> &bitmap) {
+    for (int y = 0; y < bitmap.height; ++y) {
+        float *p = bitmap(0, y);
+        for (const float *end = p+1*bitmap.width; p < end; ++p)
+            *p = pixelByteToFloat(pixelFloatToByte(*p));
+    }
 }
 
-void simulate8bit(const BitmapRef<float, 3> &bitmap) {
-    const float *end = bitmap.pixels+3*bitmap.width*bitmap.height;
-    for (float *p = bitmap.pixels; p < end; ++p)
-        *p = pixelByteToFloat(pixelFloatToByte(*p));
+void simulate8bit(const BitmapSection<float, 3> &bitmap) {
+    for (int y = 0; y < bitmap.height; ++y) {
+        float *p = bitmap(0, y);
+        for (const float *end = p+3*bitmap.width; p < end; ++p)
+            *p = pixelByteToFloat(pixelFloatToByte(*p));
+    }
 }
 
-void simulate8bit(const BitmapRef<float, 4> &bitmap) {
-    const float *end = bitmap.pixels+4*bitmap.width*bitmap.height;
-    for (float *p = bitmap.pixels; p < end; ++p)
-        *p = pixelByteToFloat(pixelFloatToByte(*p));
+void simulate8bit(const BitmapSection<float, 4> &bitmap) {
+    for (int y = 0; y < bitmap.height; ++y) {
+        float *p = bitmap(0, y);
+        for (const float *end = p+4*bitmap.width; p < end; ++p)
+            *p = pixelByteToFloat(pixelFloatToByte(*p));
+    }
 }
 
 }
@@ -64,7 +64,7 @@ static bool writeBmpHeader(FILE *file, int width, int height, int &paddedWidth)
     return true;
 }
 
-bool saveBmp(const BitmapConstRef<byte, 1> &bitmap, const char *filename) {
+bool saveBmp(const BitmapConstSection<byte, 1> &bitmap, const char *filename) {
     FILE *file = fopen(filename, "wb");
     if (!file)
         return false;
@@ -87,7 +87,7 @@ bool saveBmp(const BitmapConstRef<byte, 1> &bitmap, const char *filename) {
     return !fclose(file);
 }
 
-bool saveBmp(const BitmapConstRef<byte, 3> &bitmap, const char *filename) {
+bool saveBmp(const BitmapConstSection<byte, 3> &bitmap, const char *filename) {
     FILE *file = fopen(filename, "wb");
     if (!file)
         return false;
@@ -112,12 +112,12 @@ bool saveBmp(const BitmapConstRef<byte, 3> &bitmap, const char *filename) {
     return !fclose(file);
 }
 
-bool saveBmp(const BitmapConstRef<byte, 4> &bitmap, const char *filename) {
+bool saveBmp(const BitmapConstSection<byte, 4> &bitmap, const char *filename) {
     // RGBA not supported by the BMP format
     return false;
 }
 
-bool saveBmp(const BitmapConstRef<float, 1> &bitmap, const char *filename) {
+bool saveBmp(const BitmapConstSection<float, 1> &bitmap, const char *filename) {
     FILE *file = fopen(filename, "wb");
     if (!file)
         return false;
@@ -140,7 +140,7 @@ bool saveBmp(const BitmapConstRef<float, 1> &bitmap, const char *filename) {
     return !fclose(file);
 }
 
-bool saveBmp(const BitmapConstRef<float, 3> &bitmap, const char *filename) {
+bool saveBmp(const BitmapConstSection<float, 3> &bitmap, const char *filename) {
     FILE *file = fopen(filename, "wb");
     if (!file)
         return false;
@@ -165,7 +165,7 @@ bool saveBmp(const BitmapConstRef<float, 3> &bitmap, const char *filename) {
     return !fclose(file);
 }
 
-bool saveBmp(const BitmapConstRef<float, 4> &bitmap, const char *filename) {
+bool saveBmp(const BitmapConstSection<float, 4> &bitmap, const char *filename) {
     // RGBA not supported by the BMP format
     return false;
 }
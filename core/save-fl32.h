@@ -7,6 +7,11 @@ namespace msdfgen {
 
 /// Saves the bitmap as an uncompressed floating-point FL32 file, which can be decoded trivially.
 template <int N>
-bool saveFl32(const BitmapConstRef<float, N> &bitmap, const char *filename);
+bool saveFl32(const BitmapConstSection<float, N> &bitmap, const char *filename);
+
+template <int N>
+inline bool saveFl32(const BitmapConstRef<float, N> &bitmap, const char *filename) {
+    return saveFl32(BitmapConstSection<float, N>(bitmap), filename);
+}
 
 }
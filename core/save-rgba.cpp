@@ -40,7 +40,7 @@ public:
 
 };
 
-bool saveRgba(const BitmapConstRef<byte, 1> &bitmap, const char *filename) {
+bool saveRgba(const BitmapConstSection<byte, 1> &bitmap, const char *filename) {
     RgbaFileOutput output(filename, bitmap.width, bitmap.height);
     if (output) {
         byte rgba[4] = { byte(0), byte(0), byte(0), byte(0xff) };
@@ -55,7 +55,7 @@ bool saveRgba(const BitmapConstRef<byte, 1> &bitmap, const char *filename) {
     return false;
 }
 
-bool saveRgba(const BitmapConstRef<byte, 3> &bitmap, const char *filename) {
+bool saveRgba(const BitmapConstSection<byte, 3> &bitmap, const char *filename) {
     RgbaFileOutput output(filename, bitmap.width, bitmap.height);
     if (output) {
         byte rgba[4] = { byte(0), byte(0), byte(0), byte(0xff) };
@@ -70,7 +70,7 @@ bool saveRgba(const BitmapConstRef<byte, 3> &bitmap, const char *filename) {
     return false;
 }
 
-bool saveRgba(const BitmapConstRef<byte, 4> &bitmap, const char *filename) {
+bool saveRgba(const BitmapConstSection<byte, 4> &bitmap, const char *filename) {
     RgbaFileOutput output(filename, bitmap.width, bitmap.height);
     if (output) {
         for (int y = bitmap.height; y--;)
@@ -80,7 +80,7 @@ bool saveRgba(const BitmapConstRef<byte, 4> &bitmap, const char *filename) {
     return false;
 }
 
-bool saveRgba(const BitmapConstRef<float, 1> &bitmap, const char *filename) {
+bool saveRgba(const BitmapConstSection<float, 1> &bitmap, const char *filename) {
     RgbaFileOutput output(filename, bitmap.width, bitmap.height);
     if (output) {
         byte rgba[4] = { byte(0), byte(0), byte(0), byte(0xff) };
@@ -95,7 +95,7 @@ bool saveRgba(const BitmapConstRef<float, 1> &bitmap, const char *filename) {
     return false;
 }
 
-bool saveRgba(const BitmapConstRef<float, 3> &bitmap, const char *filename) {
+bool saveRgba(const BitmapConstSection<float, 3> &bitmap, const char *filename) {
     RgbaFileOutput output(filename, bitmap.width, bitmap.height);
     if (output) {
         byte rgba[4] = { byte(0), byte(0), byte(0), byte(0xff) };
@@ -112,7 +112,7 @@ bool saveRgba(const BitmapConstRef<float, 3> &bitmap, const char *filename) {
     return false;
 }
 
-bool saveRgba(const BitmapConstRef<float, 4> &bitmap, const char *filename) {
+bool saveRgba(const BitmapConstSection<float, 4> &bitmap, const char *filename) {
     RgbaFileOutput output(filename, bitmap.width, bitmap.height);
     if (output) {
         byte rgba[4];
@@ -171,7 +171,7 @@ static bool writeTiffHeader(FILE *file, int width, int height, int channels) {
 }
 
 template <int N>
-bool saveTiffFloat(const BitmapConstRef<float, N> &bitmap, const char *filename) {
+bool saveTiffFloat(const BitmapConstSection<float, N> &bitmap, const char *filename) {
     FILE *file = fopen(filename, "wb");
     if (!file)
         return false;
@@ -181,13 +181,13 @@ bool saveTiffFloat(const BitmapConstRef<float, N> &bitmap, const char *filename)
     return !fclose(file);
 }
 
-bool saveTiff(const BitmapConstRef<float, 1> &bitmap, const char *filename) {
+bool saveTiff(const BitmapConstSection<float, 1> &bitmap, const char *filename) {
     return saveTiffFloat(bitmap, filename);
 }
-bool saveTiff(const BitmapConstRef<float, 3> &bitmap, const char *filename) {
+bool saveTiff(const BitmapConstSection<float, 3> &bitmap, const char *filename) {
     return saveTiffFloat(bitmap, filename);
 }
-bool saveTiff(const BitmapConstRef<float, 4> &bitmap, const char *filename) {
+bool saveTiff(const BitmapConstSection<float, 4> &bitmap, const char *filename) {
     return saveTiffFloat(bitmap, filename);
 }
 
@@ -6,6 +6,7 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_OUTLINE_H
+#include FT_TRUETYPE_TABLES_H
 #ifndef MSDFGEN_DISABLE_VARIABLE_FONTS
 #include FT_MULTIPLE_MASTERS_H
 #endif
@@ -42,6 +43,7 @@ class FontHandle {
     friend bool loadGlyph(Shape &output, FontHandle *font, unicode_t unicode, FontCoordinateScaling coordinateScaling, double *outAdvance);
     friend bool getKerning(double &output, FontHandle *font, GlyphIndex glyphIndex0, GlyphIndex glyphIndex1, FontCoordinateScaling coordinateScaling);
     friend bool getKerning(double &output, FontHandle *font, unicode_t unicode0, unicode_t unicode1, FontCoordinateScaling coordinateScaling);
+    friend bool getFontTable(std::vector<byte, Allocator<byte> > &output, FontHandle *font, unsigned tag);
 #ifndef MSDFGEN_DISABLE_VARIABLE_FONTS
     friend bool setFontVariationAxis(FreetypeHandle *library, FontHandle *font, const char *name, double coordinate);
     friend bool listFontVariationAxes(std::vector<FontVariationAxis, Allocator<FontVariationAxis>> &axes, FreetypeHandle *library, FontHandle *font);
@@ -264,6 +266,19 @@ bool getKerning(double &output, FontHandle *font, unicode_t unicode0, unicode_t
     return getKerning(output, font, GlyphIndex(FT_Get_Char_Index(font->face, unicode0)), GlyphIndex(FT_Get_Char_Index(font->face, unicode1)), coordinateScaling);
 }
 
+bool getFontTable(std::vector<byte, Allocator<byte> > &output, FontHandle *font, unsigned tag) {
+    output.clear();
+    FT_ULong length = 0;
+    if (!FT_IS_SFNT(font->face) || FT_Load_Sfnt_Table(font->face, (FT_ULong) tag, 0, NULL, &length))
+        return false;
+    output.resize((size_t) length);
+    if (length && FT_Load_Sfnt_Table(font->face, (FT_ULong) tag, 0, (FT_Byte *) output.data(), &length)) {
+        output.clear();
+        return false;
+    }
+    return true;
+}
+
 #ifndef MSDFGEN_DISABLE_VARIABLE_FONTS
 
 bool setFontVariationAxis(FreetypeHandle *library, FontHandle *font, const char *name, double coordinate) {
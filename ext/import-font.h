@@ -92,6 +92,8 @@ bool loadGlyph(Shape &output, FontHandle *font, unicode_t unicode, double *outAd
 /// Outputs the kerning distance adjustment between two specific glyphs.
 bool getKerning(double &output, FontHandle *font, GlyphIndex glyphIndex0, GlyphIndex glyphIndex1, FontCoordinateScaling coordinateScaling = FONT_SCALING_LEGACY);
 bool getKerning(double &output, FontHandle *font, unicode_t unicode0, unicode_t unicode1, FontCoordinateScaling coordinateScaling = FONT_SCALING_LEGACY);
+/// Outputs the raw contents of an SFNT table of the font, identified by its tag (e.g. 0x47504f53 for 'GPOS'). Returns false if the table is not present.
+bool getFontTable(std::vector<byte, Allocator<byte> > &output, FontHandle *font, unsigned tag);
 
 #ifndef MSDFGEN_DISABLE_VARIABLE_FONTS
 /// Sets a single variation axis of a variable font.
@@ -7,13 +7,13 @@
 
 namespace msdfgen {
 
-/// Saves the bitmap as a PNG file.
-bool savePng(const BitmapConstRef<byte, 1> &bitmap, const char *filename);
-bool savePng(const BitmapConstRef<byte, 3> &bitmap, const char *filename);
-bool savePng(const BitmapConstRef<byte, 4> &bitmap, const char *filename);
-bool savePng(const BitmapConstRef<float, 1> &bitmap, const char *filename);
-bool savePng(const BitmapConstRef<float, 3> &bitmap, const char *filename);
-bool savePng(const BitmapConstRef<float, 4> &bitmap, const char *filename);
+/// Saves the bitmap as a PNG file. With libpng, the maximum compression level is always used.
+bool savePng(const BitmapConstSection<byte, 1> &bitmap, const char *filename);
+bool savePng(const BitmapConstSection<byte, 3> &bitmap, const char *filename);
+bool savePng(const BitmapConstSection<byte, 4> &bitmap, const char *filename);
+bool savePng(const BitmapConstSection<float, 1> &bitmap, const char *filename);
+bool savePng(const BitmapConstSection<float, 3> &bitmap, const char *filename);
+bool savePng(const BitmapConstSection<float, 4> &bitmap, const char *filename);
 
 }
 
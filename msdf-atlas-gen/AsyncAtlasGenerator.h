@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "ImmediateAtlasGenerator.h"
+
+namespace msdf_atlas {
+
+/**
+ * An implementation of AtlasGenerator that queues glyphs and returns immediately,
+ * while the glyphs are generated by a background thread using ImmediateAtlasGenerator
+ * (and therefore the ThreadPool if setThreadCount is greater than 1).
+ * Glyphs queued while a previous batch is being generated are generated together as the next batch,
+ * and identical glyphs within a batch are only generated once. A glyph identical to one of the batch being generated
+ * is copied from its box once the batch is finished (if the AtlasStorage can be read as T or byte) instead of being generated again.
+ * Finished glyphs can be polled (fetchFinished) or reported by a callback (setCallback).
+ */
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+class AsyncAtlasGenerator {
+
+public:
+    AsyncAtlasGenerator();
+    AsyncAtlasGenerator(int width, int height);
+    template <typename... ARGS>
+    AsyncAtlasGenerator(int width, int height, ARGS... storageArgs);
+    AsyncAtlasGenerator(const AsyncAtlasGenerator &) = delete;
+    /// Waits for all queued glyphs to be generated
+    ~AsyncAtlasGenerator();
+    AsyncAtlasGenerator &operator=(const AsyncAtlasGenerator &) = delete;
+    /// Queues the glyphs to be generated in the background
+    void generate(const GlyphGeometry *glyphs, int count);
+    /// Removes queued glyphs whose boxes overlap the rectangle, e.g. because it is about to be reused for other glyphs, and returns their number
+    /// Removed glyphs are not reported as finished. Glyphs of the batch being generated are not affected, but they are finished before any glyphs queued afterwards
+    int cancel(const Rectangle &rect, int page = 0);
+    /// Waits for all queued glyphs to be generated, then resizes the atlas and rearranges the generated pixels according to the remapping array
+    void rearrange(int width, int height, const Remap *remapping, int count);
+    /// Resizes the atlas and keeps the generated pixels in place
+    void resize(int width, int height);
+    /// Adds a new empty page of the given dimensions to the atlas and returns its index. Only available if AtlasStorage can be constructed from the arguments
+    template <typename... ARGS>
+    typename std::enable_if<std::is_constructible<AtlasStorage, int, int, ARGS...>::value, int>::type addPage(int width, int height, ARGS... storageArgs);
+    /// Sets attributes for the generator function
+    void setAttributes(const GeneratorAttributes &attributes);
+    /// Sets the number of threads to generate each batch with
+    void setThreadCount(int threadCount);
+    /// Enables splitting glyphs costlier than an even share of the work into bands of rows generated by different threads
+    void setBandSplitting(bool enabled);
+    /// Sets the ThreadPool to generate each batch on (nullptr for the default pool)
+    void setThreadPool(ThreadPool *threadPool);
+    /// Sets a function to be called from the background thread with the boxes of each batch of finished glyphs instead of collecting them for fetchFinished (nullptr to disable)
+    /// The glyphs are no longer counted as pending during the call. The function must not call wait, rearrange, or destroy the generator
+    void setCallback(const std::function<void(const GlyphBox *, int)> &callback);
+    /// Moves the boxes of glyphs finished since the previous call to the end of output and returns their number
+    int fetchFinished(std::vector<GlyphBox, Allocator<GlyphBox>> &output);
+    /// Returns the number of queued glyphs which haven't been finished yet
+    int getPendingCount() const;
+    /// Blocks until all queued glyphs have been generated and the callback (if any) has returned. Must not be called from the callback
+    void wait();
+    /// Allows access to the underlying AtlasStorage of a page. Only the pixels of finished glyphs may be read while others are pending
+    const AtlasStorage &atlasStorage(int page = 0) const;
+    /// Allows modifying the underlying AtlasStorage of a page while glyphs are pending only through its thread-safe members, e.g. fetchDirtyRectangles of BitmapAtlasStorage
+    AtlasStorage &mutableAtlasStorage(int page = 0);
+    /// Returns the number of atlas pages
+    int getPageCount() const;
+    /// Returns the layout of the queued glyphs (including unfinished ones) as a list of GlyphBoxes
+    const std::vector<GlyphBox, Allocator<GlyphBox>> &getLayout() const;
+    /// Clears the layout without affecting the atlas storage
+    void clearLayout();
+
+private:
+    /// A queued glyph whose pixels will be copied from the box of an identical glyph
+    struct Copy {
+        GlyphBox source;
+        GlyphGeometry glyph;
+    };
+
+    ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage> generator;
+    std::vector<GlyphBox, Allocator<GlyphBox>> layout;
+    std::vector<GlyphGeometry, Allocator<GlyphGeometry>> queue;
+    std::vector<GlyphGeometry, Allocator<GlyphGeometry>> batch;
+    std::vector<Copy, Allocator<Copy>> copies;
+    std::vector<Copy, Allocator<Copy>> batchCopies;
+    /// The last glyph of batch with each glyph index, and the previous one with the same index for each glyph of batch
+    std::map<int, int, std::less<int>, Allocator<std::pair<const int, int>>> batchLastByIndex;
+    std::vector<int, Allocator<int>> batchPrevByIndex;
+    std::vector<GlyphBox, Allocator<GlyphBox>> batchBoxes;
+    std::vector<GlyphBox, Allocator<GlyphBox>> finished;
+    std::function<void(const GlyphBox *, int)> callback;
+    std::thread thread;
+    mutable std::mutex mutex;
+    /// Held by the background thread while a batch is being generated
+    mutable std::mutex generatorMutex;
+    std::condition_variable queueCondition, idleCondition;
+    int pendingCount;
+    bool callbackRunning;
+    bool stopped;
+
+    void threadMain();
+    /// Copies the pixels of a glyph from its source box, returns false if the AtlasStorage cannot be read
+    bool copyGlyph(const Copy &copy);
+
+};
+
+}
+
+#include "AsyncAtlasGenerator.hpp"
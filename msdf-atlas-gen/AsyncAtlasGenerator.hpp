@@ -0,0 +1,296 @@
+
+#include "AsyncAtlasGenerator.h"
+
+#include <cassert>
+#include <utility>
+
+namespace msdf_atlas {
+
+/// Copies a rectangle of pixels between atlas storages (if they can be read as S)
+template <typename S, int N, class AtlasStorage>
+static auto copyAtlasStorageRect(const AtlasStorage &src, AtlasStorage &dst, int sx, int sy, int dx, int dy, int w, int h, int) -> decltype(src.get(sx, sy, std::declval<const msdfgen::BitmapRef<S, N> &>()), bool()) {
+    msdfgen::Bitmap<S, N> pixels(w, h);
+    src.get(sx, sy, pixels);
+    dst.put(dx, dy, msdfgen::BitmapConstRef<S, N>((const S *) pixels, w, h));
+    return true;
+}
+
+template <typename S, int N, class AtlasStorage>
+static bool copyAtlasStorageRect(const AtlasStorage &, AtlasStorage &, int, int, int, int, int, int, long) {
+    return false;
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::AsyncAtlasGenerator() : pendingCount(0), callbackRunning(false), stopped(false) { }
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::AsyncAtlasGenerator(int width, int height) : generator(width, height), pendingCount(0), callbackRunning(false), stopped(false) { }
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+template <typename... ARGS>
+AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::AsyncAtlasGenerator(int width, int height, ARGS... storageArgs) : generator(width, height, storageArgs...), pendingCount(0), callbackRunning(false), stopped(false) { }
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::~AsyncAtlasGenerator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    queueCondition.notify_all();
+    if (thread.joinable())
+        thread.join();
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::threadMain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        queueCondition.wait(lock, [this]() -> bool {
+            return stopped || !queue.empty() || !copies.empty();
+        });
+        if (queue.empty() && copies.empty())
+            break;
+        batch.swap(queue);
+        batchCopies.swap(copies);
+        lock.unlock();
+        batchBoxes.clear();
+        size_t uncopied = 0;
+        {
+            // The sources of the copies belong to the previous batch, which is finished but can't have been overwritten yet
+            std::lock_guard<std::mutex> generatorLock(generatorMutex);
+            for (size_t i = 0; i < batchCopies.size(); ++i) {
+                if (copyGlyph(batchCopies[i]))
+                    batchBoxes.push_back((GlyphBox) batchCopies[i].glyph);
+                else if (uncopied++ < i)
+                    batchCopies[uncopied-1] = (Copy &&) batchCopies[i];
+            }
+        }
+        lock.lock();
+        // Glyphs that couldn't be copied are generated instead, the batch is only modified under lock as generate reads it
+        for (size_t i = 0; i < uncopied; ++i)
+            batch.push_back((GlyphGeometry &&) batchCopies[i].glyph);
+        batchPrevByIndex.resize(batch.size());
+        for (int i = 0; i < (int) batch.size(); ++i) {
+            if (!batch[i].isWhitespace()) {
+                std::pair<typename decltype(batchLastByIndex)::iterator, bool> entry = batchLastByIndex.insert(std::make_pair(batch[i].getIndex(), i));
+                batchPrevByIndex[i] = entry.second ? -1 : entry.first->second;
+                entry.first->second = i;
+            }
+        }
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> generatorLock(generatorMutex);
+            generator.generate(batch.data(), (int) batch.size());
+            generator.clearLayout();
+        }
+        for (const GlyphGeometry &glyph : batch)
+            batchBoxes.push_back((GlyphBox) glyph);
+        lock.lock();
+        batch.clear();
+        batchCopies.clear();
+        batchLastByIndex.clear();
+        batchPrevByIndex.clear();
+        // The pending count is up to date for the callback, but wait also waits for the callback to return
+        pendingCount -= (int) batchBoxes.size();
+        std::function<void(const GlyphBox *, int)> batchCallback = callback;
+        if (batchCallback) {
+            callbackRunning = true;
+            lock.unlock();
+            batchCallback(batchBoxes.data(), (int) batchBoxes.size());
+            lock.lock();
+            callbackRunning = false;
+        } else
+            finished.insert(finished.end(), batchBoxes.begin(), batchBoxes.end());
+        idleCondition.notify_all();
+    }
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+bool AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::copyGlyph(const Copy &copy) {
+    int l, b, w, h;
+    copy.glyph.getBoxRect(l, b, w, h);
+    int page = copy.glyph.getBoxPage();
+    if (page == copy.source.page && l == copy.source.rect.x && b == copy.source.rect.y)
+        return true;
+    const AtlasStorage &src = generator.atlasStorage(copy.source.page);
+    AtlasStorage &dst = generator.mutableAtlasStorage(page);
+    return copyAtlasStorageRect<T, N>(src, dst, copy.source.rect.x, copy.source.rect.y, l, b, w, h, 0) || copyAtlasStorageRect<byte, N>(src, dst, copy.source.rect.x, copy.source.rect.y, l, b, w, h, 0);
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::generate(const GlyphGeometry *glyphs, int count) {
+    if (count <= 0)
+        return;
+    for (int i = 0; i < count; ++i)
+        layout.push_back((GlyphBox) glyphs[i]);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < count; ++i) {
+            // Glyphs identical to one being generated are copied once it is finished
+            int original = -1;
+            if (!glyphs[i].isWhitespace()) {
+                typename decltype(batchLastByIndex)::const_iterator it = batchLastByIndex.find(glyphs[i].getIndex());
+                if (it != batchLastByIndex.end()) {
+                    for (original = it->second; original >= 0 && !batch[original].hasIdenticalBitmap(glyphs[i]);)
+                        original = batchPrevByIndex[original];
+                }
+            }
+            if (original >= 0) {
+                Copy copy = { (GlyphBox) batch[original], glyphs[i] };
+                copies.push_back((Copy &&) copy);
+            } else
+                queue.push_back(glyphs[i]);
+        }
+        pendingCount += count;
+        if (!thread.joinable())
+            thread = std::thread(&AsyncAtlasGenerator::threadMain, this);
+    }
+    queueCondition.notify_one();
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+int AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::cancel(const Rectangle &rect, int page) {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t remaining = 0;
+    for (size_t i = 0; i < queue.size(); ++i) {
+        const GlyphGeometry &glyph = queue[i];
+        Rectangle box = glyph.getBoxRect();
+        if (glyph.getBoxPage() == page && box.x < rect.x+rect.w && rect.x < box.x+box.w && box.y < rect.y+rect.h && rect.y < box.y+box.h)
+            continue;
+        if (remaining < i)
+            queue[remaining] = (GlyphGeometry &&) queue[i];
+        ++remaining;
+    }
+    int cancelled = (int) (queue.size()-remaining);
+    queue.erase(queue.begin()+remaining, queue.end());
+    remaining = 0;
+    for (size_t i = 0; i < copies.size(); ++i) {
+        const GlyphGeometry &glyph = copies[i].glyph;
+        Rectangle box = glyph.getBoxRect();
+        if (glyph.getBoxPage() == page && box.x < rect.x+rect.w && rect.x < box.x+box.w && box.y < rect.y+rect.h && rect.y < box.y+box.h)
+            continue;
+        if (remaining < i)
+            copies[remaining] = (Copy &&) copies[i];
+        ++remaining;
+    }
+    cancelled += (int) (copies.size()-remaining);
+    copies.erase(copies.begin()+remaining, copies.end());
+    pendingCount -= cancelled;
+    if (cancelled)
+        idleCondition.notify_all();
+    return cancelled;
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::rearrange(int width, int height, const Remap *remapping, int count) {
+    wait();
+    for (int i = 0; i < count; ++i) {
+        if (remapping[i].index < (int) layout.size()) {
+            layout[remapping[i].index].rect.x = remapping[i].target.x;
+            layout[remapping[i].index].rect.y = remapping[i].target.y;
+            layout[remapping[i].index].page = remapping[i].target.page;
+        }
+    }
+    std::lock_guard<std::mutex> generatorLock(generatorMutex);
+    generator.rearrange(width, height, remapping, count);
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::resize(int width, int height) {
+    std::lock_guard<std::mutex> generatorLock(generatorMutex);
+    generator.resize(width, height);
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+template <typename... ARGS>
+typename std::enable_if<std::is_constructible<AtlasStorage, int, int, ARGS...>::value, int>::type AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::addPage(int width, int height, ARGS... storageArgs) {
+    std::lock_guard<std::mutex> generatorLock(generatorMutex);
+    return generator.addPage(width, height, storageArgs...);
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::setAttributes(const GeneratorAttributes &attributes) {
+    {
+        // Glyphs of the batch being generated with the previous attributes must not be copied anymore
+        std::lock_guard<std::mutex> lock(mutex);
+        batchLastByIndex.clear();
+    }
+    std::lock_guard<std::mutex> generatorLock(generatorMutex);
+    generator.setAttributes(attributes);
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::setThreadCount(int threadCount) {
+    std::lock_guard<std::mutex> generatorLock(generatorMutex);
+    generator.setThreadCount(threadCount);
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::setBandSplitting(bool enabled) {
+    std::lock_guard<std::mutex> generatorLock(generatorMutex);
+    generator.setBandSplitting(enabled);
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::setThreadPool(ThreadPool *threadPool) {
+    std::lock_guard<std::mutex> generatorLock(generatorMutex);
+    generator.setThreadPool(threadPool);
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::setCallback(const std::function<void(const GlyphBox *, int)> &callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->callback = callback;
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+int AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::fetchFinished(std::vector<GlyphBox, Allocator<GlyphBox>> &output) {
+    std::lock_guard<std::mutex> lock(mutex);
+    int count = (int) finished.size();
+    output.insert(output.end(), finished.begin(), finished.end());
+    finished.clear();
+    return count;
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+int AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pendingCount;
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::wait() {
+    // The background thread cannot wait for glyphs which only it can generate
+    assert(std::this_thread::get_id() != thread.get_id());
+    std::unique_lock<std::mutex> lock(mutex);
+    idleCondition.wait(lock, [this]() -> bool {
+        return !pendingCount && !callbackRunning;
+    });
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+const AtlasStorage &AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::atlasStorage(int page) const {
+    return generator.atlasStorage(page);
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+AtlasStorage &AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::mutableAtlasStorage(int page) {
+    return generator.mutableAtlasStorage(page);
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+int AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::getPageCount() const {
+    return generator.getPageCount();
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+const std::vector<GlyphBox, Allocator<GlyphBox>> &AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::getLayout() const {
+    return layout;
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void AsyncAtlasGenerator<T, N, GEN_FN, AtlasStorage>::clearLayout() {
+    layout.clear();
+}
+
+}
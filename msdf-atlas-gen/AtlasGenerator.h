@@ -24,6 +24,8 @@ public:
     void rearrange(int width, int height, const Remap *remapping, int count);
     /// Resizes the atlas and keeps the generated pixels in place
     void resize(int width, int height);
+    /// Optional - adds a new empty page to the atlas and returns its index
+    int addPage(int width, int height);
 
 };
 
@@ -37,6 +39,6 @@ struct GeneratorAttributes {
 
 /// A function that generates the bitmap for a single glyph
 template <typename T, int N>
-using GeneratorFunction = void (*)(const msdfgen::BitmapRef<T, N> &, const GlyphGeometry &, const GeneratorAttributes &);
+using GeneratorFunction = void (*)(const msdfgen::BitmapSection<T, N> &, const GlyphGeometry &, const GeneratorAttributes &);
 
 }
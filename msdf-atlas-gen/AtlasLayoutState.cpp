@@ -0,0 +1,354 @@
+
+#include "AtlasLayoutState.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#define ATLAS_LAYOUT_STATE_VERSION 1u
+#define ATLAS_LAYOUT_STATE_HEADER_SIZE 32
+#define ATLAS_LAYOUT_STATE_ENTRY_SIZE 64
+
+namespace msdf_atlas {
+
+/*
+ * Layout state file format (all values little-endian):
+ *     8 bytes - signature "MSDFALYT"
+ *     u32 - format version
+ *     u32 - number of glyphs
+ *     u32 - atlas width
+ *     u32 - atlas height
+ *     u64 - generator settings hash
+ *     for each glyph:
+ *         u64 - shape hash
+ *         f64 - box scale
+ *         f64 x 2 - box range (lower, upper)
+ *         f64 x 2 - box translate (x, y)
+ *         i32 x 4 - box rectangle (x, y, width, height)
+ */
+
+static const char ATLAS_LAYOUT_STATE_SIGNATURE[] = "MSDFALYT";
+
+typedef std::vector<byte, Allocator<byte>> ByteVector;
+
+static unsigned long long fnv1a(unsigned long long hash, const void *data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= reinterpret_cast<const byte *>(data)[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+template <typename T>
+static unsigned long long fnv1a(unsigned long long hash, T value) {
+    return fnv1a(hash, &value, sizeof(T));
+}
+
+static void writeUint32(ByteVector &output, unsigned value) {
+    for (int i = 0; i < 4; ++i)
+        output.push_back(byte(value>>(8*i)));
+}
+
+static void writeUint64(ByteVector &output, unsigned long long value) {
+    for (int i = 0; i < 8; ++i)
+        output.push_back(byte(value>>(8*i)));
+}
+
+static void writeDouble(ByteVector &output, double value) {
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    writeUint64(output, bits);
+}
+
+static unsigned readUint32(const byte *data) {
+    return (unsigned) data[0]|(unsigned) data[1]<<8|(unsigned) data[2]<<16|(unsigned) data[3]<<24;
+}
+
+static unsigned long long readUint64(const byte *data) {
+    return (unsigned long long) readUint32(data)|(unsigned long long) readUint32(data+4)<<32;
+}
+
+static double readDouble(const byte *data) {
+    unsigned long long bits = readUint64(data);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/// Removes the rectangle from the list of maximal empty rectangles, replacing each one it intersects with the up to four maximal rectangles around it
+static void occupySpace(std::vector<Rectangle, Allocator<Rectangle>> &spaces, const Rectangle &rect) {
+    std::vector<Rectangle, Allocator<Rectangle>> newSpaces;
+    for (size_t i = 0; i < spaces.size();) {
+        Rectangle space = spaces[i];
+        if (!(rect.x < space.x+space.w && space.x < rect.x+rect.w && rect.y < space.y+space.h && space.y < rect.y+rect.h)) {
+            ++i;
+            continue;
+        }
+        spaces[i] = spaces.back();
+        spaces.pop_back();
+        if (rect.x > space.x)
+            newSpaces.push_back(Rectangle { space.x, space.y, rect.x-space.x, space.h });
+        if (rect.x+rect.w < space.x+space.w)
+            newSpaces.push_back(Rectangle { rect.x+rect.w, space.y, space.x+space.w-(rect.x+rect.w), space.h });
+        if (rect.y > space.y)
+            newSpaces.push_back(Rectangle { space.x, space.y, space.w, rect.y-space.y });
+        if (rect.y+rect.h < space.y+space.h)
+            newSpaces.push_back(Rectangle { space.x, rect.y+rect.h, space.w, space.y+space.h-(rect.y+rect.h) });
+    }
+    // Only the new rectangles may be contained in others, since they are parts of previously maximal ones
+    auto contains = [](const Rectangle &a, const Rectangle &b) -> bool {
+        return a.x <= b.x && a.y <= b.y && b.x+b.w <= a.x+a.w && b.y+b.h <= a.y+a.h;
+    };
+    size_t oldCount = spaces.size();
+    for (size_t i = 0; i < newSpaces.size(); ++i) {
+        bool contained = false;
+        for (size_t j = 0; j < oldCount && !contained; ++j)
+            contained = contains(spaces[j], newSpaces[i]);
+        for (size_t j = 0; j < newSpaces.size() && !contained; ++j)
+            contained = j != i && contains(newSpaces[j], newSpaces[i]) && (j < i || !contains(newSpaces[i], newSpaces[j]));
+        if (!contained)
+            spaces.push_back(newSpaces[i]);
+    }
+}
+
+AtlasLayoutState::AtlasLayoutState() : width(0), height(0), settingsHash(0) { }
+
+AtlasLayoutState::AtlasLayoutState(const GlyphGeometry *glyphs, int count, int width, int height, unsigned long long settingsHash) : width(width), height(height), settingsHash(settingsHash) {
+    entries.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Entry entry;
+        entry.rect = glyphs[i].getBoxRect();
+        if (!(entry.rect.w > 0 && entry.rect.h > 0))
+            continue;
+        entry.shapeHash = hashShape(glyphs[i].getShape());
+        entry.scale = glyphs[i].getBoxScale();
+        entry.rangeLower = glyphs[i].getBoxRange().lower;
+        entry.rangeUpper = glyphs[i].getBoxRange().upper;
+        entry.translateX = glyphs[i].getBoxTranslate().x;
+        entry.translateY = glyphs[i].getBoxTranslate().y;
+        entries.push_back(entry);
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.shapeHash < b.shapeHash;
+    });
+}
+
+bool AtlasLayoutState::load(const char *filename) {
+    FILE *f = fopen(filename, "rb");
+    if (!f)
+        return false;
+    byte header[ATLAS_LAYOUT_STATE_HEADER_SIZE];
+    if (!(fread(header, 1, ATLAS_LAYOUT_STATE_HEADER_SIZE, f) == ATLAS_LAYOUT_STATE_HEADER_SIZE && !memcmp(header, ATLAS_LAYOUT_STATE_SIGNATURE, 8) && readUint32(header+8) == ATLAS_LAYOUT_STATE_VERSION)) {
+        fclose(f);
+        return false;
+    }
+    // The entry count must not exceed what the rest of the file can hold before anything is allocated for it
+    unsigned count = readUint32(header+12);
+    long size = -1;
+    if (!fseek(f, 0, SEEK_END) && (size = ftell(f)) >= 0 && fseek(f, ATLAS_LAYOUT_STATE_HEADER_SIZE, SEEK_SET))
+        size = -1;
+    if (size < ATLAS_LAYOUT_STATE_HEADER_SIZE || (unsigned long long) count*ATLAS_LAYOUT_STATE_ENTRY_SIZE != (unsigned long long) (size-ATLAS_LAYOUT_STATE_HEADER_SIZE)) {
+        fclose(f);
+        return false;
+    }
+    ByteVector data((size_t) count*ATLAS_LAYOUT_STATE_ENTRY_SIZE);
+    bool success = fread(data.data(), 1, data.size(), f) == data.size();
+    fclose(f);
+    if (!success)
+        return false;
+    width = (int) readUint32(header+16);
+    height = (int) readUint32(header+20);
+    settingsHash = readUint64(header+24);
+    entries.resize(count);
+    for (unsigned i = 0; i < count; ++i) {
+        const byte *p = data.data()+(size_t) ATLAS_LAYOUT_STATE_ENTRY_SIZE*i;
+        Entry &entry = entries[i];
+        entry.shapeHash = readUint64(p);
+        entry.scale = readDouble(p+8);
+        entry.rangeLower = readDouble(p+16);
+        entry.rangeUpper = readDouble(p+24);
+        entry.translateX = readDouble(p+32);
+        entry.translateY = readDouble(p+40);
+        entry.rect.x = (int) readUint32(p+48);
+        entry.rect.y = (int) readUint32(p+52);
+        entry.rect.w = (int) readUint32(p+56);
+        entry.rect.h = (int) readUint32(p+60);
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.shapeHash < b.shapeHash;
+    });
+    return true;
+}
+
+bool AtlasLayoutState::save(const char *filename) const {
+    ByteVector output;
+    output.reserve(ATLAS_LAYOUT_STATE_HEADER_SIZE+ATLAS_LAYOUT_STATE_ENTRY_SIZE*entries.size());
+    output.insert(output.end(), ATLAS_LAYOUT_STATE_SIGNATURE, ATLAS_LAYOUT_STATE_SIGNATURE+8);
+    writeUint32(output, ATLAS_LAYOUT_STATE_VERSION);
+    writeUint32(output, (unsigned) entries.size());
+    writeUint32(output, (unsigned) width);
+    writeUint32(output, (unsigned) height);
+    writeUint64(output, settingsHash);
+    for (const Entry &entry : entries) {
+        writeUint64(output, entry.shapeHash);
+        writeDouble(output, entry.scale);
+        writeDouble(output, entry.rangeLower);
+        writeDouble(output, entry.rangeUpper);
+        writeDouble(output, entry.translateX);
+        writeDouble(output, entry.translateY);
+        writeUint32(output, (unsigned) entry.rect.x);
+        writeUint32(output, (unsigned) entry.rect.y);
+        writeUint32(output, (unsigned) entry.rect.w);
+        writeUint32(output, (unsigned) entry.rect.h);
+    }
+    FILE *f = fopen(filename, "wb");
+    if (!f)
+        return false;
+    bool success = fwrite(output.data(), 1, output.size(), f) == output.size();
+    return !fclose(f) && success;
+}
+
+int AtlasLayoutState::getWidth() const {
+    return width;
+}
+
+int AtlasLayoutState::getHeight() const {
+    return height;
+}
+
+int AtlasLayoutState::findGlyphs(Rectangle *previousBoxes, const GlyphGeometry *glyphs, int count, unsigned long long settingsHash) const {
+    int found = 0;
+    std::vector<bool, Allocator<bool>> used(entries.size());
+    for (int i = 0; i < count; ++i) {
+        previousBoxes[i] = Rectangle();
+        int w, h;
+        glyphs[i].getBoxSize(w, h);
+        if (!(settingsHash == this->settingsHash && w > 0 && h > 0))
+            continue;
+        Entry key = { };
+        key.shapeHash = hashShape(glyphs[i].getShape());
+        auto range = std::equal_range(entries.begin(), entries.end(), key, [](const Entry &a, const Entry &b) {
+            return a.shapeHash < b.shapeHash;
+        });
+        msdfgen::Range boxRange = glyphs[i].getBoxRange();
+        msdfgen::Vector2 translate = glyphs[i].getBoxTranslate();
+        size_t match = entries.size();
+        for (auto it = range.first; it != range.second; ++it) {
+            // The bitmap is only identical if the transformation is exactly the same
+            if (it->rect.w == w && it->rect.h == h && it->scale == glyphs[i].getBoxScale() && it->rangeLower == boxRange.lower && it->rangeUpper == boxRange.upper && it->translateX == translate.x && it->translateY == translate.y) {
+                // Glyphs with identical bitmaps are matched to distinct recorded boxes where possible, so that all of them may keep their placement
+                match = it-entries.begin();
+                if (!used[match])
+                    break;
+            }
+        }
+        if (match < entries.size()) {
+            previousBoxes[i] = entries[match].rect;
+            used[match] = true;
+            ++found;
+        }
+    }
+    return found;
+}
+
+bool AtlasLayoutState::restorePlacement(GlyphGeometry *glyphs, const Rectangle *previousBoxes, int count, int width, int height, int spacing) {
+    // Boxes are extended by spacing, and the free area is tracked as a list of maximal (possibly overlapping) empty rectangles,
+    // because the kept boxes are scattered over the whole atlas and a guillotine partition of the area around them would be too fragmented
+    std::vector<Rectangle, Allocator<Rectangle>> spaces;
+    spaces.push_back(Rectangle { 0, 0, width+spacing, height+spacing });
+    std::vector<Rectangle, Allocator<Rectangle>> placements(count);
+    std::vector<int, Allocator<int>> remainingGlyphs;
+    int keptCount = 0;
+    for (int i = 0; i < count; ++i) {
+        int w, h;
+        glyphs[i].getBoxSize(w, h);
+        placements[i] = Rectangle { 0, 0, w+spacing, h+spacing };
+        if (!(w > 0 && h > 0))
+            continue;
+        const Rectangle &previous = previousBoxes[i];
+        Rectangle &rect = placements[i];
+        rect.x = previous.x, rect.y = previous.y;
+        // A previous box may only be kept by one glyph (duplicates are packed elsewhere)
+        bool keep = previous.w == w && previous.h == h && rect.x >= 0 && rect.y >= 0 && rect.x+rect.w <= width+spacing && rect.y+rect.h <= height+spacing;
+        if (keep) {
+            keep = false;
+            for (const Rectangle &space : spaces) {
+                if (space.x <= rect.x && space.y <= rect.y && rect.x+rect.w <= space.x+space.w && rect.y+rect.h <= space.y+space.h) {
+                    keep = true;
+                    break;
+                }
+            }
+        }
+        if (keep) {
+            occupySpace(spaces, rect);
+            ++keptCount;
+        } else
+            remainingGlyphs.push_back(i);
+    }
+    if (!keptCount)
+        return false;
+    // Remaining boxes are placed from the largest by best short side fit
+    std::stable_sort(remainingGlyphs.begin(), remainingGlyphs.end(), [&placements](int a, int b) {
+        return std::max(placements[a].w, placements[a].h) > std::max(placements[b].w, placements[b].h);
+    });
+    for (int i : remainingGlyphs) {
+        Rectangle &rect = placements[i];
+        if (!(rect.w-spacing > 0 && rect.h-spacing > 0))
+            continue;
+        const Rectangle *bestSpace = nullptr;
+        int bestShortSide = 0, bestLongSide = 0;
+        for (const Rectangle &space : spaces) {
+            if (rect.w <= space.w && rect.h <= space.h) {
+                int shortSide = std::min(space.w-rect.w, space.h-rect.h), longSide = std::max(space.w-rect.w, space.h-rect.h);
+                if (!bestSpace || shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+                    bestSpace = &space;
+                    bestShortSide = shortSide, bestLongSide = longSide;
+                }
+            }
+        }
+        if (!bestSpace)
+            return false;
+        rect.x = bestSpace->x, rect.y = bestSpace->y;
+        occupySpace(spaces, rect);
+    }
+    for (int i = 0; i < count; ++i) {
+        if (placements[i].w-spacing > 0 && placements[i].h-spacing > 0)
+            glyphs[i].placeBox(placements[i].x, placements[i].y);
+    }
+    return true;
+}
+
+unsigned long long AtlasLayoutState::hashShape(const msdfgen::Shape &shape) {
+    unsigned long long hash = fnv1a(0xcbf29ce484222325ull, (byte) shape.inverseYAxis);
+    for (const msdfgen::Contour &contour : shape.contours) {
+        hash = fnv1a(hash, (unsigned) contour.edges.size());
+        for (const msdfgen::EdgeHolder &edge : contour.edges) {
+            int degree = edge->type();
+            hash = fnv1a(hash, (byte) degree);
+            hash = fnv1a(hash, (byte) edge->color);
+            const msdfgen::Point2 *p = edge->controlPoints();
+            for (int i = 0; i <= degree; ++i) {
+                hash = fnv1a(hash, p[i].x);
+                hash = fnv1a(hash, p[i].y);
+            }
+        }
+    }
+    return hash;
+}
+
+unsigned long long AtlasLayoutState::hashSettings(ImageType imageType, ImageFormat imageFormat, YDirection yDirection, const GeneratorAttributes &attributes) {
+    unsigned long long hash = fnv1a(0xcbf29ce484222325ull, ATLAS_LAYOUT_STATE_VERSION);
+    hash = fnv1a(hash, (int) imageType);
+    // The previous image is reloaded with the current format and Y direction, so a change of either would misplace its pixels
+    hash = fnv1a(hash, (int) imageFormat);
+    hash = fnv1a(hash, (int) yDirection);
+    hash = fnv1a(hash, (byte) attributes.config.overlapSupport);
+    hash = fnv1a(hash, (int) attributes.config.errorCorrection.mode);
+    hash = fnv1a(hash, (int) attributes.config.errorCorrection.distanceCheckMode);
+    hash = fnv1a(hash, attributes.config.errorCorrection.minDeviationRatio);
+    hash = fnv1a(hash, attributes.config.errorCorrection.minImproveRatio);
+    hash = fnv1a(hash, (byte) attributes.scanlinePass);
+    return hash;
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <msdfgen.h>
+#include "types.h"
+#include "Rectangle.h"
+#include "GlyphGeometry.h"
+#include "AtlasGenerator.h"
+
+namespace msdf_atlas {
+
+/**
+ * Records the layout of a generated atlas together with everything its glyph bitmaps depend on
+ * (a hash of each glyph's colored shape, its box transformation, and the generator settings),
+ * so that a subsequent build of the atlas can reuse the bitmaps of glyphs that have not changed
+ * instead of generating them again, and preferably keep them in place.
+ */
+class AtlasLayoutState {
+
+public:
+    AtlasLayoutState();
+    /// Records the layout of glyphs (which must be placed in the atlas), settingsHash identifies the generator settings (see hashSettings)
+    AtlasLayoutState(const GlyphGeometry *glyphs, int count, int width, int height, unsigned long long settingsHash);
+    /// Loads the layout from a file, returns false on failure
+    bool load(const char *filename);
+    /// Saves the layout to a file, returns false on failure
+    bool save(const char *filename) const;
+    /// Returns the dimensions of the recorded atlas
+    int getWidth() const;
+    int getHeight() const;
+    /// For each glyph with a box, outputs the box rectangle of a recorded glyph whose bitmap would be identical, or an empty rectangle if there is none, returns the number of glyphs found
+    int findGlyphs(Rectangle *previousBoxes, const GlyphGeometry *glyphs, int count, unsigned long long settingsHash) const;
+
+    /// Places the glyphs found by findGlyphs at their previous box positions and packs the others into the remaining area of a width x height atlas, returns false and leaves glyphs unchanged if they do not fit
+    static bool restorePlacement(GlyphGeometry *glyphs, const Rectangle *previousBoxes, int count, int width, int height, int spacing);
+    /// Computes the hash of the geometry and edge colors of a shape
+    static unsigned long long hashShape(const msdfgen::Shape &shape);
+    /// Computes the hash of the settings that affect the generated glyph bitmaps and their encoding in the image file
+    static unsigned long long hashSettings(ImageType imageType, ImageFormat imageFormat, YDirection yDirection, const GeneratorAttributes &attributes);
+
+private:
+    struct Entry {
+        unsigned long long shapeHash;
+        double scale;
+        double rangeLower, rangeUpper;
+        double translateX, translateY;
+        Rectangle rect;
+    };
+
+    int width, height;
+    unsigned long long settingsHash;
+    /// Sorted by shapeHash
+    std::vector<Entry, Allocator<Entry>> entries;
+
+};
+
+}
@@ -23,12 +23,20 @@ public:
     AtlasStorage(const AtlasStorage &orig, int width, int height);
     /// Creates a copy with different dimensions and rearranges the pixels according to the remapping array
     AtlasStorage(const AtlasStorage &orig, int width, int height, const Remap *remapping, int count);
+    /// Optional - same as the two above but may reuse the original's memory
+    AtlasStorage(AtlasStorage &&orig, int width, int height);
+    AtlasStorage(AtlasStorage &&orig, int width, int height, const Remap *remapping, int count);
     /// Stores a subsection at x, y into the atlas storage. May be implemented for only some T, N
     template <typename T, int N>
     void put(int x, int y, const msdfgen::BitmapConstRef<T, N> &subBitmap);
     /// Retrieves a subsection at x, y from the atlas storage. May be implemented for only some T, N
     template <typename T, int N>
     void get(int x, int y, const msdfgen::BitmapRef<T, N> &subBitmap) const;
+    /// Optional - returns a reference to the storage's own memory of the subsection at x, y, which glyphs may be generated into directly, or an empty section if not possible
+    template <typename T, int N>
+    msdfgen::BitmapSection<T, N> getSection(int x, int y, int width, int height);
+    /// Optional - notifies the storage that a section previously obtained from getSection has been written into
+    void commitSection(int x, int y, int width, int height);
 
 };
 
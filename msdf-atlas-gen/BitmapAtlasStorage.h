@@ -1,11 +1,19 @@
 
 #pragma once
 
+#include <vector>
+#include <mutex>
+#include "types.h"
+#include "Rectangle.h"
 #include "AtlasStorage.h"
 
 namespace msdf_atlas {
 
-/// An implementation of AtlasStorage represented by a bitmap in memory (msdfgen::Bitmap)
+/**
+ * An implementation of AtlasStorage represented by a bitmap in memory (msdfgen::Bitmap).
+ * It keeps track of the regions modified by put, commitSection, or by being created, resized, or rearranged,
+ * so that only those need to be uploaded to e.g. a texture (fetchDirtyRectangles).
+ */
 template <typename T, int N>
 class BitmapAtlasStorage {
 
@@ -16,15 +24,38 @@ public:
     explicit BitmapAtlasStorage(msdfgen::Bitmap<T, N> &&bitmap);
     BitmapAtlasStorage(const BitmapAtlasStorage<T, N> &orig, int width, int height);
     BitmapAtlasStorage(const BitmapAtlasStorage<T, N> &orig, int width, int height, const Remap *remapping, int count);
+    /// Takes over the original's bitmap, which is only reallocated if the dimensions change
+    BitmapAtlasStorage(BitmapAtlasStorage<T, N> &&orig, int width, int height);
+    /// Takes over the original's bitmap and, if the dimensions don't change, rearranges the pixels in place, using a scratch buffer only for rectangles that block each other's moves in a cycle
+    BitmapAtlasStorage(BitmapAtlasStorage<T, N> &&orig, int width, int height, const Remap *remapping, int count);
+    BitmapAtlasStorage(const BitmapAtlasStorage<T, N> &orig);
+    BitmapAtlasStorage(BitmapAtlasStorage<T, N> &&orig);
+    BitmapAtlasStorage<T, N> &operator=(const BitmapAtlasStorage<T, N> &orig);
+    BitmapAtlasStorage<T, N> &operator=(BitmapAtlasStorage<T, N> &&orig);
     operator msdfgen::BitmapConstRef<T, N>() const;
     operator msdfgen::BitmapRef<T, N>();
     operator msdfgen::Bitmap<T, N>() &&;
     template <typename S>
     void put(int x, int y, const msdfgen::BitmapConstRef<S, N> &subBitmap);
     void get(int x, int y, const msdfgen::BitmapRef<T, N> &subBitmap) const;
+    /// Returns a reference to the pixels of the subsection at x, y for writing in place, or an empty section if it is out of bounds
+    msdfgen::BitmapSection<T, N> getSection(int x, int y, int width, int height);
+    /// Marks the subsection at x, y as modified after it has been written into via getSection
+    void commitSection(int x, int y, int width, int height);
+    /// Moves the rectangles modified since the previous call (merged where it doesn't add much area) to the end of output and returns their number
+    int fetchDirtyRectangles(std::vector<Rectangle, Allocator<Rectangle>> &output);
 
 private:
     msdfgen::Bitmap<T, N> bitmap;
+    std::vector<Rectangle, Allocator<Rectangle>> dirtyRectangles;
+    mutable std::mutex dirtyMutex;
+
+    /// Adds the rectangle (clipped to the bitmap) to the dirty rectangles, safe to call from multiple threads
+    void markDirty(int x, int y, int width, int height);
+    /// Changes the dimensions of the bitmap, keeping the pixels of the common area and zeroing the rest
+    void resizeBitmap(int width, int height);
+    /// Replaces the bitmap with one of the new dimensions containing only the remapped rectangles
+    void remapBitmap(const msdfgen::Bitmap<T, N> &orig, int width, int height, const Remap *remapping, int count);
 
 };
 
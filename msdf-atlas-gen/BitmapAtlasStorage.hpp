@@ -4,6 +4,7 @@
 #include <cstring>
 #include <algorithm>
 #include "bitmap-blit.h"
+#include "bitmap-remap.h"
 
 namespace msdf_atlas {
 
@@ -13,27 +14,93 @@ BitmapAtlasStorage<T, N>::BitmapAtlasStorage() { }
 template <typename T, int N>
 BitmapAtlasStorage<T, N>::BitmapAtlasStorage(int width, int height) : bitmap(width, height) {
     memset((T *) bitmap, 0, sizeof(T)*N*width*height);
+    markDirty(0, 0, width, height);
 }
 
 template <typename T, int N>
-BitmapAtlasStorage<T, N>::BitmapAtlasStorage(const msdfgen::BitmapConstRef<T, N> &bitmap) : bitmap(bitmap) { }
+BitmapAtlasStorage<T, N>::BitmapAtlasStorage(const msdfgen::BitmapConstRef<T, N> &bitmap) : bitmap(bitmap) {
+    markDirty(0, 0, bitmap.width, bitmap.height);
+}
 
 template <typename T, int N>
-BitmapAtlasStorage<T, N>::BitmapAtlasStorage(msdfgen::Bitmap<T, N> &&bitmap) : bitmap((msdfgen::Bitmap<T, N> &&) bitmap) { }
+BitmapAtlasStorage<T, N>::BitmapAtlasStorage(msdfgen::Bitmap<T, N> &&bitmap) : bitmap((msdfgen::Bitmap<T, N> &&) bitmap) {
+    markDirty(0, 0, this->bitmap.width(), this->bitmap.height());
+}
 
 template <typename T, int N>
 BitmapAtlasStorage<T, N>::BitmapAtlasStorage(const BitmapAtlasStorage<T, N> &orig, int width, int height) : bitmap(width, height) {
     memset((T *) bitmap, 0, sizeof(T)*N*width*height);
     blit(bitmap, orig.bitmap, 0, 0, 0, 0, std::min(width, orig.bitmap.width()), std::min(height, orig.bitmap.height()));
+    markDirty(0, 0, width, height);
 }
 
 template <typename T, int N>
-BitmapAtlasStorage<T, N>::BitmapAtlasStorage(const BitmapAtlasStorage<T, N> &orig, int width, int height, const Remap *remapping, int count) : bitmap(width, height) {
-    memset((T *) bitmap, 0, sizeof(T)*N*width*height);
+BitmapAtlasStorage<T, N>::BitmapAtlasStorage(const BitmapAtlasStorage<T, N> &orig, int width, int height, const Remap *remapping, int count) {
+    remapBitmap(orig.bitmap, width, height, remapping, count);
+    markDirty(0, 0, width, height);
+}
+
+template <typename T, int N>
+BitmapAtlasStorage<T, N>::BitmapAtlasStorage(BitmapAtlasStorage<T, N> &&orig, int width, int height) : bitmap((msdfgen::Bitmap<T, N> &&) orig.bitmap) {
+    resizeBitmap(width, height);
+    markDirty(0, 0, width, height);
+}
+
+template <typename T, int N>
+BitmapAtlasStorage<T, N>::BitmapAtlasStorage(BitmapAtlasStorage<T, N> &&orig, int width, int height, const Remap *remapping, int count) : bitmap((msdfgen::Bitmap<T, N> &&) orig.bitmap) {
+    if (width != bitmap.width() || height != bitmap.height()) {
+        // Bitmap memory cannot be reallocated, so the rectangles are copied straight into the new bitmap rather than rearranged first
+        msdfgen::Bitmap<T, N> prevBitmap((msdfgen::Bitmap<T, N> &&) bitmap);
+        remapBitmap(prevBitmap, width, height, remapping, count);
+        markDirty(0, 0, width, height);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(orig.dirtyMutex);
+        dirtyRectangles = (std::vector<Rectangle, Allocator<Rectangle>> &&) orig.dirtyRectangles;
+    }
+    remapInPlace(msdfgen::BitmapSection<T, N>((T *) bitmap, width, height), remapping, count);
     for (int i = 0; i < count; ++i) {
         const Remap &remap = remapping[i];
-        blit(bitmap, orig.bitmap, remap.target.x, remap.target.y, remap.source.x, remap.source.y, remap.width, remap.height);
+        if (remap.source.x != remap.target.x || remap.source.y != remap.target.y) {
+            markDirty(remap.source.x, remap.source.y, remap.width, remap.height);
+            markDirty(remap.target.x, remap.target.y, remap.width, remap.height);
+        }
+    }
+}
+
+template <typename T, int N>
+BitmapAtlasStorage<T, N>::BitmapAtlasStorage(const BitmapAtlasStorage<T, N> &orig) : bitmap(orig.bitmap) {
+    std::lock_guard<std::mutex> lock(orig.dirtyMutex);
+    dirtyRectangles = orig.dirtyRectangles;
+}
+
+template <typename T, int N>
+BitmapAtlasStorage<T, N>::BitmapAtlasStorage(BitmapAtlasStorage<T, N> &&orig) : bitmap((msdfgen::Bitmap<T, N> &&) orig.bitmap) {
+    std::lock_guard<std::mutex> lock(orig.dirtyMutex);
+    dirtyRectangles = (std::vector<Rectangle, Allocator<Rectangle>> &&) orig.dirtyRectangles;
+}
+
+template <typename T, int N>
+BitmapAtlasStorage<T, N> &BitmapAtlasStorage<T, N>::operator=(const BitmapAtlasStorage<T, N> &orig) {
+    if (this != &orig) {
+        std::lock(dirtyMutex, orig.dirtyMutex);
+        std::lock_guard<std::mutex> lock(dirtyMutex, std::adopt_lock), origLock(orig.dirtyMutex, std::adopt_lock);
+        bitmap = orig.bitmap;
+        dirtyRectangles = orig.dirtyRectangles;
+    }
+    return *this;
+}
+
+template <typename T, int N>
+BitmapAtlasStorage<T, N> &BitmapAtlasStorage<T, N>::operator=(BitmapAtlasStorage<T, N> &&orig) {
+    if (this != &orig) {
+        std::lock(dirtyMutex, orig.dirtyMutex);
+        std::lock_guard<std::mutex> lock(dirtyMutex, std::adopt_lock), origLock(orig.dirtyMutex, std::adopt_lock);
+        bitmap = (msdfgen::Bitmap<T, N> &&) orig.bitmap;
+        dirtyRectangles = (std::vector<Rectangle, Allocator<Rectangle>> &&) orig.dirtyRectangles;
     }
+    return *this;
 }
 
 template <typename T, int N>
@@ -55,6 +122,7 @@ template <typename T, int N>
 template <typename S>
 void BitmapAtlasStorage<T, N>::put(int x, int y, const msdfgen::BitmapConstRef<S, N> &subBitmap) {
     blit(bitmap, subBitmap, x, y, 0, 0, subBitmap.width, subBitmap.height);
+    markDirty(x, y, subBitmap.width, subBitmap.height);
 }
 
 template <typename T, int N>
@@ -62,4 +130,77 @@ void BitmapAtlasStorage<T, N>::get(int x, int y, const msdfgen::BitmapRef<T, N>
     blit(subBitmap, bitmap, 0, 0, x, y, subBitmap.width, subBitmap.height);
 }
 
+template <typename T, int N>
+msdfgen::BitmapSection<T, N> BitmapAtlasStorage<T, N>::getSection(int x, int y, int width, int height) {
+    if (x < 0 || y < 0 || width < 0 || height < 0 || x+width > bitmap.width() || y+height > bitmap.height())
+        return msdfgen::BitmapSection<T, N>();
+    return bitmap.getSection(x, y, x+width, y+height);
+}
+
+template <typename T, int N>
+void BitmapAtlasStorage<T, N>::commitSection(int x, int y, int width, int height) {
+    markDirty(x, y, width, height);
+}
+
+template <typename T, int N>
+int BitmapAtlasStorage<T, N>::fetchDirtyRectangles(std::vector<Rectangle, Allocator<Rectangle>> &output) {
+    std::lock_guard<std::mutex> lock(dirtyMutex);
+    int count = (int) dirtyRectangles.size();
+    output.insert(output.end(), dirtyRectangles.begin(), dirtyRectangles.end());
+    dirtyRectangles.clear();
+    return count;
+}
+
+template <typename T, int N>
+void BitmapAtlasStorage<T, N>::resizeBitmap(int width, int height) {
+    if (width == bitmap.width() && height == bitmap.height())
+        return;
+    // Bitmap memory cannot be reallocated, so at least the common area must be copied
+    msdfgen::Bitmap<T, N> newBitmap(width, height);
+    int commonWidth = std::min(width, bitmap.width()), commonHeight = std::min(height, bitmap.height());
+    for (int y = 0; y < commonHeight; ++y) {
+        memcpy(newBitmap(0, y), bitmap(0, y), sizeof(T)*N*commonWidth);
+        memset(newBitmap(commonWidth, y), 0, sizeof(T)*N*(width-commonWidth));
+    }
+    if (height > commonHeight)
+        memset(newBitmap(0, commonHeight), 0, sizeof(T)*N*width*(height-commonHeight));
+    bitmap = (msdfgen::Bitmap<T, N> &&) newBitmap;
+}
+
+template <typename T, int N>
+void BitmapAtlasStorage<T, N>::remapBitmap(const msdfgen::Bitmap<T, N> &orig, int width, int height, const Remap *remapping, int count) {
+    msdfgen::Bitmap<T, N> newBitmap(width, height);
+    memset((T *) newBitmap, 0, sizeof(T)*N*width*height);
+    for (int i = 0; i < count; ++i) {
+        const Remap &remap = remapping[i];
+        blit(newBitmap, orig, remap.target.x, remap.target.y, remap.source.x, remap.source.y, remap.width, remap.height);
+    }
+    bitmap = (msdfgen::Bitmap<T, N> &&) newBitmap;
+}
+
+template <typename T, int N>
+void BitmapAtlasStorage<T, N>::markDirty(int x, int y, int width, int height) {
+    Rectangle rect;
+    rect.x = std::max(x, 0), rect.y = std::max(y, 0);
+    rect.w = std::min(x+width, bitmap.width())-rect.x, rect.h = std::min(y+height, bitmap.height())-rect.y;
+    if (rect.w <= 0 || rect.h <= 0)
+        return;
+    std::lock_guard<std::mutex> lock(dirtyMutex);
+    // Merge with dirty rectangles if their bounding rectangle isn't larger than the two combined
+    // A single pass keeps this linear - rectangles passed before the merged one grew may remain separate
+    for (size_t i = 0; i < dirtyRectangles.size();) {
+        const Rectangle &other = dirtyRectangles[i];
+        Rectangle merged;
+        merged.x = std::min(rect.x, other.x), merged.y = std::min(rect.y, other.y);
+        merged.w = std::max(rect.x+rect.w, other.x+other.w)-merged.x, merged.h = std::max(rect.y+rect.h, other.y+other.h)-merged.y;
+        if ((long long) merged.w*merged.h <= (long long) rect.w*rect.h+(long long) other.w*other.h) {
+            rect = merged;
+            dirtyRectangles[i] = dirtyRectangles.back();
+            dirtyRectangles.pop_back();
+        } else
+            ++i;
+    }
+    dirtyRectangles.push_back(rect);
+}
+
 }
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <vector>
+#include <functional>
 #include "RectanglePacker.h"
 #include "AtlasGenerator.h"
 
@@ -11,6 +12,10 @@ namespace msdf_atlas {
  * This class can be used to produce a dynamic atlas to which more glyphs are added over time.
  * It takes care of laying out and enlarging the atlas as necessary and delegates the actual work
  * to the specified AtlasGenerator, which may e.g. do the work asynchronously.
+ * If a maximum page side is set, the atlas stops growing at that size and further glyphs
+ * are placed on new pages of the same dimensions, so that existing pages remain unchanged.
+ * Pages are added by the generator's addPage, or by a page factory for storages which need other arguments (setPageFactory).
+ * If neither is possible, the atlas keeps growing beyond the maximum page side.
  */
 template <class AtlasGenerator>
 class DynamicAtlas {
@@ -19,9 +24,12 @@ public:
     enum ChangeFlag {
         NO_CHANGE = 0x00,
         RESIZED = 0x01,
-        REARRANGED = 0x02
+        REARRANGED = 0x02,
+        PAGE_ADDED = 0x04
     };
     typedef int ChangeFlags;
+    /// Adds a new empty page of the given dimensions to the generator and returns its index, or a negative value on failure
+    typedef std::function<int(AtlasGenerator &generator, int width, int height)> PageFactory;
 
     DynamicAtlas();
     /// Initializes generator with dimensions and custom arguments for generator
@@ -31,6 +39,10 @@ public:
     explicit DynamicAtlas(AtlasGenerator &&generator);
     /// Adds a batch of glyphs. Adding more than one glyph at a time may improve packing efficiency
     ChangeFlags add(GlyphGeometry *glyphs, int count, bool allowRearrange = false);
+    /// Sets the side (rounded up to a power of two) beyond which the atlas is not enlarged and new pages are added instead, 0 for no limit
+    void setMaxPageSide(int maxPageSide);
+    /// Sets the function to add new pages with instead of the generator's addPage(width, height), e.g. to give each page's storage its own file
+    void setPageFactory(const PageFactory &pageFactory);
     /// Allows access to generator. Do not add glyphs to the generator directly!
     AtlasGenerator &atlasGenerator();
     const AtlasGenerator &atlasGenerator() const;
@@ -40,10 +52,19 @@ private:
     int spacing;
     int glyphCount;
     int totalArea;
+    int maxPageSide;
+    int page;
+    int pageRectangles;
     RectanglePacker packer;
     AtlasGenerator generator;
+    PageFactory pageFactory;
     std::vector<Rectangle, Allocator<Rectangle>> rectangles;
     std::vector<Remap, Allocator<Remap>> remapBuffer;
+    std::vector<Rectangle, Allocator<Rectangle>> pendingRectangles;
+    std::vector<int, Allocator<int>> pendingIndices;
+
+    /// Packs the rectangles from start onwards which haven't been placed yet onto the current page, returns how many didn't fit
+    int packRectangles(int start);
 
 };
 
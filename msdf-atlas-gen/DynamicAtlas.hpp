@@ -5,15 +5,47 @@
 
 namespace msdf_atlas {
 
+/// Adds a page using the generator's own addPage (if it can add a page without further arguments)
 template <class AtlasGenerator>
-DynamicAtlas<AtlasGenerator>::DynamicAtlas() : side(0), spacing(0), glyphCount(0), totalArea(0) { }
+static auto addGeneratorPage(AtlasGenerator &generator, int width, int height, int) -> decltype(generator.addPage(width, height)) {
+    return generator.addPage(width, height);
+}
+
+template <class AtlasGenerator>
+static int addGeneratorPage(AtlasGenerator &, int, int, long) {
+    return -1;
+}
+
+template <class AtlasGenerator>
+DynamicAtlas<AtlasGenerator>::DynamicAtlas() : side(0), spacing(0), glyphCount(0), totalArea(0), maxPageSide(0), page(0), pageRectangles(0) { }
 
 template <class AtlasGenerator>
 template <typename... ARGS>
-DynamicAtlas<AtlasGenerator>::DynamicAtlas(int minSide, ARGS... args) : side(minSide > 0 ? ceilToPOT(minSide) : 0), spacing(0), glyphCount(0), totalArea(0), packer(side+spacing, side+spacing), generator(side, side, args...) { }
+DynamicAtlas<AtlasGenerator>::DynamicAtlas(int minSide, ARGS... args) : side(minSide > 0 ? ceilToPOT(minSide) : 0), spacing(0), glyphCount(0), totalArea(0), maxPageSide(0), page(0), pageRectangles(0), packer(side+spacing, side+spacing), generator(side, side, args...) { }
 
 template <class AtlasGenerator>
-DynamicAtlas<AtlasGenerator>::DynamicAtlas(AtlasGenerator &&generator) : side(0), spacing(0), glyphCount(0), totalArea(0), generator((AtlasGenerator &&) generator) { }
+DynamicAtlas<AtlasGenerator>::DynamicAtlas(AtlasGenerator &&generator) : side(0), spacing(0), glyphCount(0), totalArea(0), maxPageSide(0), page(0), pageRectangles(0), generator((AtlasGenerator &&) generator) { }
+
+template <class AtlasGenerator>
+int DynamicAtlas<AtlasGenerator>::packRectangles(int start) {
+    pendingRectangles.clear();
+    pendingIndices.clear();
+    for (int i = start; i < (int) rectangles.size(); ++i) {
+        if (rectangles[i].x < 0) {
+            pendingRectangles.push_back(rectangles[i]);
+            pendingIndices.push_back(i);
+        }
+    }
+    int remaining = packer.pack(pendingRectangles.data(), pendingRectangles.size());
+    for (int i = 0; i < (int) pendingIndices.size(); ++i) {
+        if (pendingRectangles[i].x >= 0) {
+            rectangles[pendingIndices[i]] = pendingRectangles[i];
+            remapBuffer[pendingIndices[i]].target.page = page;
+            ++pageRectangles;
+        }
+    }
+    return remaining;
+}
 
 template <class AtlasGenerator>
 typename DynamicAtlas<AtlasGenerator>::ChangeFlags DynamicAtlas<AtlasGenerator>::add(GlyphGeometry *glyphs, int count, bool allowRearrange) {
@@ -23,7 +55,7 @@ typename DynamicAtlas<AtlasGenerator>::ChangeFlags DynamicAtlas<AtlasGenerator>:
         if (!glyphs[i].isWhitespace()) {
             int w, h;
             glyphs[i].getBoxSize(w, h);
-            Rectangle rect = { 0, 0, w+spacing, h+spacing };
+            Rectangle rect = { -1, -1, w+spacing, h+spacing };
             rectangles.push_back(rect);
             Remap remapEntry = { };
             remapEntry.index = glyphCount+i;
@@ -35,18 +67,56 @@ typename DynamicAtlas<AtlasGenerator>::ChangeFlags DynamicAtlas<AtlasGenerator>:
     }
     if ((int) rectangles.size() > start) {
         int packerStart = start;
-        int remaining;
-        while ((remaining = packer.pack(rectangles.data()+packerStart, rectangles.size()-packerStart)) > 0) {
+        // The state of the first page before rearranging, in case its glyphs no longer fit on it together with the new ones
+        RectanglePacker previousPacker;
+        int previousPageRectangles = 0;
+        bool pageAvailable = true;
+        while (packRectangles(packerStart) > 0) {
+            if (maxPageSide && side >= maxPageSide && packerStart < start && pageAvailable) {
+                bool existingPlaced = true;
+                for (int i = 0; i < start && existingPlaced; ++i)
+                    existingPlaced = rectangles[i].x >= 0;
+                if (!existingPlaced) {
+                    // Existing glyphs must not move to another page - discard the rearrangement and only enlarge the page
+                    for (int i = 0; i < (int) rectangles.size(); ++i) {
+                        rectangles[i].x = i < start ? remapBuffer[i].target.x : -1;
+                        rectangles[i].y = i < start ? remapBuffer[i].target.y : -1;
+                    }
+                    packer = (RectanglePacker &&) previousPacker;
+                    packer.expand(side+spacing, side+spacing);
+                    pageRectangles = previousPageRectangles;
+                    packerStart = start;
+                    continue;
+                }
+            }
+            if (maxPageSide && side >= maxPageSide && pageRectangles && pageAvailable) {
+                // Leave the current page as is and continue on a new one
+                int newPage = pageFactory ? pageFactory(generator, side, side) : addGeneratorPage(generator, side, side, 0);
+                if (newPage >= 0) {
+                    page = newPage;
+                    packer = RectanglePacker(side+spacing, side+spacing);
+                    pageRectangles = 0;
+                    changeFlags |= PAGE_ADDED;
+                    continue;
+                }
+                // The current page is enlarged beyond the maximum side instead
+                pageAvailable = false;
+            }
             side = (side|!side)<<1;
-            while (side*side < totalArea)
+            while (side*side < totalArea && !(maxPageSide && side >= maxPageSide))
                 side <<= 1;
-            if (allowRearrange) {
+            if (allowRearrange && !page) {
+                if (packerStart == start) {
+                    previousPacker = (RectanglePacker &&) packer;
+                    previousPageRectangles = pageRectangles;
+                }
                 packer = RectanglePacker(side+spacing, side+spacing);
+                for (Rectangle &rect : rectangles)
+                    rect.x = -1, rect.y = -1;
+                pageRectangles = 0;
                 packerStart = 0;
-            } else {
+            } else
                 packer.expand(side+spacing, side+spacing);
-                packerStart = rectangles.size()-remaining;
-            }
             changeFlags |= RESIZED;
         }
         if (packerStart < start) {
@@ -63,7 +133,7 @@ typename DynamicAtlas<AtlasGenerator>::ChangeFlags DynamicAtlas<AtlasGenerator>:
         for (int i = start; i < (int) rectangles.size(); ++i) {
             remapBuffer[i].target.x = rectangles[i].x;
             remapBuffer[i].target.y = rectangles[i].y;
-            glyphs[remapBuffer[i].index-glyphCount].placeBox(rectangles[i].x, rectangles[i].y);
+            glyphs[remapBuffer[i].index-glyphCount].placeBox(rectangles[i].x, rectangles[i].y, remapBuffer[i].target.page);
         }
     }
     generator.generate(glyphs, count);
@@ -71,6 +141,16 @@ typename DynamicAtlas<AtlasGenerator>::ChangeFlags DynamicAtlas<AtlasGenerator>:
     return changeFlags;
 }
 
+template <class AtlasGenerator>
+void DynamicAtlas<AtlasGenerator>::setMaxPageSide(int maxPageSide) {
+    this->maxPageSide = maxPageSide > 0 ? ceilToPOT(maxPageSide) : 0;
+}
+
+template <class AtlasGenerator>
+void DynamicAtlas<AtlasGenerator>::setPageFactory(const PageFactory &pageFactory) {
+    this->pageFactory = pageFactory;
+}
+
 template <class AtlasGenerator>
 AtlasGenerator &DynamicAtlas<AtlasGenerator>::atlasGenerator() {
     return generator;
@@ -0,0 +1,234 @@
+
+#include "FileMapping.h"
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+namespace msdf_atlas {
+
+#ifdef _WIN32
+
+FileMapping::FileMapping() : file(INVALID_HANDLE_VALUE), mapping(), memory(), length(0), writable(false) { }
+
+FileMapping::FileMapping(FileMapping &&orig) : file(orig.file), mapping(orig.mapping), memory(orig.memory), length(orig.length), writable(orig.writable) {
+    orig.file = INVALID_HANDLE_VALUE;
+    orig.mapping = nullptr;
+    orig.memory = nullptr;
+    orig.length = 0;
+}
+
+FileMapping &FileMapping::operator=(FileMapping &&orig) {
+    if (this != &orig) {
+        close();
+        file = orig.file, mapping = orig.mapping;
+        memory = orig.memory, length = orig.length;
+        writable = orig.writable;
+        orig.file = INVALID_HANDLE_VALUE;
+        orig.mapping = nullptr;
+        orig.memory = nullptr;
+        orig.length = 0;
+    }
+    return *this;
+}
+
+bool FileMapping::create(const char *filename, size_t size) {
+    close();
+    file = CreateFileA(filename, GENERIC_READ|GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    writable = true;
+    return resize(size);
+}
+
+bool FileMapping::openReadOnly(const char *filename) {
+    close();
+    file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        close();
+        return false;
+    }
+    writable = false;
+    length = (size_t) fileSize.QuadPart;
+    if (!map()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool FileMapping::resize(size_t size) {
+    if (file == INVALID_HANDLE_VALUE || !writable)
+        return false;
+    unmap();
+    LARGE_INTEGER fileSize;
+    fileSize.QuadPart = (LONGLONG) size;
+    if (!SetFilePointerEx(file, fileSize, NULL, FILE_BEGIN) || !SetEndOfFile(file))
+        return false;
+    length = size;
+    return map();
+}
+
+bool FileMapping::flush() {
+    if (!memory)
+        return file != INVALID_HANDLE_VALUE;
+    return FlushViewOfFile(memory, 0) && FlushFileBuffers(file);
+}
+
+void FileMapping::close() {
+    unmap();
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+    }
+    length = 0;
+}
+
+bool FileMapping::map() {
+    if (!length)
+        return true;
+    mapping = CreateFileMappingA(file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY, (DWORD) ((unsigned long long) length>>32), (DWORD) length, NULL);
+    if (!mapping)
+        return false;
+    memory = (byte *) MapViewOfFile(mapping, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, length);
+    if (!memory) {
+        CloseHandle(mapping);
+        mapping = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void FileMapping::unmap() {
+    if (memory) {
+        UnmapViewOfFile(memory);
+        memory = nullptr;
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+        mapping = nullptr;
+    }
+}
+
+#else
+
+FileMapping::FileMapping() : file(-1), memory(), length(0), writable(false) { }
+
+FileMapping::FileMapping(FileMapping &&orig) : file(orig.file), memory(orig.memory), length(orig.length), writable(orig.writable) {
+    orig.file = -1;
+    orig.memory = nullptr;
+    orig.length = 0;
+}
+
+FileMapping &FileMapping::operator=(FileMapping &&orig) {
+    if (this != &orig) {
+        close();
+        file = orig.file;
+        memory = orig.memory, length = orig.length;
+        writable = orig.writable;
+        orig.file = -1;
+        orig.memory = nullptr;
+        orig.length = 0;
+    }
+    return *this;
+}
+
+bool FileMapping::create(const char *filename, size_t size) {
+    close();
+    file = open(filename, O_RDWR|O_CREAT|O_TRUNC, 0644);
+    if (file < 0)
+        return false;
+    writable = true;
+    return resize(size);
+}
+
+bool FileMapping::openReadOnly(const char *filename) {
+    close();
+    file = open(filename, O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat fileStat;
+    if (fstat(file, &fileStat)) {
+        close();
+        return false;
+    }
+    writable = false;
+    length = (size_t) fileStat.st_size;
+    if (!map()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool FileMapping::resize(size_t size) {
+    if (file < 0 || !writable)
+        return false;
+    unmap();
+    if (ftruncate(file, (off_t) size))
+        return false;
+    length = size;
+    return map();
+}
+
+bool FileMapping::flush() {
+    if (!memory)
+        return file >= 0;
+    return !msync(memory, length, MS_SYNC);
+}
+
+void FileMapping::close() {
+    unmap();
+    if (file >= 0) {
+        ::close(file);
+        file = -1;
+    }
+    length = 0;
+}
+
+bool FileMapping::map() {
+    if (!length)
+        return true;
+    void *address = mmap(nullptr, length, writable ? PROT_READ|PROT_WRITE : PROT_READ, MAP_SHARED, file, 0);
+    if (address == MAP_FAILED)
+        return false;
+    memory = (byte *) address;
+    return true;
+}
+
+void FileMapping::unmap() {
+    if (memory) {
+        munmap(memory, length);
+        memory = nullptr;
+    }
+}
+
+#endif
+
+FileMapping::~FileMapping() {
+    close();
+}
+
+byte *FileMapping::data() const {
+    return memory;
+}
+
+size_t FileMapping::size() const {
+    return length;
+}
+
+}
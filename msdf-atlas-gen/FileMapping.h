@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include "types.h"
+
+namespace msdf_atlas {
+
+/// A file mapped into memory for reading and writing (or only reading), which can be resized
+class FileMapping {
+
+public:
+    FileMapping();
+    FileMapping(const FileMapping &) = delete;
+    FileMapping(FileMapping &&orig);
+    ~FileMapping();
+    FileMapping &operator=(const FileMapping &) = delete;
+    FileMapping &operator=(FileMapping &&orig);
+    /// Creates (or truncates) the file, sets its size and maps it into memory, returns false on failure
+    bool create(const char *filename, size_t size);
+    /// Maps an existing file into memory for reading only, returns false on failure. The mapped memory must not be modified
+    bool openReadOnly(const char *filename);
+    /// Changes the size of the file and maps it again - the mapped memory may move, its contents up to the smaller size are preserved
+    bool resize(size_t size);
+    /// Writes modified pages of the mapped memory to the file
+    bool flush();
+    /// Unmaps and closes the file
+    void close();
+    /// Returns the mapped memory, or nullptr if not mapped
+    byte *data() const;
+    /// Returns the size of the mapped file in bytes
+    size_t size() const;
+
+private:
+#ifdef _WIN32
+    void *file;
+    void *mapping;
+#else
+    int file;
+#endif
+    byte *memory;
+    size_t length;
+    bool writable;
+
+    bool map();
+    void unmap();
+
+};
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "types.h"
+
+namespace msdf_atlas {
+
+/**
+ * A hash map with 64-bit integer keys, which stores its entries in a single array and resolves collisions by linear probing.
+ * Entries cannot be removed individually. The key ~0 is reserved to mark empty slots.
+ */
+template <typename T>
+class FlatHashMap {
+
+public:
+    FlatHashMap();
+    /// Inserts the value under key unless already present, returns false if it was
+    bool insert(unsigned long long key, const T &value);
+    /// Inserts the value under key or replaces the existing one
+    void set(unsigned long long key, const T &value);
+    /// Returns the value stored under key, or null if not present
+    const T *find(unsigned long long key) const;
+    /// Makes room for at least count entries without rehashing
+    void reserve(size_t count);
+    /// Removes all entries
+    void clear();
+    /// Returns the number of entries
+    size_t size() const;
+    bool empty() const;
+
+private:
+    struct Slot {
+        unsigned long long key;
+        T value;
+    };
+
+    std::vector<Slot, Allocator<Slot>> slots;
+    size_t count;
+    int shift;
+
+    size_t slotIndex(unsigned long long key) const;
+    Slot *findSlot(unsigned long long key);
+    void rehash(size_t capacity);
+
+};
+
+}
+
+#include "FlatHashMap.hpp"
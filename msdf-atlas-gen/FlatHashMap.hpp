@@ -0,0 +1,108 @@
+
+#include "FlatHashMap.h"
+
+#define MSDF_ATLAS_HASH_MAP_EMPTY_KEY (~0ull)
+#define MSDF_ATLAS_HASH_MAP_MIN_CAPACITY 16
+
+namespace msdf_atlas {
+
+template <typename T>
+FlatHashMap<T>::FlatHashMap() : count(0), shift(64) { }
+
+template <typename T>
+size_t FlatHashMap<T>::slotIndex(unsigned long long key) const {
+    // Fibonacci hashing - the top bits of the product depend on all bits of the key
+    return (size_t) ((key*0x9e3779b97f4a7c15ull)>>shift);
+}
+
+template <typename T>
+typename FlatHashMap<T>::Slot *FlatHashMap<T>::findSlot(unsigned long long key) {
+    // The slot holding key, or the empty slot where it belongs. Capacity is kept at least twice the count, so there always is one
+    size_t mask = slots.size()-1;
+    for (size_t i = slotIndex(key);; i = (i+1)&mask) {
+        if (slots[i].key == key || slots[i].key == MSDF_ATLAS_HASH_MAP_EMPTY_KEY)
+            return &slots[i];
+    }
+}
+
+template <typename T>
+bool FlatHashMap<T>::insert(unsigned long long key, const T &value) {
+    if (2*(count+1) > slots.size())
+        rehash(2*slots.size());
+    Slot *slot = findSlot(key);
+    if (slot->key != MSDF_ATLAS_HASH_MAP_EMPTY_KEY)
+        return false;
+    slot->key = key;
+    slot->value = value;
+    ++count;
+    return true;
+}
+
+template <typename T>
+void FlatHashMap<T>::set(unsigned long long key, const T &value) {
+    if (2*(count+1) > slots.size())
+        rehash(2*slots.size());
+    Slot *slot = findSlot(key);
+    if (slot->key == MSDF_ATLAS_HASH_MAP_EMPTY_KEY) {
+        slot->key = key;
+        ++count;
+    }
+    slot->value = value;
+}
+
+template <typename T>
+const T *FlatHashMap<T>::find(unsigned long long key) const {
+    if (!count)
+        return nullptr;
+    size_t mask = slots.size()-1;
+    for (size_t i = slotIndex(key);; i = (i+1)&mask) {
+        if (slots[i].key == key)
+            return &slots[i].value;
+        if (slots[i].key == MSDF_ATLAS_HASH_MAP_EMPTY_KEY)
+            return nullptr;
+    }
+}
+
+template <typename T>
+void FlatHashMap<T>::reserve(size_t count) {
+    if (2*count > slots.size())
+        rehash(2*count);
+}
+
+template <typename T>
+void FlatHashMap<T>::clear() {
+    slots.clear();
+    count = 0;
+    shift = 64;
+}
+
+template <typename T>
+size_t FlatHashMap<T>::size() const {
+    return count;
+}
+
+template <typename T>
+bool FlatHashMap<T>::empty() const {
+    return !count;
+}
+
+template <typename T>
+void FlatHashMap<T>::rehash(size_t capacity) {
+    size_t newCapacity = MSDF_ATLAS_HASH_MAP_MIN_CAPACITY;
+    int newShift = 60;
+    while (newCapacity < capacity)
+        newCapacity <<= 1, --newShift;
+    if (newCapacity <= slots.size())
+        return;
+    std::vector<Slot, Allocator<Slot>> oldSlots(newCapacity);
+    oldSlots.swap(slots);
+    for (Slot &slot : slots)
+        slot.key = MSDF_ATLAS_HASH_MAP_EMPTY_KEY;
+    shift = newShift;
+    for (const Slot &slot : oldSlots) {
+        if (slot.key != MSDF_ATLAS_HASH_MAP_EMPTY_KEY)
+            *findSlot(slot.key) = slot;
+    }
+}
+
+}
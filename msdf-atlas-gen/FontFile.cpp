@@ -0,0 +1,67 @@
+
+#include "FontFile.h"
+
+#include <climits>
+
+namespace msdf_atlas {
+
+FontFile::Instance::Instance() : ft(nullptr), font(nullptr) { }
+
+FontFile::Instance::~Instance() {
+    close();
+}
+
+bool FontFile::Instance::open(const FontFile &fontFile) {
+    close();
+    if (!(fontFile.mapping.data() && fontFile.mapping.size() <= INT_MAX))
+        return false;
+    if (!(ft = msdfgen::initializeFreetype()))
+        return false;
+    // The face reads directly from the shared mapping, which must outlive the instance
+    if (!(font = msdfgen::loadFontData(ft, (const msdfgen::byte *) fontFile.mapping.data(), (int) fontFile.mapping.size()))) {
+        close();
+        return false;
+    }
+    #ifndef MSDFGEN_DISABLE_VARIABLE_FONTS
+        for (const VariationAxis &axis : fontFile.variationAxes)
+            msdfgen::setFontVariationAxis(ft, font, axis.name.c_str(), axis.coordinate);
+    #endif
+    return true;
+}
+
+void FontFile::Instance::close() {
+    if (font) {
+        msdfgen::destroyFont(font);
+        font = nullptr;
+    }
+    if (ft) {
+        msdfgen::deinitializeFreetype(ft);
+        ft = nullptr;
+    }
+}
+
+FontFile::Instance::operator msdfgen::FontHandle *() const {
+    return font;
+}
+
+FontFile::FontFile() { }
+
+bool FontFile::open(const char *filename) {
+    variationAxes.clear();
+    return mapping.openReadOnly(filename) && mapping.size();
+}
+
+void FontFile::setVariationAxis(const char *name, double coordinate) {
+    for (VariationAxis &axis : variationAxes) {
+        if (axis.name == name) {
+            axis.coordinate = coordinate;
+            return;
+        }
+    }
+    VariationAxis axis;
+    axis.name = name;
+    axis.coordinate = coordinate;
+    variationAxes.push_back((VariationAxis &&) axis);
+}
+
+}
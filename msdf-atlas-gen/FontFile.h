@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <msdfgen.h>
+#include <msdfgen-ext.h>
+#include "types.h"
+#include "FileMapping.h"
+
+namespace msdf_atlas {
+
+/**
+ * A font file mapped into memory, from which any number of independent FreeType instances of the font can be created.
+ * Since a FreeType face must not be used by multiple threads at once, this allows each thread to load glyphs from its own instance.
+ */
+class FontFile {
+
+public:
+    /// An instance of the font with its own FreeType library, which may only be used by one thread at a time
+    class Instance {
+    public:
+        Instance();
+        Instance(const Instance &) = delete;
+        ~Instance();
+        Instance &operator=(const Instance &) = delete;
+        /// Creates the instance from fontFile, returns false on failure
+        bool open(const FontFile &fontFile);
+        /// Destroys the instance
+        void close();
+        operator msdfgen::FontHandle *() const;
+    private:
+        msdfgen::FreetypeHandle *ft;
+        msdfgen::FontHandle *font;
+    };
+
+    FontFile();
+    FontFile(const FontFile &) = delete;
+    FontFile &operator=(const FontFile &) = delete;
+    /// Maps the font file into memory, returns false on failure
+    bool open(const char *filename);
+    /// Sets the coordinate of a variation axis to be applied to all instances created afterwards
+    void setVariationAxis(const char *name, double coordinate);
+
+private:
+    struct VariationAxis {
+        std::string name;
+        double coordinate;
+    };
+
+    FileMapping mapping;
+    std::vector<VariationAxis, Allocator<VariationAxis>> variationAxes;
+
+};
+
+}
@@ -1,10 +1,20 @@
 
 #include "FontGeometry.h"
 
+#include <algorithm>
+#include "ShapeCache.h"
+#include "FontFile.h"
+#include "kerning-tables.h"
+#include "Workload.h"
+
 #define DEFAULT_FONT_UNITS_PER_EM 2048.0
 
 namespace msdf_atlas {
 
+static unsigned long long kerningKey(int index1, int index2) {
+    return (unsigned long long) (unsigned) index1<<32|(unsigned) index2;
+}
+
 FontGeometry::GlyphRange::GlyphRange() : glyphs(), rangeStart(), rangeEnd() { }
 
 FontGeometry::GlyphRange::GlyphRange(const std::vector<GlyphGeometry, Allocator<GlyphGeometry>> *glyphs, size_t rangeStart, size_t rangeEnd) : glyphs(glyphs), rangeStart(rangeStart), rangeEnd(rangeEnd) { }
@@ -33,7 +43,7 @@ FontGeometry::FontGeometry(std::vector<GlyphGeometry, Allocator<GlyphGeometry>>
     rangeEnd = glyphs->size();
 }
 
-FontGeometry::FontGeometry(FontGeometry &&orig) : geometryScale(orig.geometryScale), metrics(orig.metrics), preferredIdentifierType(orig.preferredIdentifierType), glyphs(orig.glyphs), rangeStart(orig.rangeStart), rangeEnd(orig.rangeEnd), glyphsByIndex(std::move(orig.glyphsByIndex)), glyphsByCodepoint(std::move(orig.glyphsByCodepoint)), kerning(std::move(orig.kerning)), ownGlyphs(std::move(orig.ownGlyphs)), name(std::move(orig.name)) {
+FontGeometry::FontGeometry(FontGeometry &&orig) : geometryScale(orig.geometryScale), metrics(orig.metrics), preferredIdentifierType(orig.preferredIdentifierType), glyphs(orig.glyphs), rangeStart(orig.rangeStart), rangeEnd(orig.rangeEnd), glyphsByIndex(std::move(orig.glyphsByIndex)), glyphsByCodepoint(std::move(orig.glyphsByCodepoint)), kerning(std::move(orig.kerning)), kerningByPair(std::move(orig.kerningByPair)), ownGlyphs(std::move(orig.ownGlyphs)), name(std::move(orig.name)) {
     if (glyphs == &orig.ownGlyphs)
         glyphs = &ownGlyphs;
 }
@@ -48,20 +58,21 @@ FontGeometry &FontGeometry::operator=(FontGeometry &&orig) {
         glyphsByIndex = std::move(orig.glyphsByIndex);
         glyphsByCodepoint = std::move(orig.glyphsByCodepoint);
         kerning = std::move(orig.kerning);
+        kerningByPair = std::move(orig.kerningByPair);
         ownGlyphs = std::move(orig.ownGlyphs);
         name = std::move(orig.name);
     }
     return *this;
 }
 
-int FontGeometry::loadGlyphRange(msdfgen::FontHandle *font, double fontScale, unsigned rangeStart, unsigned rangeEnd, bool preprocessGeometry, bool enableKerning) {
+int FontGeometry::loadGlyphRange(msdfgen::FontHandle *font, double fontScale, unsigned rangeStart, unsigned rangeEnd, bool preprocessGeometry, bool enableKerning, ShapeCache *shapeCache) {
     if (!(glyphs->size() == this->rangeEnd && loadMetrics(font, fontScale)))
         return -1;
     glyphs->reserve(glyphs->size()+(rangeEnd-rangeStart));
     int loaded = 0;
     for (unsigned index = rangeStart; index < rangeEnd; ++index) {
         GlyphGeometry glyph;
-        if (glyph.load(font, geometryScale, msdfgen::GlyphIndex(index), preprocessGeometry)) {
+        if (shapeCache ? shapeCache->loadGlyph(glyph, font, geometryScale, msdfgen::GlyphIndex(index)) : glyph.load(font, geometryScale, msdfgen::GlyphIndex(index), preprocessGeometry)) {
             addGlyph((GlyphGeometry &&) glyph);
             ++loaded;
         }
@@ -72,14 +83,14 @@ int FontGeometry::loadGlyphRange(msdfgen::FontHandle *font, double fontScale, un
     return loaded;
 }
 
-int FontGeometry::loadGlyphset(msdfgen::FontHandle *font, double fontScale, const Charset &glyphset, bool preprocessGeometry, bool enableKerning) {
+int FontGeometry::loadGlyphset(msdfgen::FontHandle *font, double fontScale, const Charset &glyphset, bool preprocessGeometry, bool enableKerning, ShapeCache *shapeCache) {
     if (!(glyphs->size() == rangeEnd && loadMetrics(font, fontScale)))
         return -1;
     glyphs->reserve(glyphs->size()+glyphset.size());
     int loaded = 0;
     for (unicode_t index : glyphset) {
         GlyphGeometry glyph;
-        if (glyph.load(font, geometryScale, msdfgen::GlyphIndex(index), preprocessGeometry)) {
+        if (shapeCache ? shapeCache->loadGlyph(glyph, font, geometryScale, msdfgen::GlyphIndex(index)) : glyph.load(font, geometryScale, msdfgen::GlyphIndex(index), preprocessGeometry)) {
             addGlyph((GlyphGeometry &&) glyph);
             ++loaded;
         }
@@ -90,14 +101,14 @@ int FontGeometry::loadGlyphset(msdfgen::FontHandle *font, double fontScale, cons
     return loaded;
 }
 
-int FontGeometry::loadCharset(msdfgen::FontHandle *font, double fontScale, const Charset &charset, bool preprocessGeometry, bool enableKerning) {
+int FontGeometry::loadCharset(msdfgen::FontHandle *font, double fontScale, const Charset &charset, bool preprocessGeometry, bool enableKerning, ShapeCache *shapeCache) {
     if (!(glyphs->size() == rangeEnd && loadMetrics(font, fontScale)))
         return -1;
     glyphs->reserve(glyphs->size()+charset.size());
     int loaded = 0;
     for (unicode_t cp : charset) {
         GlyphGeometry glyph;
-        if (glyph.load(font, geometryScale, cp, preprocessGeometry)) {
+        if (shapeCache ? shapeCache->loadGlyph(glyph, font, geometryScale, cp) : glyph.load(font, geometryScale, cp, preprocessGeometry)) {
             addGlyph((GlyphGeometry &&) glyph);
             ++loaded;
         }
@@ -108,6 +119,59 @@ int FontGeometry::loadCharset(msdfgen::FontHandle *font, double fontScale, const
     return loaded;
 }
 
+int FontGeometry::loadGlyphRange(const FontFile &fontFile, double fontScale, unsigned rangeStart, unsigned rangeEnd, int threadCount, bool preprocessGeometry, bool enableKerning, ShapeCache *shapeCache) {
+    std::vector<unicode_t, Allocator<unicode_t>> indices;
+    indices.reserve(rangeEnd > rangeStart ? rangeEnd-rangeStart : 0);
+    for (unsigned index = rangeStart; index < rangeEnd; ++index)
+        indices.push_back(index);
+    return loadGlyphs(fontFile, fontScale, indices.data(), indices.size(), true, threadCount, preprocessGeometry, enableKerning, shapeCache);
+}
+
+int FontGeometry::loadGlyphset(const FontFile &fontFile, double fontScale, const Charset &glyphset, int threadCount, bool preprocessGeometry, bool enableKerning, ShapeCache *shapeCache) {
+    std::vector<unicode_t, Allocator<unicode_t>> indices(glyphset.begin(), glyphset.end());
+    return loadGlyphs(fontFile, fontScale, indices.data(), indices.size(), true, threadCount, preprocessGeometry, enableKerning, shapeCache);
+}
+
+int FontGeometry::loadCharset(const FontFile &fontFile, double fontScale, const Charset &charset, int threadCount, bool preprocessGeometry, bool enableKerning, ShapeCache *shapeCache) {
+    std::vector<unicode_t, Allocator<unicode_t>> codepoints(charset.begin(), charset.end());
+    return loadGlyphs(fontFile, fontScale, codepoints.data(), codepoints.size(), false, threadCount, preprocessGeometry, enableKerning, shapeCache);
+}
+
+int FontGeometry::loadGlyphs(const FontFile &fontFile, double fontScale, const unicode_t *identifiers, size_t count, bool glyphIndices, int threadCount, bool preprocessGeometry, bool enableKerning, ShapeCache *shapeCache) {
+    threadCount = std::max(std::min(threadCount, (int) count), 1);
+    // Each thread loads glyphs from its own instance, the first one is also used for metrics and kerning
+    std::vector<FontFile::Instance, Allocator<FontFile::Instance>> instances(threadCount);
+    if (!(glyphs->size() == rangeEnd && instances[0].open(fontFile) && loadMetrics(instances[0], fontScale)))
+        return -1;
+    std::vector<GlyphGeometry, Allocator<GlyphGeometry>> loadedGlyphs(count);
+    std::vector<byte, Allocator<byte>> glyphLoaded(count);
+    if (!Workload([&](int i, int threadNo) -> bool {
+        FontFile::Instance &instance = instances[threadNo];
+        if (!instance && !instance.open(fontFile))
+            return false;
+        GlyphGeometry &glyph = loadedGlyphs[i];
+        if (glyphIndices)
+            glyphLoaded[i] = shapeCache ? shapeCache->loadGlyph(glyph, instance, geometryScale, msdfgen::GlyphIndex(identifiers[i])) : glyph.load(instance, geometryScale, msdfgen::GlyphIndex(identifiers[i]), preprocessGeometry);
+        else
+            glyphLoaded[i] = shapeCache ? shapeCache->loadGlyph(glyph, instance, geometryScale, identifiers[i]) : glyph.load(instance, geometryScale, identifiers[i], preprocessGeometry);
+        return true;
+    }, (int) count).finish(threadCount))
+        return -1;
+    // Glyphs are added in the original order regardless of which thread loaded them
+    glyphs->reserve(glyphs->size()+count);
+    int loaded = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (glyphLoaded[i]) {
+            addGlyph((GlyphGeometry &&) loadedGlyphs[i]);
+            ++loaded;
+        }
+    }
+    if (enableKerning)
+        loadKerning(instances[0]);
+    preferredIdentifierType = glyphIndices ? GlyphIdentifierType::GLYPH_INDEX : GlyphIdentifierType::UNICODE_CODEPOINT;
+    return loaded;
+}
+
 bool FontGeometry::loadMetrics(msdfgen::FontHandle *font, double fontScale) {
     if (!msdfgen::getFontMetrics(metrics, font, msdfgen::FONT_SCALING_NONE))
         return false;
@@ -126,9 +190,9 @@ bool FontGeometry::loadMetrics(msdfgen::FontHandle *font, double fontScale) {
 bool FontGeometry::addGlyph(const GlyphGeometry &glyph) {
     if (glyphs->size() != rangeEnd)
         return false;
-    glyphsByIndex.insert(std::make_pair(glyph.getIndex(), rangeEnd));
+    glyphsByIndex.insert((unsigned) glyph.getIndex(), rangeEnd);
     if (glyph.getCodepoint())
-        glyphsByCodepoint.insert(std::make_pair(glyph.getCodepoint(), rangeEnd));
+        glyphsByCodepoint.insert(glyph.getCodepoint(), rangeEnd);
     glyphs->push_back(glyph);
     ++rangeEnd;
     return true;
@@ -137,21 +201,35 @@ bool FontGeometry::addGlyph(const GlyphGeometry &glyph) {
 bool FontGeometry::addGlyph(GlyphGeometry &&glyph) {
     if (glyphs->size() != rangeEnd)
         return false;
-    glyphsByIndex.insert(std::make_pair(glyph.getIndex(), rangeEnd));
+    glyphsByIndex.insert((unsigned) glyph.getIndex(), rangeEnd);
     if (glyph.getCodepoint())
-        glyphsByCodepoint.insert(std::make_pair(glyph.getCodepoint(), rangeEnd));
+        glyphsByCodepoint.insert(glyph.getCodepoint(), rangeEnd);
     glyphs->push_back((GlyphGeometry &&) glyph);
     ++rangeEnd;
     return true;
 }
 
 int FontGeometry::loadKerning(msdfgen::FontHandle *font) {
+    std::vector<int, Allocator<int>> glyphIndices;
+    glyphIndices.reserve(rangeEnd-rangeStart);
+    for (size_t i = rangeStart; i < rangeEnd; ++i)
+        glyphIndices.push_back((*glyphs)[i].getIndex());
+    std::map<std::pair<int, int>, double, std::less<std::pair<int, int>>, Allocator<std::pair<const std::pair<int, int>, double>>> fontKerning;
+    if (readKerningTables(fontKerning, font, glyphIndices.data(), (int) glyphIndices.size())) {
+        for (const std::pair<const std::pair<int, int>, double> &elem : fontKerning) {
+            kerning[elem.first] = geometryScale*elem.second;
+            kerningByPair.set(kerningKey(elem.first.first, elem.first.second), geometryScale*elem.second);
+        }
+        return (int) fontKerning.size();
+    }
+    // Other than SFNT fonts have to be queried for each pair
     int loaded = 0;
     for (size_t i = rangeStart; i < rangeEnd; ++i)
         for (size_t j = rangeStart; j < rangeEnd; ++j) {
             double advance;
             if (msdfgen::getKerning(advance, font, (*glyphs)[i].getGlyphIndex(), (*glyphs)[j].getGlyphIndex(), msdfgen::FONT_SCALING_NONE) && advance) {
                 kerning[std::make_pair<int, int>((*glyphs)[i].getIndex(), (*glyphs)[j].getIndex())] = geometryScale*advance;
+                kerningByPair.set(kerningKey((*glyphs)[i].getIndex(), (*glyphs)[j].getIndex()), geometryScale*advance);
                 ++loaded;
             }
         }
@@ -182,16 +260,14 @@ FontGeometry::GlyphRange FontGeometry::getGlyphs() const {
 }
 
 const GlyphGeometry *FontGeometry::getGlyph(msdfgen::GlyphIndex index) const {
-    auto it = glyphsByIndex.find(index.getIndex());
-    if (it != glyphsByIndex.end())
-        return &(*glyphs)[it->second];
+    if (const size_t *position = glyphsByIndex.find((unsigned) index.getIndex()))
+        return &(*glyphs)[*position];
     return nullptr;
 }
 
 const GlyphGeometry *FontGeometry::getGlyph(unicode_t codepoint) const {
-    auto it = glyphsByCodepoint.find(codepoint);
-    if (it != glyphsByCodepoint.end())
-        return &(*glyphs)[it->second];
+    if (const size_t *position = glyphsByCodepoint.find(codepoint))
+        return &(*glyphs)[*position];
     return nullptr;
 }
 
@@ -200,9 +276,8 @@ bool FontGeometry::getAdvance(double &advance, msdfgen::GlyphIndex index1, msdfg
     if (!glyph1)
         return false;
     advance = glyph1->getAdvance();
-    auto it = kerning.find(std::make_pair<int, int>(index1.getIndex(), index2.getIndex()));
-    if (it != kerning.end())
-        advance += it->second;
+    if (const double *kern = kerningByPair.find(kerningKey(index1.getIndex(), index2.getIndex())))
+        advance += *kern;
     return true;
 }
 
@@ -211,12 +286,49 @@ bool FontGeometry::getAdvance(double &advance, unicode_t codepoint1, unicode_t c
     if (!((glyph1 = getGlyph(codepoint1)) && (glyph2 = getGlyph(codepoint2))))
         return false;
     advance = glyph1->getAdvance();
-    auto it = kerning.find(std::make_pair<int, int>(glyph1->getIndex(), glyph2->getIndex()));
-    if (it != kerning.end())
-        advance += it->second;
+    if (const double *kern = kerningByPair.find(kerningKey(glyph1->getIndex(), glyph2->getIndex())))
+        advance += *kern;
     return true;
 }
 
+bool FontGeometry::getAdvances(const msdfgen::GlyphIndex *indices, int count, double *advances) const {
+    bool success = true;
+    for (int i = 0; i < count; ++i) {
+        if (const GlyphGeometry *glyph = getGlyph(indices[i])) {
+            advances[i] = glyph->getAdvance();
+            if (i+1 < count) {
+                if (const double *kern = kerningByPair.find(kerningKey(indices[i].getIndex(), indices[i+1].getIndex())))
+                    advances[i] += *kern;
+            }
+        } else {
+            advances[i] = 0;
+            success = false;
+        }
+    }
+    return success;
+}
+
+bool FontGeometry::getAdvances(const unicode_t *codepoints, int count, double *advances) const {
+    bool success = true;
+    // Each glyph is looked up only once, as the second glyph of a pair it becomes the first of the next one
+    const GlyphGeometry *nextGlyph = count > 0 ? getGlyph(codepoints[0]) : nullptr;
+    for (int i = 0; i < count; ++i) {
+        const GlyphGeometry *glyph = nextGlyph;
+        nextGlyph = i+1 < count ? getGlyph(codepoints[i+1]) : nullptr;
+        if (glyph) {
+            advances[i] = glyph->getAdvance();
+            if (nextGlyph) {
+                if (const double *kern = kerningByPair.find(kerningKey(glyph->getIndex(), nextGlyph->getIndex())))
+                    advances[i] += *kern;
+            }
+        } else {
+            advances[i] = 0;
+            success = false;
+        }
+    }
+    return success;
+}
+
 const std::map<std::pair<int, int>, double, std::less<std::pair<int, int>>, Allocator<std::pair<const std::pair<int, int>, double>>>& FontGeometry::getKerning() const {
     return kerning;
 }
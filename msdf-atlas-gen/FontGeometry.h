@@ -10,9 +10,13 @@
 #include "types.h"
 #include "GlyphGeometry.h"
 #include "Charset.h"
+#include "FlatHashMap.h"
 
 namespace msdf_atlas {
 
+class ShapeCache;
+class FontFile;
+
 /// Represents the geometry of all glyphs of a given font or font variant
 class FontGeometry {
 
@@ -36,18 +40,24 @@ public:
     FontGeometry &operator=(FontGeometry &&orig);
 
     /// Loads the consecutive range of glyphs between rangeStart (inclusive) and rangeEnd (exclusive), returns the number of successfully loaded glyphs
-    int loadGlyphRange(msdfgen::FontHandle *font, double fontScale, unsigned rangeStart, unsigned rangeEnd, bool preprocessGeometry = true, bool enableKerning = true);
+    int loadGlyphRange(msdfgen::FontHandle *font, double fontScale, unsigned rangeStart, unsigned rangeEnd, bool preprocessGeometry = true, bool enableKerning = true, ShapeCache *shapeCache = nullptr);
     /// Loads all glyphs in a glyphset (Charset elements are glyph indices), returns the number of successfully loaded glyphs
-    int loadGlyphset(msdfgen::FontHandle *font, double fontScale, const Charset &glyphset, bool preprocessGeometry = true, bool enableKerning = true);
+    int loadGlyphset(msdfgen::FontHandle *font, double fontScale, const Charset &glyphset, bool preprocessGeometry = true, bool enableKerning = true, ShapeCache *shapeCache = nullptr);
     /// Loads all glyphs in a charset (Charset elements are Unicode codepoints), returns the number of successfully loaded glyphs
-    int loadCharset(msdfgen::FontHandle *font, double fontScale, const Charset &charset, bool preprocessGeometry = true, bool enableKerning = true);
+    /// If shapeCache is provided, glyph shapes are looked up in (and added to) it instead of always being loaded from font
+    int loadCharset(msdfgen::FontHandle *font, double fontScale, const Charset &charset, bool preprocessGeometry = true, bool enableKerning = true, ShapeCache *shapeCache = nullptr);
+    /// Same as above, but glyphs are loaded and preprocessed by threadCount threads, each with its own instance of fontFile
+    /// The result is identical to loading the glyphs sequentially
+    int loadGlyphRange(const FontFile &fontFile, double fontScale, unsigned rangeStart, unsigned rangeEnd, int threadCount, bool preprocessGeometry = true, bool enableKerning = true, ShapeCache *shapeCache = nullptr);
+    int loadGlyphset(const FontFile &fontFile, double fontScale, const Charset &glyphset, int threadCount, bool preprocessGeometry = true, bool enableKerning = true, ShapeCache *shapeCache = nullptr);
+    int loadCharset(const FontFile &fontFile, double fontScale, const Charset &charset, int threadCount, bool preprocessGeometry = true, bool enableKerning = true, ShapeCache *shapeCache = nullptr);
 
     /// Only loads font metrics and geometry scale from font
     bool loadMetrics(msdfgen::FontHandle *font, double fontScale);
     /// Adds a loaded glyph
     bool addGlyph(const GlyphGeometry &glyph);
     bool addGlyph(GlyphGeometry &&glyph);
-    /// Loads kerning pairs for all glyphs that are currently present, returns the number of loaded kerning pairs
+    /// Loads kerning pairs for all glyphs that are currently present from the font's GPOS or kern table if available, returns the number of loaded kerning pairs
     int loadKerning(msdfgen::FontHandle *font);
     /// Sets a name to be associated with the font
     void setName(const char *name);
@@ -66,6 +76,10 @@ public:
     /// Outputs the advance between two glyphs with kerning taken into consideration, returns false on failure
     bool getAdvance(double &advance, msdfgen::GlyphIndex index1, msdfgen::GlyphIndex index2) const;
     bool getAdvance(double &advance, unicode_t codepoint1, unicode_t codepoint2) const;
+    /// Outputs the advance of each glyph in a sequence of count glyphs, with kerning with the following glyph taken into consideration
+    /// Returns false if any of the glyphs was not found, in which case its advance is set to zero
+    bool getAdvances(const msdfgen::GlyphIndex *indices, int count, double *advances) const;
+    bool getAdvances(const unicode_t *codepoints, int count, double *advances) const;
     /// Returns the complete mapping of kerning pairs (by glyph indices) and their respective advance values
     const std::map<std::pair<int, int>, double, std::less<std::pair<int, int>>, Allocator<std::pair<const std::pair<int, int>, double>>> &getKerning() const;
     /// Returns the name associated with the font or null if not set
@@ -77,12 +91,16 @@ private:
     GlyphIdentifierType preferredIdentifierType;
     std::vector<GlyphGeometry, Allocator<GlyphGeometry>> *glyphs;
     size_t rangeStart, rangeEnd;
-    std::map<int, size_t, std::less<int>, Allocator<std::pair<const int, size_t>>> glyphsByIndex;
-    std::map<unicode_t, size_t, std::less<unicode_t>, Allocator<std::pair<const unicode_t, size_t>>> glyphsByCodepoint;
+    FlatHashMap<size_t> glyphsByIndex;
+    FlatHashMap<size_t> glyphsByCodepoint;
     std::map<std::pair<int, int>, double, std::less<std::pair<int, int>>, Allocator<std::pair<const std::pair<int, int>, double>>> kerning;
+    /// Same as kerning, for fast lookup by kerningKey
+    FlatHashMap<double> kerningByPair;
     std::vector<GlyphGeometry, Allocator<GlyphGeometry>> ownGlyphs;
     std::string name;
 
+    int loadGlyphs(const FontFile &fontFile, double fontScale, const unicode_t *identifiers, size_t count, bool glyphIndices, int threadCount, bool preprocessGeometry, bool enableKerning, ShapeCache *shapeCache);
+
     FontGeometry(const FontGeometry &);
     FontGeometry &operator=(const FontGeometry &);
 
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include "RectanglePacker.h"
+#include "AtlasGenerator.h"
+
+namespace msdf_atlas {
+
+/**
+ * This class can be used to maintain a fixed-size atlas as a cache of glyphs, e.g. for displaying arbitrary text at runtime.
+ * Each glyph is identified by a key chosen by the caller and has a usage stamp, which is refreshed by use.
+ * When a new glyph doesn't fit, the least recently used glyphs are evicted and their space is reclaimed,
+ * except for glyphs used since the last call to advanceStamp. The actual work is delegated to the specified AtlasGenerator.
+ * If the generator queues glyphs (AsyncAtlasGenerator), queued glyphs in reclaimed space are cancelled.
+ */
+template <class AtlasGenerator>
+class GlyphCacheAtlas {
+
+public:
+    enum ChangeFlag {
+        NO_CHANGE = 0x00,
+        /// Some glyphs have been evicted (see getEvictedKeys) and their quads must not be used anymore
+        EVICTED = 0x04,
+        /// Some glyphs didn't fit even after evicting all glyphs not used since the last call to advanceStamp
+        INCOMPLETE = 0x08
+    };
+    typedef int ChangeFlags;
+
+    GlyphCacheAtlas();
+    /// Initializes generator with fixed dimensions and custom arguments for generator
+    template <typename... ARGS>
+    GlyphCacheAtlas(int width, int height, ARGS... args);
+    /// Creates with a configured generator with the given dimensions. The generator must not contain any prior glyphs!
+    GlyphCacheAtlas(int width, int height, AtlasGenerator &&generator);
+    /// Adds a batch of glyphs identified by keys - a glyph whose key is already in the cache (or appears again later in the batch) replaces it. Whitespace glyphs are skipped
+    ChangeFlags add(const int *keys, GlyphGeometry *glyphs, int count);
+    /// Refreshes the usage stamp of a cached glyph, returns false if it is not in the cache
+    bool use(int key);
+    /// Returns true if the glyph is in the cache
+    bool contains(int key) const;
+    /// Outputs the cached glyph's box rectangle in the atlas, returns false if it is not in the cache
+    bool getBoxRect(int key, Rectangle &rect) const;
+    /// Advances the usage stamp (e.g. once per frame), which allows glyphs used so far to be evicted
+    void advanceStamp();
+    /// Returns the keys of glyphs evicted during the last call to add, including replaced glyphs whose new version did not fit
+    const std::vector<int, Allocator<int>> &getEvictedKeys() const;
+    /// Returns the number of cached glyphs
+    int getGlyphCount() const;
+    /// Allows access to generator. Do not add glyphs to the generator directly!
+    AtlasGenerator &atlasGenerator();
+    const AtlasGenerator &atlasGenerator() const;
+
+private:
+    struct Entry {
+        Rectangle rect;
+        unsigned long long stamp;
+    };
+
+    int width, height;
+    int spacing;
+    unsigned long long stamp;
+    RectanglePacker packer;
+    AtlasGenerator generator;
+    std::map<int, Entry, std::less<int>, Allocator<std::pair<const int, Entry>>> entries;
+    std::vector<int, Allocator<int>> evictedKeys;
+    std::vector<Rectangle, Allocator<Rectangle>> rectangles;
+    std::vector<int, Allocator<int>> pending;
+
+};
+
+}
+
+#include "GlyphCacheAtlas.hpp"
@@ -0,0 +1,195 @@
+
+#include "GlyphCacheAtlas.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace msdf_atlas {
+
+/// Discards the generator's own record of the layout (if it keeps one), which is superseded by the cache's entries
+template <class AtlasGenerator>
+static auto discardGeneratorLayout(AtlasGenerator &generator, int) -> decltype(generator.clearLayout()) {
+    return generator.clearLayout();
+}
+
+template <class AtlasGenerator>
+static void discardGeneratorLayout(AtlasGenerator &, long) { }
+
+/// Makes the generator drop glyphs still queued in a rectangle which is being reclaimed (if it generates asynchronously), so that they can't overwrite its new glyphs
+template <class AtlasGenerator>
+static auto cancelGeneratorRectangle(AtlasGenerator &generator, const Rectangle &rect, int) -> decltype(generator.cancel(rect, 0), void()) {
+    generator.cancel(rect, 0);
+}
+
+template <class AtlasGenerator>
+static void cancelGeneratorRectangle(AtlasGenerator &, const Rectangle &, long) { }
+
+template <class AtlasGenerator>
+GlyphCacheAtlas<AtlasGenerator>::GlyphCacheAtlas() : width(0), height(0), spacing(0), stamp(0) { }
+
+template <class AtlasGenerator>
+template <typename... ARGS>
+GlyphCacheAtlas<AtlasGenerator>::GlyphCacheAtlas(int width, int height, ARGS... args) : width(width), height(height), spacing(0), stamp(0), packer(width+spacing, height+spacing), generator(width, height, args...) { }
+
+template <class AtlasGenerator>
+GlyphCacheAtlas<AtlasGenerator>::GlyphCacheAtlas(int width, int height, AtlasGenerator &&generator) : width(width), height(height), spacing(0), stamp(0), packer(width+spacing, height+spacing), generator((AtlasGenerator &&) generator) { }
+
+template <class AtlasGenerator>
+typename GlyphCacheAtlas<AtlasGenerator>::ChangeFlags GlyphCacheAtlas<AtlasGenerator>::add(const int *keys, GlyphGeometry *glyphs, int count) {
+    ChangeFlags changeFlags = NO_CHANGE;
+    evictedKeys.clear();
+    rectangles.resize(count);
+    pending.clear();
+    std::vector<int, Allocator<int>> replaced;
+    // Only the last glyph of each key in the batch is added, earlier ones are marked by a negative width and skipped
+    std::vector<std::pair<int, int>, Allocator<std::pair<int, int>>> keyOrder;
+    keyOrder.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Rectangle rect = { -1, -1, 0, 0 };
+        rectangles[i] = rect;
+        if (!glyphs[i].isWhitespace())
+            keyOrder.push_back(std::make_pair(keys[i], i));
+    }
+    std::sort(keyOrder.begin(), keyOrder.end());
+    for (size_t j = 1; j < keyOrder.size(); ++j) {
+        if (keyOrder[j].first == keyOrder[j-1].first)
+            rectangles[keyOrder[j-1].second].w = -1;
+    }
+    for (int i = 0; i < count; ++i) {
+        if (!glyphs[i].isWhitespace() && rectangles[i].w >= 0) {
+            // A glyph with a key that is already cached replaces it
+            typename decltype(entries)::iterator it = entries.find(keys[i]);
+            if (it != entries.end()) {
+                packer.free(it->second.rect);
+                cancelGeneratorRectangle(generator, it->second.rect, 0);
+                entries.erase(it);
+                replaced.push_back(i);
+            }
+            int w, h;
+            glyphs[i].getBoxSize(w, h);
+            Rectangle rect = { -1, -1, w+spacing, h+spacing };
+            rectangles[i] = rect;
+            pending.push_back(i);
+        }
+    }
+    // Pack pending glyphs and evict least recently used glyphs until they all fit
+    std::vector<Rectangle, Allocator<Rectangle>> batch;
+    std::vector<std::pair<unsigned long long, int>, Allocator<std::pair<unsigned long long, int>>> evictionOrder;
+    bool evictionOrderReady = false;
+    size_t evictionPos = 0;
+    while (!pending.empty()) {
+        batch.resize(pending.size());
+        for (size_t i = 0; i < pending.size(); ++i)
+            batch[i] = rectangles[pending[i]];
+        packer.pack(batch.data(), (int) batch.size());
+        size_t remaining = 0;
+        long long requiredArea = 0;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            if (batch[i].x >= 0)
+                rectangles[pending[i]] = batch[i];
+            else {
+                requiredArea += (long long) batch[i].w*batch[i].h;
+                pending[remaining++] = pending[i];
+            }
+        }
+        pending.resize(remaining);
+        if (pending.empty())
+            break;
+        if (!evictionOrderReady) {
+            for (const std::pair<const int, Entry> &entry : entries) {
+                if (entry.second.stamp < stamp)
+                    evictionOrder.push_back(std::make_pair(entry.second.stamp, entry.first));
+            }
+            std::sort(evictionOrder.begin(), evictionOrder.end());
+            evictionOrderReady = true;
+        }
+        if (evictionPos >= evictionOrder.size()) {
+            changeFlags |= INCOMPLETE;
+            break;
+        }
+        for (long long freedArea = 0; evictionPos < evictionOrder.size() && freedArea < requiredArea; ++evictionPos) {
+            typename decltype(entries)::iterator it = entries.find(evictionOrder[evictionPos].second);
+            packer.free(it->second.rect);
+            cancelGeneratorRectangle(generator, it->second.rect, 0);
+            freedArea += (long long) it->second.rect.w*it->second.rect.h;
+            evictedKeys.push_back(it->first);
+            entries.erase(it);
+        }
+        changeFlags |= EVICTED;
+    }
+    for (int i = 0; i < count; ++i) {
+        if (!glyphs[i].isWhitespace() && rectangles[i].x >= 0) {
+            Entry entry = { rectangles[i], stamp };
+            entries[keys[i]] = entry;
+            glyphs[i].placeBox(rectangles[i].x, rectangles[i].y, 0);
+        }
+    }
+    // A replaced glyph whose new version didn't fit is no longer cached either
+    for (int i : replaced) {
+        if (rectangles[i].x < 0) {
+            evictedKeys.push_back(keys[i]);
+            changeFlags |= EVICTED;
+        }
+    }
+    // Generate contiguous runs of glyphs that have been placed
+    for (int start = 0, i = 0; i <= count; ++i) {
+        if (i == count || (!glyphs[i].isWhitespace() && rectangles[i].x < 0)) {
+            if (i > start)
+                generator.generate(glyphs+start, i-start);
+            start = i+1;
+        }
+    }
+    discardGeneratorLayout(generator, 0);
+    return changeFlags;
+}
+
+template <class AtlasGenerator>
+bool GlyphCacheAtlas<AtlasGenerator>::use(int key) {
+    typename decltype(entries)::iterator it = entries.find(key);
+    if (it == entries.end())
+        return false;
+    it->second.stamp = stamp;
+    return true;
+}
+
+template <class AtlasGenerator>
+bool GlyphCacheAtlas<AtlasGenerator>::contains(int key) const {
+    return entries.find(key) != entries.end();
+}
+
+template <class AtlasGenerator>
+bool GlyphCacheAtlas<AtlasGenerator>::getBoxRect(int key, Rectangle &rect) const {
+    typename decltype(entries)::const_iterator it = entries.find(key);
+    if (it == entries.end())
+        return false;
+    rect = it->second.rect;
+    rect.w -= spacing, rect.h -= spacing;
+    return true;
+}
+
+template <class AtlasGenerator>
+void GlyphCacheAtlas<AtlasGenerator>::advanceStamp() {
+    ++stamp;
+}
+
+template <class AtlasGenerator>
+const std::vector<int, Allocator<int>> &GlyphCacheAtlas<AtlasGenerator>::getEvictedKeys() const {
+    return evictedKeys;
+}
+
+template <class AtlasGenerator>
+int GlyphCacheAtlas<AtlasGenerator>::getGlyphCount() const {
+    return (int) entries.size();
+}
+
+template <class AtlasGenerator>
+AtlasGenerator &GlyphCacheAtlas<AtlasGenerator>::atlasGenerator() {
+    return generator;
+}
+
+template <class AtlasGenerator>
+const AtlasGenerator &GlyphCacheAtlas<AtlasGenerator>::atlasGenerator() const {
+    return generator;
+}
+
+}
@@ -14,23 +14,7 @@ bool GlyphGeometry::load(msdfgen::FontHandle *font, double geometryScale, msdfge
         this->geometryScale = geometryScale;
         codepoint = 0;
         advance *= geometryScale;
-        #ifdef MSDFGEN_USE_SKIA
-            if (preprocessGeometry)
-                msdfgen::resolveShapeGeometry(shape);
-        #endif
-        shape.normalize();
-        bounds = shape.getBounds();
-        #ifdef MSDFGEN_USE_SKIA
-            if (!preprocessGeometry)
-        #endif
-        {
-            // Determine if shape is winded incorrectly and reverse it in that case
-            msdfgen::Point2 outerPoint(bounds.l-(bounds.r-bounds.l)-1, bounds.b-(bounds.t-bounds.b)-1);
-            if (msdfgen::SimpleTrueShapeDistanceFinder::oneShotDistance(shape, outerPoint) > 0) {
-                for (msdfgen::Contour &contour : shape.contours)
-                    contour.reverse();
-            }
-        }
+        prepareShape(preprocessGeometry);
         return true;
     }
     return false;
@@ -47,16 +31,76 @@ bool GlyphGeometry::load(msdfgen::FontHandle *font, double geometryScale, unicod
     return false;
 }
 
+bool GlyphGeometry::load(const msdfgen::Shape &shape, double geometryScale, msdfgen::GlyphIndex index, unicode_t codepoint, double advance, bool preprocessGeometry) {
+    if (shape.validate()) {
+        this->index = index.getIndex();
+        this->codepoint = codepoint;
+        this->geometryScale = geometryScale;
+        this->shape = shape;
+        this->advance = geometryScale*advance;
+        prepareShape(preprocessGeometry);
+        return true;
+    }
+    return false;
+}
+
+bool GlyphGeometry::loadPreprocessed(const msdfgen::Shape &shape, double geometryScale, msdfgen::GlyphIndex index, unicode_t codepoint, double advance) {
+    if (shape.validate()) {
+        this->index = index.getIndex();
+        this->codepoint = codepoint;
+        this->geometryScale = geometryScale;
+        this->shape = shape;
+        this->advance = geometryScale*advance;
+        bounds = this->shape.getBounds();
+        return true;
+    }
+    return false;
+}
+
+void GlyphGeometry::prepareShape(bool preprocessGeometry) {
+    #ifdef MSDFGEN_USE_SKIA
+        if (preprocessGeometry)
+            msdfgen::resolveShapeGeometry(shape);
+    #endif
+    shape.normalize();
+    bounds = shape.getBounds();
+    #ifdef MSDFGEN_USE_SKIA
+        if (!preprocessGeometry)
+    #endif
+    {
+        // Determine if shape is winded incorrectly and reverse it in that case
+        msdfgen::Point2 outerPoint(bounds.l-(bounds.r-bounds.l)-1, bounds.b-(bounds.t-bounds.b)-1);
+        if (msdfgen::SimpleTrueShapeDistanceFinder::oneShotDistance(shape, outerPoint) > 0) {
+            for (msdfgen::Contour &contour : shape.contours)
+                contour.reverse();
+        }
+    }
+}
+
 void GlyphGeometry::edgeColoring(void (*fn)(msdfgen::Shape &, double, unsigned long long), double angleThreshold, unsigned long long seed) {
     fn(shape, angleThreshold, seed);
 }
 
-void GlyphGeometry::wrapBox(const GlyphAttributes &glyphAttributes) {
+bool GlyphGeometry::setEdgeColors(const msdfgen::EdgeColor *colors, size_t count) {
+    size_t edgeCount = 0;
+    for (const msdfgen::Contour &contour : shape.contours)
+        edgeCount += contour.edges.size();
+    if (edgeCount != count)
+        return false;
+    for (msdfgen::Contour &contour : shape.contours) {
+        for (msdfgen::EdgeHolder &edge : contour.edges)
+            edge->color = *colors++;
+    }
+    return true;
+}
+
+GlyphGeometry::Box GlyphGeometry::computeBox(const GlyphAttributes &glyphAttributes) const {
+    Box result = { };
     double scale = glyphAttributes.scale*geometryScale;
     msdfgen::Range range = glyphAttributes.range/geometryScale;
     Padding fullPadding = (glyphAttributes.innerPadding+glyphAttributes.outerPadding)/geometryScale;
-    box.range = range;
-    box.scale = scale;
+    result.range = range;
+    result.scale = scale;
     if (bounds.l < bounds.r && bounds.b < bounds.t) {
         double l = bounds.l, b = bounds.b, r = bounds.r, t = bounds.t;
         l += range.lower, b += range.lower;
@@ -68,28 +112,33 @@ void GlyphGeometry::wrapBox(const GlyphAttributes &glyphAttributes) {
         if (glyphAttributes.pxAlignOriginX) {
             int sl = (int) floor(scale*l-.5);
             int sr = (int) ceil(scale*r+.5);
-            box.rect.w = sr-sl;
-            box.translate.x = -sl/scale;
+            result.rect.w = sr-sl;
+            result.translate.x = -sl/scale;
         } else {
             double w = scale*(r-l);
-            box.rect.w = (int) ceil(w)+1;
-            box.translate.x = -l+.5*(box.rect.w-w)/scale;
+            result.rect.w = (int) ceil(w)+1;
+            result.translate.x = -l+.5*(result.rect.w-w)/scale;
         }
         if (glyphAttributes.pxAlignOriginY) {
             int sb = (int) floor(scale*b-.5);
             int st = (int) ceil(scale*t+.5);
-            box.rect.h = st-sb;
-            box.translate.y = -sb/scale;
+            result.rect.h = st-sb;
+            result.translate.y = -sb/scale;
         } else {
             double h = scale*(t-b);
-            box.rect.h = (int) ceil(h)+1;
-            box.translate.y = -b+.5*(box.rect.h-h)/scale;
+            result.rect.h = (int) ceil(h)+1;
+            result.translate.y = -b+.5*(result.rect.h-h)/scale;
         }
-        box.outerPadding = glyphAttributes.scale*glyphAttributes.outerPadding;
-    } else {
-        box.rect.w = 0, box.rect.h = 0;
-        box.translate = msdfgen::Vector2();
+        result.outerPadding = glyphAttributes.scale*glyphAttributes.outerPadding;
     }
+    return result;
+}
+
+void GlyphGeometry::wrapBox(const GlyphAttributes &glyphAttributes) {
+    Box newBox = computeBox(glyphAttributes);
+    newBox.rect.x = box.rect.x, newBox.rect.y = box.rect.y;
+    newBox.page = box.page;
+    box = newBox;
 }
 
 void GlyphGeometry::wrapBox(double scale, double range, double miterLimit, bool pxAlignOrigin) {
@@ -179,10 +228,21 @@ void GlyphGeometry::placeBox(int x, int y) {
     box.rect.x = x, box.rect.y = y;
 }
 
+void GlyphGeometry::placeBox(int x, int y, int page) {
+    box.rect.x = x, box.rect.y = y;
+    box.page = page;
+}
+
 void GlyphGeometry::setBoxRect(const Rectangle &rect) {
     box.rect = rect;
 }
 
+void GlyphGeometry::cropBoxRows(int y, int height) {
+    box.rect.y += y;
+    box.rect.h = height;
+    box.translate.y -= y/box.scale;
+}
+
 int GlyphGeometry::getIndex() const {
     return index;
 }
@@ -234,6 +294,10 @@ void GlyphGeometry::getBoxSize(int &w, int &h) const {
     w = box.rect.w, h = box.rect.h;
 }
 
+int GlyphGeometry::getBoxPage() const {
+    return box.page;
+}
+
 msdfgen::Range GlyphGeometry::getBoxRange() const {
     return box.range;
 }
@@ -275,12 +339,48 @@ bool GlyphGeometry::isWhitespace() const {
     return shape.contours.empty();
 }
 
+double GlyphGeometry::getGenerationCost() const {
+    // Linear, quadratic, and cubic segments are weighted 1, 2, and 4 respectively
+    double edgeWeight = 0;
+    for (const msdfgen::Contour &contour : shape.contours)
+        for (const msdfgen::EdgeHolder &edge : contour.edges)
+            edgeWeight += (double) (1<<(edge->type()-1));
+    return (double) box.rect.w*box.rect.h*edgeWeight;
+}
+
+bool GlyphGeometry::hasIdenticalBitmap(const GlyphGeometry &other) const {
+    if (!(
+        box.rect.w == other.box.rect.w && box.rect.h == other.box.rect.h &&
+        box.range.lower == other.box.range.lower && box.range.upper == other.box.range.upper &&
+        box.scale == other.box.scale && box.translate == other.box.translate &&
+        shape.inverseYAxis == other.shape.inverseYAxis && shape.contours.size() == other.shape.contours.size()
+    ))
+        return false;
+    for (size_t i = 0; i < shape.contours.size(); ++i) {
+        const msdfgen::Contour &contour = shape.contours[i], &otherContour = other.shape.contours[i];
+        if (contour.edges.size() != otherContour.edges.size())
+            return false;
+        for (size_t j = 0; j < contour.edges.size(); ++j) {
+            const msdfgen::EdgeSegment *edge = contour.edges[j], *otherEdge = otherContour.edges[j];
+            if (edge->type() != otherEdge->type() || edge->color != otherEdge->color)
+                return false;
+            const msdfgen::Point2 *points = edge->controlPoints(), *otherPoints = otherEdge->controlPoints();
+            for (int k = 0; k <= edge->type(); ++k) {
+                if (points[k] != otherPoints[k])
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
 GlyphGeometry::operator GlyphBox() const {
     GlyphBox box;
     box.index = index;
     box.advance = advance;
     getQuadPlaneBounds(box.bounds.l, box.bounds.b, box.bounds.r, box.bounds.t);
     box.rect.x = this->box.rect.x, box.rect.y = this->box.rect.y, box.rect.w = this->box.rect.w, box.rect.h = this->box.rect.h;
+    box.page = this->box.page;
     return box;
 }
 
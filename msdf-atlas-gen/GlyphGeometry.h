@@ -22,12 +22,30 @@ public:
         bool pxAlignOriginX, pxAlignOriginY;
     };
 
+    /// The glyph's box in the atlas and the transformation for the generator function
+    struct Box {
+        Rectangle rect;
+        msdfgen::Range range;
+        double scale;
+        msdfgen::Vector2 translate;
+        Padding outerPadding;
+        int page;
+    };
+
     GlyphGeometry();
     /// Loads glyph geometry from font
     bool load(msdfgen::FontHandle *font, double geometryScale, msdfgen::GlyphIndex index, bool preprocessGeometry = true);
     bool load(msdfgen::FontHandle *font, double geometryScale, unicode_t codepoint, bool preprocessGeometry = true);
+    /// Loads glyph geometry from a shape in font units (advance also in font units), e.g. from a source other than FreeType
+    bool load(const msdfgen::Shape &shape, double geometryScale, msdfgen::GlyphIndex index, unicode_t codepoint, double advance, bool preprocessGeometry = true);
+    /// Loads glyph geometry from a shape which has already been preprocessed by one of the above (e.g. stored by ShapeCache), advance in font units
+    bool loadPreprocessed(const msdfgen::Shape &shape, double geometryScale, msdfgen::GlyphIndex index, unicode_t codepoint, double advance);
     /// Applies edge coloring to glyph shape
     void edgeColoring(void (*fn)(msdfgen::Shape &, double, unsigned long long), double angleThreshold, unsigned long long seed);
+    /// Applies previously computed edge colors (listed by contour and edge) to glyph shape, returns false if their count does not match
+    bool setEdgeColors(const msdfgen::EdgeColor *colors, size_t count);
+    /// Computes the dimensions of the glyph's box as well as the transformation for the generator function without modifying the glyph (the box's position is zero)
+    Box computeBox(const GlyphAttributes &glyphAttributes) const;
     /// Computes the dimensions of the glyph's box as well as the transformation for the generator function
     void wrapBox(const GlyphAttributes &glyphAttributes);
     void wrapBox(double scale, double range, double miterLimit, bool pxAlignOrigin = false);
@@ -38,8 +56,12 @@ public:
     void frameBox(double scale, double range, double miterLimit, int width, int height, const double *fixedX, const double *fixedY, bool pxAlignOriginX, bool pxAlignOriginY);
     /// Sets the glyph's box's position in the atlas
     void placeBox(int x, int y);
+    /// Sets the glyph's box's position in the atlas and the atlas page it is on
+    void placeBox(int x, int y, int page);
     /// Sets the glyph's box's rectangle in the atlas
     void setBoxRect(const Rectangle &rect);
+    /// Restricts the glyph's box to the band of rows [y, y+height) counted from its bottom edge, so that only that part of the bitmap is generated
+    void cropBoxRows(int y, int height);
     /// Returns the glyph's index within the font
     int getIndex() const;
     /// Returns the glyph's index as a msdfgen::GlyphIndex
@@ -62,6 +84,8 @@ public:
     void getBoxRect(int &x, int &y, int &w, int &h) const;
     /// Outputs the dimensions of the glyph's box in the atlas
     void getBoxSize(int &w, int &h) const;
+    /// Returns the index of the atlas page the glyph's box is on
+    int getBoxPage() const;
     /// Returns the range needed to generate the glyph's SDF
     msdfgen::Range getBoxRange() const;
     /// Returns the projection needed to generate the glyph's bitmap
@@ -76,6 +100,10 @@ public:
     void getQuadAtlasBounds(double &l, double &b, double &r, double &t) const;
     /// Returns true if the glyph is a whitespace and has no geometry
     bool isWhitespace() const;
+    /// Returns the estimated relative cost of generating the glyph's bitmap (box area times the number of edges weighted by their degree)
+    double getGenerationCost() const;
+    /// Returns true if the other glyph's bitmap would be identical to this one's (same shape, edge colors, and box dimensions and transformation)
+    bool hasIdenticalBitmap(const GlyphGeometry &other) const;
     /// Simplifies to GlyphBox
     operator GlyphBox() const;
 
@@ -86,13 +114,9 @@ private:
     msdfgen::Shape shape;
     msdfgen::Shape::Bounds bounds;
     double advance;
-    struct {
-        Rectangle rect;
-        msdfgen::Range range;
-        double scale;
-        msdfgen::Vector2 translate;
-        Padding outerPadding;
-    } box;
+    Box box;
+
+    void prepareShape(bool preprocessGeometry);
 
 };
 
@@ -2,7 +2,9 @@
 #include "GridAtlasPacker.h"
 
 #include <algorithm>
+#include <vector>
 #include "utils.hpp"
+#include "Workload.h"
 
 namespace msdf_atlas {
 
@@ -91,32 +93,54 @@ GridAtlasPacker::GridAtlasPacker() :
     pxAlignOriginX(false), pxAlignOriginY(false),
     scaleMaximizationTolerance(.001),
     alignedColumnsBias(.125),
-    cutoff(false)
+    cutoff(false),
+    threadCount(1)
 { }
 
-msdfgen::Shape::Bounds GridAtlasPacker::getMaxBounds(double &maxWidth, double &maxHeight, GlyphGeometry *glyphs, int count, double scale, double outerRange) const {
+msdfgen::Shape::Bounds GridAtlasPacker::getMaxBounds(double &maxWidth, double &maxHeight, const GlyphBounds *glyphs, int count, double scale, double outerRange) const {
     static const double LARGE_VALUE = 1e240;
-    msdfgen::Shape::Bounds maxBounds = { +LARGE_VALUE, +LARGE_VALUE, -LARGE_VALUE, -LARGE_VALUE };
-    for (GlyphGeometry *glyph = glyphs, *end = glyphs+count; glyph < end; ++glyph) {
-        if (!glyph->isWhitespace()) {
-            double geometryScale = glyph->getGeometryScale();
+    // Partial extents of each chunk of glyphs - since they are combined by min / max, the result doesn't depend on the number of chunks
+    struct Extent {
+        msdfgen::Shape::Bounds bounds;
+        double width, height;
+    };
+    int chunks = std::max(std::min(threadCount, count), 1);
+    std::vector<Extent, Allocator<Extent>> extents(chunks);
+    auto measureChunk = [&](int chunk, int) -> bool {
+        Extent extent = { { +LARGE_VALUE, +LARGE_VALUE, -LARGE_VALUE, -LARGE_VALUE }, 0, 0 };
+        for (const GlyphBounds *glyph = glyphs+(long long) count*chunk/chunks, *end = glyphs+(long long) count*(chunk+1)/chunks; glyph < end; ++glyph) {
+            double geometryScale = glyph->geometryScale;
             double shapeOuterRange = outerRange/geometryScale;
             geometryScale *= scale;
-            const msdfgen::Shape::Bounds &shapeBounds = glyph->getShapeBounds();
-            double l = shapeBounds.l, b = shapeBounds.b, r = shapeBounds.r, t = shapeBounds.t;
+            double l = glyph->bounds.l, b = glyph->bounds.b, r = glyph->bounds.r, t = glyph->bounds.t;
             l -= shapeOuterRange, b -= shapeOuterRange;
             r += shapeOuterRange, t += shapeOuterRange;
             if (miterLimit > 0)
-                glyph->getShape().boundMiters(l, b, r, t, shapeOuterRange, miterLimit, 1);
+                glyph->shape->boundMiters(l, b, r, t, shapeOuterRange, miterLimit, 1);
             l *= geometryScale, b *= geometryScale;
             r *= geometryScale, t *= geometryScale;
-            maxBounds.l = std::min(maxBounds.l, l);
-            maxBounds.b = std::min(maxBounds.b, b);
-            maxBounds.r = std::max(maxBounds.r, r);
-            maxBounds.t = std::max(maxBounds.t, t);
-            maxWidth = std::max(maxWidth, r-l);
-            maxHeight = std::max(maxHeight, t-b);
+            extent.bounds.l = std::min(extent.bounds.l, l);
+            extent.bounds.b = std::min(extent.bounds.b, b);
+            extent.bounds.r = std::max(extent.bounds.r, r);
+            extent.bounds.t = std::max(extent.bounds.t, t);
+            extent.width = std::max(extent.width, r-l);
+            extent.height = std::max(extent.height, t-b);
         }
+        extents[chunk] = extent;
+        return true;
+    };
+    if (chunks > 1)
+        Workload(measureChunk, chunks).finish(threadCount);
+    else
+        measureChunk(0, 0);
+    msdfgen::Shape::Bounds maxBounds = { +LARGE_VALUE, +LARGE_VALUE, -LARGE_VALUE, -LARGE_VALUE };
+    for (const Extent &extent : extents) {
+        maxBounds.l = std::min(maxBounds.l, extent.bounds.l);
+        maxBounds.b = std::min(maxBounds.b, extent.bounds.b);
+        maxBounds.r = std::max(maxBounds.r, extent.bounds.r);
+        maxBounds.t = std::max(maxBounds.t, extent.bounds.t);
+        maxWidth = std::max(maxWidth, extent.width);
+        maxHeight = std::max(maxHeight, extent.height);
     }
     if (maxBounds.l >= maxBounds.r || maxBounds.b >= maxBounds.t)
         maxBounds = msdfgen::Shape::Bounds();
@@ -136,7 +160,7 @@ msdfgen::Shape::Bounds GridAtlasPacker::getMaxBounds(double &maxWidth, double &m
     return maxBounds;
 }
 
-double GridAtlasPacker::scaleToFit(GlyphGeometry *glyphs, int count, int cellWidth, int cellHeight, msdfgen::Shape::Bounds &maxBounds, double &maxWidth, double &maxHeight) const {
+double GridAtlasPacker::scaleToFit(const GlyphBounds *glyphs, int count, int cellWidth, int cellHeight, msdfgen::Shape::Bounds &maxBounds, double &maxWidth, double &maxHeight) const {
     static const int BIG_VALUE = 1<<28;
     if (cellWidth <= 0)
         cellWidth = BIG_VALUE;
@@ -214,6 +238,17 @@ int GridAtlasPacker::pack(GlyphGeometry *glyphs, int count) {
     if ((cellWidth > 0 && cellWidth-spacing-1 <= -2*pxRange.lower) || (cellHeight > 0 && cellHeight-spacing-1 <= -2*pxRange.lower)) // cells definitely too small
         return -1;
 
+    // Cache the bounds of non-whitespace glyphs
+    std::vector<GlyphBounds, Allocator<GlyphBounds>> glyphBounds;
+    glyphBounds.reserve(count);
+    for (const GlyphGeometry *glyph = glyphs, *end = glyphs+count; glyph < end; ++glyph) {
+        if (!glyph->isWhitespace()) {
+            GlyphBounds cur = { &glyph->getShape(), glyph->getShapeBounds(), glyph->getGeometryScale() };
+            glyphBounds.push_back(cur);
+        }
+    }
+    int glyphBoundsCount = (int) glyphBounds.size();
+
     msdfgen::Shape::Bounds maxBounds = { };
     double maxWidth = 0, maxHeight = 0;
 
@@ -223,49 +258,48 @@ int GridAtlasPacker::pack(GlyphGeometry *glyphs, int count) {
         if (pxRange.lower != pxRange.upper && miterLimit > 0) {
 
             if (cellWidth > 0 || cellHeight > 0) {
-                scale = scaleToFit(glyphs, count, cellWidth, cellHeight, maxBounds, maxWidth, maxHeight);
+                scale = scaleToFit(glyphBounds.data(), glyphBoundsCount, cellWidth, cellHeight, maxBounds, maxWidth, maxHeight);
                 if (scale < minScale) {
                     scale = minScale;
                     cutoff = true;
-                    maxBounds = getMaxBounds(maxWidth, maxHeight, glyphs, count, scale, -(unitRange.lower+pxRange.lower/scale));
+                    maxBounds = getMaxBounds(maxWidth, maxHeight, glyphBounds.data(), glyphBoundsCount, scale, -(unitRange.lower+pxRange.lower/scale));
                 }
             }
 
             else if (width > 0 && height > 0) {
+                // Candidate column counts - evaluated in parallel, then compared in the original order so that the result doesn't depend on thread count
+                struct Candidate {
+                    int cols;
+                    int cellWidth, cellHeight;
+                    double scale;
+                };
+                std::vector<Candidate, Allocator<Candidate>> candidates;
+                for (int q = (int) sqrt(cellCount)+1; q > 0; --q) {
+                    for (int cols : { q, (cellCount+q-1)/q }) {
+                        int rows = (cellCount+cols-1)/cols;
+                        Candidate candidate = { cols, (width+spacing)/cols, (height+spacing)/rows, 0 };
+                        lowerToConstraint(candidate.cellWidth, candidate.cellHeight, cellDimensionsConstraint);
+                        if (candidate.cellWidth > 0 && candidate.cellHeight > 0)
+                            candidates.push_back(candidate);
+                    }
+                }
+                Workload([&](int i, int) -> bool {
+                    msdfgen::Shape::Bounds curMaxBounds;
+                    double curMaxWidth, curMaxHeight;
+                    Candidate &candidate = candidates[i];
+                    candidate.scale = scaleToFit(glyphBounds.data(), glyphBoundsCount, candidate.cellWidth, candidate.cellHeight, curMaxBounds, curMaxWidth, curMaxHeight);
+                    return true;
+                }, (int) candidates.size()).finish(threadCount);
                 double bestAlignedScale = 0;
                 int bestCols = 0, bestAlignedCols = 0;
-                for (int q = (int) sqrt(cellCount)+1; q > 0; --q) {
-                    int cols = q;
-                    int rows = (cellCount+cols-1)/cols;
-                    int tWidth = (width+spacing)/cols;
-                    int tHeight = (height+spacing)/rows;
-                    lowerToConstraint(tWidth, tHeight, cellDimensionsConstraint);
-                    if (tWidth > 0 && tHeight > 0) {
-                        double curScale = scaleToFit(glyphs, count, tWidth, tHeight, maxBounds, maxWidth, maxHeight);
-                        if (curScale > scale) {
-                            scale = curScale;
-                            bestCols = cols;
-                        }
-                        if (cols*tWidth == width && curScale > bestAlignedScale) {
-                            bestAlignedScale = curScale;
-                            bestAlignedCols = cols;
-                        }
+                for (const Candidate &candidate : candidates) {
+                    if (candidate.scale > scale) {
+                        scale = candidate.scale;
+                        bestCols = candidate.cols;
                     }
-                    cols = (cellCount+q-1)/q;
-                    rows = (cellCount+cols-1)/cols;
-                    tWidth = (width+spacing)/cols;
-                    tHeight = (height+spacing)/rows;
-                    lowerToConstraint(tWidth, tHeight, cellDimensionsConstraint);
-                    if (tWidth > 0 && tHeight > 0) {
-                        double curScale = scaleToFit(glyphs, count, tWidth, tHeight, maxBounds, maxWidth, maxHeight);
-                        if (curScale > scale) {
-                            scale = curScale;
-                            bestCols = cols;
-                        }
-                        if (cols*tWidth == width && curScale > bestAlignedScale) {
-                            bestAlignedScale = curScale;
-                            bestAlignedCols = cols;
-                        }
+                    if (candidate.cols*candidate.cellWidth == width && candidate.scale > bestAlignedScale) {
+                        bestAlignedScale = candidate.scale;
+                        bestAlignedCols = candidate.cols;
                     }
                 }
                 if (!bestCols)
@@ -281,19 +315,19 @@ int GridAtlasPacker::pack(GlyphGeometry *glyphs, int count) {
                 cellWidth = (width+spacing)/columns;
                 cellHeight = (height+spacing)/rows;
                 lowerToConstraint(cellWidth, cellHeight, cellDimensionsConstraint);
-                scale = scaleToFit(glyphs, count, cellWidth, cellHeight, maxBounds, maxWidth, maxHeight);
+                scale = scaleToFit(glyphBounds.data(), glyphBoundsCount, cellWidth, cellHeight, maxBounds, maxWidth, maxHeight);
                 if (scale < minScale)
                     scale = -1;
             }
 
             if (scale <= 0) {
-                maxBounds = getMaxBounds(maxWidth, maxHeight, glyphs, count, minScale, -(unitRange.lower+pxRange.lower/minScale));
+                maxBounds = getMaxBounds(maxWidth, maxHeight, glyphBounds.data(), glyphBoundsCount, minScale, -(unitRange.lower+pxRange.lower/minScale));
                 cellWidth = (int) ceil(maxWidth)+spacing+1;
                 cellHeight = (int) ceil(maxHeight)+spacing+1;
                 raiseToConstraint(cellWidth, cellHeight, cellDimensionsConstraint);
-                scale = scaleToFit(glyphs, count, cellWidth, cellHeight, maxBounds, maxWidth, maxHeight);
+                scale = scaleToFit(glyphBounds.data(), glyphBoundsCount, cellWidth, cellHeight, maxBounds, maxWidth, maxHeight);
                 if (scale < minScale)
-                    maxBounds = getMaxBounds(maxWidth, maxHeight, glyphs, count, scale = minScale, -(unitRange.lower+pxRange.lower/minScale));
+                    maxBounds = getMaxBounds(maxWidth, maxHeight, glyphBounds.data(), glyphBoundsCount, scale = minScale, -(unitRange.lower+pxRange.lower/minScale));
             }
 
             if (initial.rows < 0 && initial.cellHeight < 0) {
@@ -308,7 +342,7 @@ int GridAtlasPacker::pack(GlyphGeometry *glyphs, int count) {
         } else {
 
             Padding pxPadding = innerPxPadding+outerPxPadding;
-            maxBounds = getMaxBounds(maxWidth, maxHeight, glyphs, count, 1, -unitRange.lower);
+            maxBounds = getMaxBounds(maxWidth, maxHeight, glyphBounds.data(), glyphBoundsCount, 1, -unitRange.lower);
             // Undo pxPadding added by getMaxBounds before pixel scale is known
             pad(maxBounds, -pxPadding);
             maxWidth -= pxPadding.l+pxPadding.r;
@@ -409,7 +443,7 @@ int GridAtlasPacker::pack(GlyphGeometry *glyphs, int count) {
         }
 
     } else {
-        maxBounds = getMaxBounds(maxWidth, maxHeight, glyphs, count, scale, -(unitRange.lower+pxRange.lower/scale));
+        maxBounds = getMaxBounds(maxWidth, maxHeight, glyphBounds.data(), glyphBoundsCount, scale, -(unitRange.lower+pxRange.lower/scale));
         int optimalCellWidth = (int) ceil(maxWidth)+spacing+1;
         int optimalCellHeight = (int) ceil(maxHeight)+spacing+1;
         if (cellWidth < 0 || cellHeight < 0) {
@@ -491,21 +525,28 @@ int GridAtlasPacker::pack(GlyphGeometry *glyphs, int count) {
     attribs.miterLimit = miterLimit;
     attribs.pxAlignOriginX = pxAlignOriginX;
     attribs.pxAlignOriginY = pxAlignOriginY;
-    int col = 0, row = 0;
+    // Assign cells in glyph order, then frame the glyphs in parallel
+    int cellLimit = columns*std::max(rows, 1);
+    std::vector<GlyphGeometry *, Allocator<GlyphGeometry *>> cellGlyphs;
+    cellGlyphs.reserve(std::min(glyphBoundsCount, cellLimit));
+    int remaining = 0;
     for (GlyphGeometry *glyph = glyphs, *end = glyphs+count; glyph < end; ++glyph) {
         if (!glyph->isWhitespace()) {
-            glyph->frameBox(attribs, cellWidth-spacing, cellHeight-spacing, hFixed ? &fixedX : nullptr, vFixed ? &fixedY : nullptr);
-            glyph->placeBox(col*cellWidth, height-(row+1)*cellHeight);
-            if (++col >= columns) {
-                if (++row >= rows) {
-                    return end-glyph-1;
-                }
-                col = 0;
+            cellGlyphs.push_back(glyph);
+            if ((int) cellGlyphs.size() >= cellLimit) {
+                remaining = int(end-glyph-1);
+                break;
             }
         }
     }
+    Workload([&](int i, int) -> bool {
+        int col = i%columns, row = i/columns;
+        cellGlyphs[i]->frameBox(attribs, cellWidth-spacing, cellHeight-spacing, hFixed ? &fixedX : nullptr, vFixed ? &fixedY : nullptr);
+        cellGlyphs[i]->placeBox(col*cellWidth, height-(row+1)*cellHeight);
+        return true;
+    }, (int) cellGlyphs.size()).finish(threadCount);
 
-    return 0;
+    return remaining;
 }
 
 void GridAtlasPacker::setFixedOrigin(bool horizontal, bool vertical) {
@@ -600,6 +641,10 @@ void GridAtlasPacker::setOuterPixelPadding(const Padding &padding) {
     outerPxPadding = padding;
 }
 
+void GridAtlasPacker::setThreadCount(int threadCount) {
+    this->threadCount = threadCount;
+}
+
 void GridAtlasPacker::getDimensions(int &width, int &height) const {
     width = this->width, height = this->height;
 }
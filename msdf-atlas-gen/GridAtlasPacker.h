@@ -57,6 +57,8 @@ public:
     void setInnerPixelPadding(const Padding &padding);
     /// Sets the pixel component of width of additional padding around each glyph quad
     void setOuterPixelPadding(const Padding &padding);
+    /// Sets the number of threads used to evaluate glyph bounds and candidate grid configurations
+    void setThreadCount(int threadCount);
 
     /// Outputs the atlas's final dimensions
     void getDimensions(int &width, int &height) const;
@@ -76,6 +78,13 @@ public:
     bool hasCutoff() const;
 
 private:
+    /// Per-glyph data needed for computing bounds, cached for non-whitespace glyphs at the start of pack
+    struct GlyphBounds {
+        const msdfgen::Shape *shape;
+        msdfgen::Shape::Bounds bounds;
+        double geometryScale;
+    };
+
     int columns, rows;
     int width, height;
     int cellWidth, cellHeight;
@@ -95,13 +104,14 @@ private:
     double scaleMaximizationTolerance;
     double alignedColumnsBias;
     bool cutoff;
+    int threadCount;
 
     static void lowerToConstraint(int &width, int &height, DimensionsConstraint constraint);
     static void raiseToConstraint(int &width, int &height, DimensionsConstraint constraint);
 
     double dimensionsRating(int width, int height, bool aligned) const;
-    msdfgen::Shape::Bounds getMaxBounds(double &maxWidth, double &maxHeight, GlyphGeometry *glyphs, int count, double scale, double outerRange) const;
-    double scaleToFit(GlyphGeometry *glyphs, int count, int cellWidth, int cellHeight, msdfgen::Shape::Bounds &maxBounds, double &maxWidth, double &maxHeight) const;
+    msdfgen::Shape::Bounds getMaxBounds(double &maxWidth, double &maxHeight, const GlyphBounds *glyphs, int count, double scale, double outerRange) const;
+    double scaleToFit(const GlyphBounds *glyphs, int count, int cellWidth, int cellHeight, msdfgen::Shape::Bounds &maxBounds, double &maxWidth, double &maxHeight) const;
 
 };
 
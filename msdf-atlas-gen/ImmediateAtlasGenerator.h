@@ -2,10 +2,19 @@
 #pragma once
 
 #include <vector>
+#include <deque>
+#include <type_traits>
 #include "GlyphBox.h"
 #include "Workload.h"
+#include "ThreadPool.h"
+#include "Tracer.h"
 #include "AtlasGenerator.h"
 
+/// Minimum number of rows of a band when a glyph is split between threads
+#define MSDF_ATLAS_MIN_BAND_HEIGHT 16
+/// Number of extra rows generated on each side of a band and discarded afterwards
+#define MSDF_ATLAS_BAND_APRON 2
+
 namespace msdf_atlas {
 
 /**
@@ -13,6 +22,9 @@ namespace msdf_atlas {
  * and AtlasStorage class and generates glyph bitmaps immediately
  * (does not return until all submitted work is finished),
  * but may use multiple threads (setThreadCount).
+ * The atlas may consist of multiple pages, each with its own AtlasStorage (addPage).
+ * Glyphs are scheduled in order of decreasing estimated cost, and optionally,
+ * glyphs too costly for a single thread may be split into bands of rows (setBandSplitting).
  */
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
 class ImmediateAtlasGenerator {
@@ -25,22 +37,41 @@ public:
     void generate(const GlyphGeometry *glyphs, int count);
     void rearrange(int width, int height, const Remap *remapping, int count);
     void resize(int width, int height);
+    /// Adds a new empty page of the given dimensions to the atlas and returns its index. Glyphs are generated into the page specified by their box
+    /// Existing pages are neither copied nor moved, so references to their storage remain valid. Only available if AtlasStorage can be constructed from the arguments
+    template <typename... ARGS>
+    typename std::enable_if<std::is_constructible<AtlasStorage, int, int, ARGS...>::value, int>::type addPage(int width, int height, ARGS... storageArgs);
     /// Sets attributes for the generator function
     void setAttributes(const GeneratorAttributes &attributes);
     /// Sets the number of threads to be run by generate
     void setThreadCount(int threadCount);
-    /// Allows access to the underlying AtlasStorage
-    const AtlasStorage &atlasStorage() const;
+    /// Enables splitting glyphs costlier than an even share of the work into bands of rows generated by different threads
+    void setBandSplitting(bool enabled);
+    /// Sets the ThreadPool to run generate on (nullptr for the default pool)
+    void setThreadPool(ThreadPool *threadPool);
+    /// Sets a Tracer to record the generation of each glyph into (nullptr to disable)
+    void setTracer(Tracer *tracer);
+    /// Allows access to the underlying AtlasStorage of a page
+    const AtlasStorage &atlasStorage(int page = 0) const;
+    /// Allows modifying the underlying AtlasStorage of a page, e.g. to fill in pixels of glyphs that are not generated
+    AtlasStorage &mutableAtlasStorage(int page = 0);
+    /// Returns the number of atlas pages
+    int getPageCount() const;
     /// Returns the layout of the contained glyphs as a list of GlyphBoxes
     const std::vector<GlyphBox, Allocator<GlyphBox>> &getLayout() const;
+    /// Clears the layout without affecting the atlas storage, e.g. when the placement of glyphs is tracked elsewhere
+    void clearLayout();
 
 private:
-    AtlasStorage storage;
+    std::deque<AtlasStorage, Allocator<AtlasStorage>> pages;
     std::vector<GlyphBox, Allocator<GlyphBox>> layout;
     std::vector<T, Allocator<T>> glyphBuffer;
     std::vector<byte, Allocator<byte>> errorCorrectionBuffer;
     GeneratorAttributes attributes;
     int threadCount;
+    bool bandSplitting;
+    ThreadPool *threadPool;
+    Tracer *tracer;
 
 };
 
@@ -1,29 +1,145 @@
 
 #include "ImmediateAtlasGenerator.h"
 
+#include <cmath>
 #include <algorithm>
+#include <map>
 
 namespace msdf_atlas {
 
+/// Returns the section of the storage's own memory where the glyph can be generated directly (if the storage supports it for T, N)
+template <typename T, int N, class AtlasStorage>
+static auto atlasStorageSection(AtlasStorage &storage, int x, int y, int width, int height, int) -> decltype(msdfgen::BitmapSection<T, N>(storage.getSection(x, y, width, height))) {
+    return storage.getSection(x, y, width, height);
+}
+
+template <typename T, int N, class AtlasStorage>
+static msdfgen::BitmapSection<T, N> atlasStorageSection(AtlasStorage &, int, int, int, int, long) {
+    return msdfgen::BitmapSection<T, N>();
+}
+
+/// Notifies the storage that a section obtained by atlasStorageSection has been written into (if the storage needs to know)
+template <class AtlasStorage>
+static auto commitAtlasStorageSection(AtlasStorage &storage, int x, int y, int width, int height, int) -> decltype(storage.commitSection(x, y, width, height), void()) {
+    storage.commitSection(x, y, width, height);
+}
+
+template <class AtlasStorage>
+static void commitAtlasStorageSection(AtlasStorage &, int, int, int, int, long) { }
+
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
-ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::ImmediateAtlasGenerator() : threadCount(1) { }
+ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::ImmediateAtlasGenerator() : threadCount(1), bandSplitting(false), threadPool(), tracer() {
+    pages.emplace_back();
+}
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
-ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::ImmediateAtlasGenerator(int width, int height) : storage(width, height), threadCount(1) { }
+ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::ImmediateAtlasGenerator(int width, int height) : threadCount(1), bandSplitting(false), threadPool(), tracer() {
+    pages.emplace_back(width, height);
+}
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
 template <typename... ARGS>
-ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::ImmediateAtlasGenerator(int width, int height, ARGS... storageArgs) : storage(width, height, storageArgs...), threadCount(1) { }
+ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::ImmediateAtlasGenerator(int width, int height, ARGS... storageArgs) : threadCount(1), bandSplitting(false), threadPool(), tracer() {
+    pages.emplace_back(width, height, storageArgs...);
+}
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
 void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::generate(const GlyphGeometry *glyphs, int count) {
+    struct Job {
+        int glyph;
+        int bandY, bandHeight;
+        double cost;
+        bool direct;
+    };
+
     int maxBoxArea = 0;
+    double totalCost = 0;
+    std::vector<Job, Allocator<Job>> jobs;
+    jobs.reserve(count);
+    // Glyphs identical to an earlier glyph of the batch are not generated again - its bitmap is also put at their position
+    std::map<int, int, std::less<int>, Allocator<std::pair<const int, int>>> lastOriginalByIndex;
+    std::vector<int, Allocator<int>> prevOriginal(count, -1), nextCopy(count, -1);
     for (int i = 0; i < count; ++i) {
         GlyphBox box = glyphs[i];
         maxBoxArea = std::max(maxBoxArea, box.rect.w*box.rect.h);
         layout.push_back((GlyphBox &&) box);
+        if (!glyphs[i].isWhitespace()) {
+            std::pair<typename decltype(lastOriginalByIndex)::iterator, bool> entry = lastOriginalByIndex.insert(std::make_pair(glyphs[i].getIndex(), i));
+            if (!entry.second) {
+                int original = entry.first->second;
+                while (original >= 0 && !glyphs[original].hasIdenticalBitmap(glyphs[i]))
+                    original = prevOriginal[original];
+                if (original >= 0) {
+                    nextCopy[i] = nextCopy[original];
+                    nextCopy[original] = i;
+                    continue;
+                }
+                prevOriginal[i] = entry.first->second;
+                entry.first->second = i;
+            }
+            Job job = { i, 0, box.rect.h, glyphs[i].getGenerationCost(), false };
+            totalCost += job.cost;
+            jobs.push_back(job);
+        }
     }
-    int threadBufferSize = N*maxBoxArea;
+    if (jobs.empty())
+        return;
+
+    // Split glyphs costlier than an even share of the work into bands of rows
+    if (bandSplitting && threadCount > 1) {
+        double evenShare = totalCost/threadCount;
+        for (int i = 0, jobCount = (int) jobs.size(); i < jobCount; ++i) {
+            Job job = jobs[i];
+            int bandCount = std::min(std::min(threadCount, (int) ceil(job.cost/evenShare)), job.bandHeight/MSDF_ATLAS_MIN_BAND_HEIGHT);
+            if (bandCount > 1) {
+                for (int j = 0; j < bandCount; ++j) {
+                    Job band = job;
+                    band.bandY = job.bandHeight*j/bandCount;
+                    band.bandHeight = job.bandHeight*(j+1)/bandCount-band.bandY;
+                    band.cost = job.cost*band.bandHeight/job.bandHeight;
+                    if (j)
+                        jobs.push_back(band);
+                    else
+                        jobs[i] = band;
+                }
+            }
+        }
+    }
+
+    // Longest processing time first: deal the jobs in order of decreasing cost to the least loaded thread's range
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job &a, const Job &b) -> bool {
+        return a.cost > b.cost;
+    });
+    int jobCount = (int) jobs.size();
+    int rangeCount = std::min(threadCount, jobCount);
+    std::vector<Job, Allocator<Job>> schedule(jobCount);
+    if (rangeCount > 1) {
+        std::vector<int, Allocator<int>> rangeNext(rangeCount);
+        std::vector<double, Allocator<double>> rangeLoad(rangeCount);
+        for (int i = 0; i < rangeCount; ++i)
+            rangeNext[i] = (int) ((long long) jobCount*i/rangeCount);
+        for (const Job &job : jobs) {
+            int target = -1;
+            for (int i = 0; i < rangeCount; ++i) {
+                if (rangeNext[i] < (int) ((long long) jobCount*(i+1)/rangeCount) && (target < 0 || rangeLoad[i] < rangeLoad[target]))
+                    target = i;
+            }
+            schedule[rangeNext[target]++] = job;
+            rangeLoad[target] += job.cost;
+        }
+    } else
+        schedule = (std::vector<Job, Allocator<Job>> &&) jobs;
+
+    // Glyphs are generated directly into the atlas storage if possible, otherwise into a per-thread buffer and copied
+    int maxBufferedArea = 0;
+    for (Job &job : schedule) {
+        int l, b, w, h;
+        glyphs[job.glyph].getBoxRect(l, b, w, h);
+        job.direct = job.bandHeight == h && nextCopy[job.glyph] < 0 && atlasStorageSection<T, N>(pages[glyphs[job.glyph].getBoxPage()], l, b, w, h, 0).pixels;
+        if (!job.direct)
+            maxBufferedArea = std::max(maxBufferedArea, w*h);
+    }
+    int threadBufferSize = N*maxBufferedArea;
     if (threadCount*threadBufferSize > (int) glyphBuffer.size())
         glyphBuffer.resize(threadCount*threadBufferSize);
     if (threadCount*maxBoxArea > (int) errorCorrectionBuffer.size())
@@ -33,34 +149,95 @@ void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::generate(const GlyphGe
         threadAttributes[i] = attributes;
         threadAttributes[i].config.errorCorrection.buffer = errorCorrectionBuffer.data()+i*maxBoxArea;
     }
+    if (tracer)
+        tracer->reserveThreads(threadCount);
 
-    Workload([this, glyphs, &threadAttributes, threadBufferSize](int i, int threadNo) -> bool {
-        const GlyphGeometry &glyph = glyphs[i];
-        if (!glyph.isWhitespace()) {
-            int l, b, w, h;
-            glyph.getBoxRect(l, b, w, h);
-            msdfgen::BitmapRef<T, N> glyphBitmap(glyphBuffer.data()+threadNo*threadBufferSize, w, h);
-            GEN_FN(glyphBitmap, glyph, threadAttributes[threadNo]);
-            storage.put(l, b, msdfgen::BitmapConstRef<T, N>(glyphBitmap));
+    Workload([this, glyphs, &schedule, &nextCopy, &threadAttributes, threadBufferSize](int i, int threadNo) -> bool {
+        const Job &job = schedule[i];
+        const GlyphGeometry &glyph = glyphs[job.glyph];
+        int l, b, w, h;
+        glyph.getBoxRect(l, b, w, h);
+        AtlasStorage &storage = pages[glyph.getBoxPage()];
+        Tracer::TimePoint generateBegin;
+        if (tracer)
+            generateBegin = Tracer::now();
+        if (job.direct) {
+            GEN_FN(atlasStorageSection<T, N>(storage, l, b, w, h, 0), glyph, threadAttributes[threadNo]);
+            commitAtlasStorageSection(storage, l, b, w, h, 0);
+            if (tracer)
+                tracer->record(threadNo, "generate", glyph.getIndex(), generateBegin, Tracer::now());
+            return true;
+        }
+        T *threadBuffer = glyphBuffer.data()+threadNo*threadBufferSize;
+        msdfgen::BitmapConstRef<T, N> output;
+        if (job.bandHeight < h) {
+            // Generate the band with an apron of extra rows so that error correction sees the same neighborhood
+            int apronBottom = std::min(job.bandY, MSDF_ATLAS_BAND_APRON);
+            int apronTop = std::min(h-job.bandY-job.bandHeight, MSDF_ATLAS_BAND_APRON);
+            GlyphGeometry bandGlyph(glyph);
+            bandGlyph.cropBoxRows(job.bandY-apronBottom, apronBottom+job.bandHeight+apronTop);
+            GEN_FN(msdfgen::BitmapSection<T, N>(threadBuffer, w, apronBottom+job.bandHeight+apronTop), bandGlyph, threadAttributes[threadNo]);
+            output = msdfgen::BitmapConstRef<T, N>(threadBuffer+N*w*apronBottom, w, job.bandHeight);
+        } else {
+            GEN_FN(msdfgen::BitmapSection<T, N>(threadBuffer, w, h), glyph, threadAttributes[threadNo]);
+            output = msdfgen::BitmapConstRef<T, N>(threadBuffer, w, h);
+        }
+        Tracer::TimePoint putBegin;
+        if (tracer)
+            putBegin = Tracer::now();
+        storage.put(l, b+job.bandY, output);
+        for (int copy = nextCopy[job.glyph]; copy >= 0; copy = nextCopy[copy]) {
+            const GlyphGeometry &copyGlyph = glyphs[copy];
+            pages[copyGlyph.getBoxPage()].put(copyGlyph.getBoxRect().x, copyGlyph.getBoxRect().y+job.bandY, output);
+        }
+        if (tracer) {
+            tracer->record(threadNo, "generate", glyph.getIndex(), generateBegin, putBegin);
+            tracer->record(threadNo, "put", glyph.getIndex(), putBegin, Tracer::now());
         }
         return true;
-    }, count).finish(threadCount);
+    }, jobCount).finish(threadPool ? *threadPool : ThreadPool::getDefault(), threadCount);
 }
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
 void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::rearrange(int width, int height, const Remap *remapping, int count) {
     for (int i = 0; i < count; ++i) {
-        layout[remapping[i].index].rect.x = remapping[i].target.x;
-        layout[remapping[i].index].rect.y = remapping[i].target.y;
+        if (remapping[i].index < (int) layout.size()) {
+            layout[remapping[i].index].rect.x = remapping[i].target.x;
+            layout[remapping[i].index].rect.y = remapping[i].target.y;
+            layout[remapping[i].index].page = remapping[i].target.page;
+        }
+    }
+    if (pages.size() == 1) {
+        AtlasStorage newStorage((AtlasStorage &&) pages[0], width, height, remapping, count);
+        pages[0] = (AtlasStorage &&) newStorage;
+        return;
+    }
+    // Glyphs are only rearranged within their pages
+    std::vector<Remap, Allocator<Remap>> pageRemapping;
+    for (int page = 0; page < (int) pages.size(); ++page) {
+        pageRemapping.clear();
+        for (int i = 0; i < count; ++i) {
+            if (remapping[i].target.page == page)
+                pageRemapping.push_back(remapping[i]);
+        }
+        AtlasStorage newStorage((AtlasStorage &&) pages[page], width, height, pageRemapping.data(), (int) pageRemapping.size());
+        pages[page] = (AtlasStorage &&) newStorage;
     }
-    AtlasStorage newStorage((AtlasStorage &&) storage, width, height, remapping, count);
-    storage = (AtlasStorage &&) newStorage;
 }
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
 void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::resize(int width, int height) {
-    AtlasStorage newStorage((AtlasStorage &&) storage, width, height);
-    storage = (AtlasStorage &&) newStorage;
+    for (AtlasStorage &storage : pages) {
+        AtlasStorage newStorage((AtlasStorage &&) storage, width, height);
+        storage = (AtlasStorage &&) newStorage;
+    }
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+template <typename... ARGS>
+typename std::enable_if<std::is_constructible<AtlasStorage, int, int, ARGS...>::value, int>::type ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::addPage(int width, int height, ARGS... storageArgs) {
+    pages.emplace_back(width, height, storageArgs...);
+    return (int) pages.size()-1;
 }
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
@@ -74,8 +251,33 @@ void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::setThreadCount(int thr
 }
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
-const AtlasStorage &ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::atlasStorage() const {
-    return storage;
+void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::setBandSplitting(bool enabled) {
+    bandSplitting = enabled;
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::setThreadPool(ThreadPool *threadPool) {
+    this->threadPool = threadPool;
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::setTracer(Tracer *tracer) {
+    this->tracer = tracer;
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+const AtlasStorage &ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::atlasStorage(int page) const {
+    return pages[page];
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+AtlasStorage &ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::mutableAtlasStorage(int page) {
+    return pages[page];
+}
+
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+int ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::getPageCount() const {
+    return (int) pages.size();
 }
 
 template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
@@ -83,4 +285,9 @@ const std::vector<GlyphBox, Allocator<GlyphBox>> &ImmediateAtlasGenerator<T, N,
     return layout;
 }
 
+template <typename T, int N, GeneratorFunction<T, N> GEN_FN, class AtlasStorage>
+void ImmediateAtlasGenerator<T, N, GEN_FN, AtlasStorage>::clearLayout() {
+    layout.clear();
+}
+
 }
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "types.h"
+#include "AtlasStorage.h"
+#include "FileMapping.h"
+
+namespace msdf_atlas {
+
+/**
+ * An implementation of AtlasStorage whose pixels are kept in a file mapped into memory,
+ * so that atlases larger than the available memory can be generated and are written out as they are generated.
+ * With the FL32 layout (only if T is float), the file is a valid FL32 image at all times and needs no separate save step.
+ * Resizing and rearranging is done in place in the file.
+ */
+template <typename T, int N>
+class MappedAtlasStorage {
+
+public:
+    enum Layout {
+        /// Only the pixel rows, bottom to top
+        RAW,
+        /// The pixel rows preceded by the FL32 image header, ignored (treated as RAW) unless T is float
+        FL32
+    };
+
+    MappedAtlasStorage();
+    /// Creates (or overwrites) the file and fills it with zero pixels, check isValid for success
+    MappedAtlasStorage(int width, int height, const char *filename, Layout layout = RAW);
+    /// Takes over the original's file and changes its dimensions in place, check isValid for success
+    MappedAtlasStorage(MappedAtlasStorage<T, N> &&orig, int width, int height);
+    /// Takes over the original's file and rearranges the pixels in place, check isValid for success
+    MappedAtlasStorage(MappedAtlasStorage<T, N> &&orig, int width, int height, const Remap *remapping, int count);
+    MappedAtlasStorage(const MappedAtlasStorage<T, N> &) = delete;
+    MappedAtlasStorage(MappedAtlasStorage<T, N> &&orig);
+    MappedAtlasStorage<T, N> &operator=(const MappedAtlasStorage<T, N> &) = delete;
+    MappedAtlasStorage<T, N> &operator=(MappedAtlasStorage<T, N> &&orig);
+    operator msdfgen::BitmapConstRef<T, N>() const;
+    operator msdfgen::BitmapRef<T, N>();
+    template <typename S>
+    void put(int x, int y, const msdfgen::BitmapConstRef<S, N> &subBitmap);
+    void get(int x, int y, const msdfgen::BitmapRef<T, N> &subBitmap) const;
+    /// Returns a reference to the mapped pixels of the subsection at x, y for writing in place, or an empty section if it is out of bounds
+    msdfgen::BitmapSection<T, N> getSection(int x, int y, int width, int height);
+    /// Returns false if creating, resizing, or rearranging the file has failed, in which case the storage is left empty (0x0)
+    bool isValid() const;
+    /// Writes the modified pixels to the file
+    bool flush();
+
+private:
+    enum {
+        FL32_HEADER_SIZE = 16
+    };
+
+    FileMapping file;
+    int width, height;
+    size_t headerSize;
+    bool valid;
+
+    T *pixels() const;
+    /// Changes the dimensions of the image in the file, keeping the pixels of the common area and zeroing the rest
+    bool resizeFile(int width, int height);
+    /// Closes the file and leaves the storage empty and invalid
+    void fail();
+    void writeHeader();
+
+};
+
+}
+
+#include "MappedAtlasStorage.hpp"
@@ -0,0 +1,162 @@
+
+#include "MappedAtlasStorage.h"
+
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include "bitmap-blit.h"
+#include "bitmap-remap.h"
+
+namespace msdf_atlas {
+
+template <typename T, int N>
+MappedAtlasStorage<T, N>::MappedAtlasStorage() : width(0), height(0), headerSize(0), valid(true) { }
+
+template <typename T, int N>
+MappedAtlasStorage<T, N>::MappedAtlasStorage(int width, int height, const char *filename, Layout layout) : width(0), height(0), headerSize(0), valid(false) {
+    if (layout == FL32 && std::is_same<T, float>::value)
+        headerSize = FL32_HEADER_SIZE;
+    // The new file is extended with zeros
+    if (file.create(filename, headerSize+sizeof(T)*N*width*height)) {
+        this->width = width, this->height = height;
+        valid = true;
+        writeHeader();
+    } else
+        file.close();
+}
+
+template <typename T, int N>
+MappedAtlasStorage<T, N>::MappedAtlasStorage(MappedAtlasStorage<T, N> &&orig, int width, int height) : MappedAtlasStorage((MappedAtlasStorage<T, N> &&) orig) {
+    resizeFile(width, height);
+}
+
+template <typename T, int N>
+MappedAtlasStorage<T, N>::MappedAtlasStorage(MappedAtlasStorage<T, N> &&orig, int width, int height, const Remap *remapping, int count) : MappedAtlasStorage((MappedAtlasStorage<T, N> &&) orig) {
+    // Rectangles may be moved outwards if the image grows or inwards if it shrinks
+    if (resizeFile(std::max(width, this->width), std::max(height, this->height))) {
+        remapInPlace(msdfgen::BitmapSection<T, N>(pixels(), this->width, this->height), remapping, count);
+        resizeFile(width, height);
+    }
+}
+
+template <typename T, int N>
+MappedAtlasStorage<T, N>::MappedAtlasStorage(MappedAtlasStorage<T, N> &&orig) : file((FileMapping &&) orig.file), width(orig.width), height(orig.height), headerSize(orig.headerSize), valid(orig.valid) {
+    orig.width = 0, orig.height = 0;
+}
+
+template <typename T, int N>
+MappedAtlasStorage<T, N> &MappedAtlasStorage<T, N>::operator=(MappedAtlasStorage<T, N> &&orig) {
+    if (this != &orig) {
+        file = (FileMapping &&) orig.file;
+        width = orig.width, height = orig.height;
+        headerSize = orig.headerSize;
+        valid = orig.valid;
+        orig.width = 0, orig.height = 0;
+    }
+    return *this;
+}
+
+template <typename T, int N>
+MappedAtlasStorage<T, N>::operator msdfgen::BitmapConstRef<T, N>() const {
+    return msdfgen::BitmapConstRef<T, N>(pixels(), width, height);
+}
+
+template <typename T, int N>
+MappedAtlasStorage<T, N>::operator msdfgen::BitmapRef<T, N>() {
+    return msdfgen::BitmapRef<T, N>(pixels(), width, height);
+}
+
+template <typename T, int N>
+template <typename S>
+void MappedAtlasStorage<T, N>::put(int x, int y, const msdfgen::BitmapConstRef<S, N> &subBitmap) {
+    blit(msdfgen::BitmapRef<T, N>(pixels(), width, height), subBitmap, x, y, 0, 0, subBitmap.width, subBitmap.height);
+}
+
+template <typename T, int N>
+void MappedAtlasStorage<T, N>::get(int x, int y, const msdfgen::BitmapRef<T, N> &subBitmap) const {
+    blit(subBitmap, msdfgen::BitmapConstRef<T, N>(pixels(), width, height), 0, 0, x, y, subBitmap.width, subBitmap.height);
+}
+
+template <typename T, int N>
+msdfgen::BitmapSection<T, N> MappedAtlasStorage<T, N>::getSection(int x, int y, int width, int height) {
+    if (!pixels() || x < 0 || y < 0 || width < 0 || height < 0 || x+width > this->width || y+height > this->height)
+        return msdfgen::BitmapSection<T, N>();
+    return msdfgen::BitmapRef<T, N>(pixels(), this->width, this->height).getSection(x, y, x+width, y+height);
+}
+
+template <typename T, int N>
+bool MappedAtlasStorage<T, N>::isValid() const {
+    return valid;
+}
+
+template <typename T, int N>
+bool MappedAtlasStorage<T, N>::flush() {
+    return file.flush();
+}
+
+template <typename T, int N>
+T *MappedAtlasStorage<T, N>::pixels() const {
+    return file.data() ? (T *) (file.data()+headerSize) : nullptr;
+}
+
+template <typename T, int N>
+bool MappedAtlasStorage<T, N>::resizeFile(int width, int height) {
+    if (width == this->width && height == this->height)
+        return true;
+    size_t prevSize = headerSize+sizeof(T)*N*this->width*this->height;
+    size_t size = headerSize+sizeof(T)*N*width*height;
+    if (size > prevSize && !file.resize(size)) {
+        fail();
+        return false;
+    }
+    T *p = pixels();
+    size_t prevStride = N*this->width, stride = N*width;
+    int commonHeight = std::min(height, this->height);
+    // Rows must be moved in the direction that doesn't overwrite rows not yet moved
+    if (width > this->width) {
+        for (int y = commonHeight-1; y >= 0; --y) {
+            memmove(p+stride*y, p+prevStride*y, sizeof(T)*prevStride);
+            memset(p+stride*y+prevStride, 0, sizeof(T)*(stride-prevStride));
+        }
+    } else if (width < this->width) {
+        for (int y = 0; y < commonHeight; ++y)
+            memmove(p+stride*y, p+prevStride*y, sizeof(T)*stride);
+    }
+    if (height > commonHeight)
+        memset(p+stride*commonHeight, 0, sizeof(T)*stride*(height-commonHeight));
+    if (size < prevSize && !file.resize(size)) {
+        fail();
+        return false;
+    }
+    this->width = width, this->height = height;
+    writeHeader();
+    return true;
+}
+
+template <typename T, int N>
+void MappedAtlasStorage<T, N>::fail() {
+    // The mapping is lost when the file cannot be resized
+    file.close();
+    width = 0, height = 0;
+    valid = false;
+}
+
+template <typename T, int N>
+void MappedAtlasStorage<T, N>::writeHeader() {
+    if (headerSize != FL32_HEADER_SIZE || !file.data())
+        return;
+    byte *header = file.data();
+    memset(header, 0, FL32_HEADER_SIZE);
+    header[0] = byte('F'), header[1] = byte('L'), header[2] = byte('3'), header[3] = byte('2');
+    header[4] = byte(height);
+    header[5] = byte(height>>8);
+    header[6] = byte(height>>16);
+    header[7] = byte(height>>24);
+    header[8] = byte(width);
+    header[9] = byte(width>>8);
+    header[10] = byte(width>>16);
+    header[11] = byte(width>>24);
+    header[12] = byte(N);
+}
+
+}
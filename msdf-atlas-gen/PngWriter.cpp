@@ -0,0 +1,111 @@
+
+#include "PngWriter.h"
+
+#ifdef MSDFGEN_USE_LIBPNG
+
+#include <png.h>
+#include <zlib.h>
+
+namespace msdf_atlas {
+
+static void pngIgnoreError(png_structp, png_const_charp) { }
+
+static bool pngWriteEnd(png_structp png, png_infop info) {
+    if (setjmp(png_jmpbuf(png)))
+        return false;
+    png_write_end(png, info);
+    return true;
+}
+
+PngWriter::PngWriter() : file(), png(), info(), remainingRows(0), failed(false) { }
+
+PngWriter::~PngWriter() {
+    close();
+}
+
+bool PngWriter::open(const char *filename, int width, int height, int channels, PngCompression compression) {
+    close();
+    int colorType;
+    switch (channels) {
+        case 1:
+            colorType = PNG_COLOR_TYPE_GRAY;
+            break;
+        case 3:
+            colorType = PNG_COLOR_TYPE_RGB;
+            break;
+        case 4:
+            colorType = PNG_COLOR_TYPE_RGB_ALPHA;
+            break;
+        default:
+            return false;
+    }
+    if (!(width > 0 && height > 0))
+        return false;
+    if (!(file = fopen(filename, "wb")))
+        return false;
+    png_structp pngStruct = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, &pngIgnoreError, &pngIgnoreError);
+    png_infop pngInfo = pngStruct ? png_create_info_struct(pngStruct) : NULL;
+    png = pngStruct, info = pngInfo;
+    failed = true;
+    if (!pngInfo) {
+        close();
+        return false;
+    }
+    if (setjmp(png_jmpbuf(pngStruct))) {
+        close();
+        return false;
+    }
+    png_init_io(pngStruct, file);
+    png_set_IHDR(pngStruct, pngInfo, width, height, 8, colorType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    switch (compression) {
+        case PngCompression::FAST:
+            png_set_compression_level(pngStruct, Z_BEST_SPEED);
+            png_set_filter(pngStruct, PNG_FILTER_TYPE_BASE, PNG_FILTER_UP);
+            break;
+        case PngCompression::DEFAULT:
+            png_set_compression_level(pngStruct, 6);
+            break;
+        case PngCompression::MAX:
+            png_set_compression_level(pngStruct, Z_BEST_COMPRESSION);
+            break;
+    }
+    png_write_info(pngStruct, pngInfo);
+    remainingRows = height;
+    failed = false;
+    return true;
+}
+
+bool PngWriter::writeRow(const byte *pixels) {
+    if (!png || failed || remainingRows <= 0)
+        return false;
+    png_structp pngStruct = (png_structp) png;
+    failed = true;
+    if (setjmp(png_jmpbuf(pngStruct)))
+        return false;
+    png_write_row(pngStruct, const_cast<png_bytep>(pixels));
+    --remainingRows;
+    failed = false;
+    return true;
+}
+
+bool PngWriter::close() {
+    bool success = false;
+    if (png) {
+        png_structp pngStruct = (png_structp) png;
+        png_infop pngInfo = (png_infop) info;
+        success = !failed && !remainingRows && pngWriteEnd(pngStruct, pngInfo);
+        png_destroy_write_struct(&pngStruct, pngInfo ? &pngInfo : NULL);
+        png = nullptr, info = nullptr;
+    }
+    if (file) {
+        success = !fclose(file) && success;
+        file = nullptr;
+    }
+    remainingRows = 0;
+    failed = false;
+    return success;
+}
+
+}
+
+#endif
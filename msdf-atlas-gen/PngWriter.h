@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdio>
+#include "types.h"
+
+#ifdef MSDFGEN_USE_LIBPNG
+
+namespace msdf_atlas {
+
+/// Writes a PNG image file progressively, one row of pixels at a time from top to bottom, so that the whole image never needs to be in memory
+class PngWriter {
+
+public:
+    PngWriter();
+    PngWriter(const PngWriter &) = delete;
+    ~PngWriter();
+    PngWriter &operator=(const PngWriter &) = delete;
+    /// Creates the file and writes the image header, channels must be 1 (grayscale), 3 (RGB), or 4 (RGBA)
+    bool open(const char *filename, int width, int height, int channels, PngCompression compression = PngCompression::MAX);
+    /// Writes the next row of width*channels bytes
+    bool writeRow(const byte *pixels);
+    /// Finishes the image and closes the file, returns false if it is incomplete or any write has failed
+    bool close();
+
+private:
+    FILE *file;
+    void *png;
+    void *info;
+    int remainingRows;
+    bool failed;
+
+};
+
+}
+
+#endif
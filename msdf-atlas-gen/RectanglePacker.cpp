@@ -55,6 +55,31 @@ void RectanglePacker::splitSpace(int index, int w, int h) {
         spaces.push_back(b);
 }
 
+bool RectanglePacker::mergeSpace(Rectangle &space) {
+    for (size_t i = 0; i < spaces.size(); ++i) {
+        const Rectangle &other = spaces[i];
+        if (other.x == space.x && other.w == space.w && (other.y+other.h == space.y || space.y+space.h == other.y)) {
+            space.y = std::min(space.y, other.y);
+            space.h += other.h;
+        } else if (other.y == space.y && other.h == space.h && (other.x+other.w == space.x || space.x+space.w == other.x)) {
+            space.x = std::min(space.x, other.x);
+            space.w += other.w;
+        } else
+            continue;
+        removeFromUnorderedVector(spaces, i);
+        return true;
+    }
+    return false;
+}
+
+void RectanglePacker::free(const Rectangle &rectangle) {
+    if (rectangle.w > 0 && rectangle.h > 0) {
+        Rectangle space = rectangle;
+        while (mergeSpace(space));
+        spaces.push_back(space);
+    }
+}
+
 int RectanglePacker::pack(Rectangle *rectangles, int count) {
     std::vector<int, Allocator<int>> remainingRects(count);
     for (int i = 0; i < count; ++i)
@@ -19,6 +19,8 @@ public:
     /// Packs the rectangle array, returns how many didn't fit (0 on success)
     int pack(Rectangle *rectangles, int count);
     int pack(OrientedRectangle *rectangles, int count);
+    /// Returns a previously packed rectangle's area to the free space, merging it with adjacent free spaces where possible
+    void free(const Rectangle &rectangle);
 
 private:
     std::vector<Rectangle, Allocator<Rectangle>> spaces;
@@ -26,6 +28,8 @@ private:
     static int rateFit(int w, int h, int sw, int sh);
 
     void splitSpace(int index, int w, int h);
+    /// Merges the space with an adjacent free space sharing a whole edge and removes it from the list, returns false if there is none
+    bool mergeSpace(Rectangle &space);
 
 };
 
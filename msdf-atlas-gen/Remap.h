@@ -8,6 +8,7 @@ struct Remap {
     int index;
     struct {
         int x, y;
+        int page;
     } source, target;
     int width, height;
 };
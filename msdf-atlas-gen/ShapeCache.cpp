@@ -0,0 +1,402 @@
+
+#include "ShapeCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+
+#define SHAPE_CACHE_VERSION 1u
+#define SHAPE_CACHE_HEADER_SIZE 16
+#define SHAPE_CACHE_ENTRY_SIZE 32
+
+namespace msdf_atlas {
+
+/*
+ * Cache file format (all values little-endian):
+ *     8 bytes - signature "MSDFSHPC"
+ *     u32 - format version
+ *     u32 - number of entries
+ *     entries sorted by (glyph index, kind, hash), each:
+ *         u32 - glyph index
+ *         u32 - entry kind
+ *         u64 - hash of parameters (edge coloring only)
+ *         u64 - offset of data within file
+ *         u64 - size of data
+ *     data of all entries, 8-byte aligned
+ * Shape entry data:
+ *     f64 - advance in font units
+ *     u32 - number of contours
+ *     u32 - inverse Y axis flag
+ *     for each contour: u32 - number of edges, for each edge:
+ *         u8 - degree (1 = linear, 2 = quadratic, 3 = cubic)
+ *         u8 - edge color
+ *         f64 x 2*(degree+1) - control point coordinates
+ * Edge coloring entry data:
+ *     u32 - number of edges
+ *     u8 x number of edges - edge colors
+ */
+
+static const char SHAPE_CACHE_SIGNATURE[] = "MSDFSHPC";
+
+typedef std::vector<byte, Allocator<byte>> ByteVector;
+
+static unsigned long long fnv1a(unsigned long long hash, const byte *data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static unsigned long long fnv1a(const byte *data, size_t length) {
+    return fnv1a(0xcbf29ce484222325ull, data, length);
+}
+
+static void writeUint32(ByteVector &output, unsigned value) {
+    for (int i = 0; i < 4; ++i)
+        output.push_back(byte(value>>(8*i)));
+}
+
+static void writeUint64(ByteVector &output, unsigned long long value) {
+    for (int i = 0; i < 8; ++i)
+        output.push_back(byte(value>>(8*i)));
+}
+
+static void writeDouble(ByteVector &output, double value) {
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    writeUint64(output, bits);
+}
+
+static unsigned readUint32(const byte *data) {
+    return (unsigned) data[0]|(unsigned) data[1]<<8|(unsigned) data[2]<<16|(unsigned) data[3]<<24;
+}
+
+static unsigned long long readUint64(const byte *data) {
+    return (unsigned long long) readUint32(data)|(unsigned long long) readUint32(data+4)<<32;
+}
+
+static double readDouble(const byte *data) {
+    unsigned long long bits = readUint64(data);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void writeShape(ByteVector &output, const msdfgen::Shape &shape, double advance) {
+    writeDouble(output, advance);
+    writeUint32(output, (unsigned) shape.contours.size());
+    writeUint32(output, (unsigned) shape.inverseYAxis);
+    for (const msdfgen::Contour &contour : shape.contours) {
+        writeUint32(output, (unsigned) contour.edges.size());
+        for (const msdfgen::EdgeHolder &edge : contour.edges) {
+            int degree = edge->type();
+            output.push_back(byte(degree));
+            output.push_back(byte(edge->color));
+            const msdfgen::Point2 *p = edge->controlPoints();
+            for (int i = 0; i <= degree; ++i) {
+                writeDouble(output, p[i].x);
+                writeDouble(output, p[i].y);
+            }
+        }
+    }
+}
+
+static bool readShape(msdfgen::Shape &shape, double &advance, const byte *data, size_t size) {
+    const byte *end = data+size;
+    if (size < 16)
+        return false;
+    advance = readDouble(data);
+    unsigned contourCount = readUint32(data+8);
+    shape.inverseYAxis = readUint32(data+12) != 0;
+    data += 16;
+    shape.contours.clear();
+    shape.contours.reserve(std::min((size_t) contourCount, size/4));
+    for (unsigned i = 0; i < contourCount; ++i) {
+        if (end-data < 4)
+            return false;
+        unsigned edgeCount = readUint32(data);
+        data += 4;
+        msdfgen::Contour &contour = shape.addContour();
+        for (unsigned j = 0; j < edgeCount; ++j) {
+            if (end-data < 2)
+                return false;
+            int degree = data[0];
+            msdfgen::EdgeColor color = msdfgen::EdgeColor(data[1]&msdfgen::WHITE);
+            data += 2;
+            if (degree < 1 || degree > 3 || end-data < 16*(degree+1))
+                return false;
+            msdfgen::Point2 p[4];
+            for (int k = 0; k <= degree; ++k, data += 16)
+                p[k] = msdfgen::Point2(readDouble(data), readDouble(data+8));
+            switch (degree) {
+                case 1:
+                    contour.addEdge(msdfgen::EdgeHolder(new msdfgen::LinearSegment(p[0], p[1], color)));
+                    break;
+                case 2:
+                    contour.addEdge(msdfgen::EdgeHolder(new msdfgen::QuadraticSegment(p[0], p[1], p[2], color)));
+                    break;
+                case 3:
+                    contour.addEdge(msdfgen::EdgeHolder(new msdfgen::CubicSegment(p[0], p[1], p[2], p[3], color)));
+                    break;
+            }
+        }
+    }
+    return data == end;
+}
+
+static int coloringId(void (*fn)(msdfgen::Shape &, double, unsigned long long)) {
+    if (fn == &msdfgen::edgeColoringSimple)
+        return 1;
+    if (fn == &msdfgen::edgeColoringInkTrap)
+        return 2;
+    if (fn == &msdfgen::edgeColoringByDistance)
+        return 3;
+    return 0;
+}
+
+bool ShapeCache::EntryKey::operator<(const EntryKey &other) const {
+    if (glyphIndex != other.glyphIndex)
+        return glyphIndex < other.glyphIndex;
+    if (kind != other.kind)
+        return kind < other.kind;
+    return hash < other.hash;
+}
+
+ShapeCache::ShapeCache() : preprocessGeometry(true), entryCount(0), hitCount(0) { }
+
+bool ShapeCache::open(const char *directory, const char *fontFilename, const char *variation, bool preprocessGeometry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    mapping.close();
+    entryCount = 0;
+    newEntries.clear();
+    this->preprocessGeometry = preprocessGeometry;
+    // The cache is addressed by the font's contents rather than its filename
+    FileMapping fontFile;
+    if (!fontFile.openReadOnly(fontFilename))
+        return false;
+    unsigned long long fontHash = fnv1a(fontFile.data(), fontFile.size());
+    fontFile.close();
+    byte options[] = {
+        byte(SHAPE_CACHE_VERSION),
+        byte(preprocessGeometry),
+        #ifdef MSDFGEN_USE_SKIA
+            byte(1)
+        #else
+            byte(0)
+        #endif
+    };
+    unsigned long long optionsHash = fnv1a(options, sizeof(options));
+    if (variation)
+        optionsHash = fnv1a(optionsHash, (const byte *) variation, strlen(variation));
+    char name[48];
+    sprintf(name, "%016llx-%016llx.shapes", fontHash, optionsHash);
+    filename = directory;
+    if (!filename.empty() && filename.back() != '/' && filename.back() != '\\')
+        filename.push_back('/');
+    filename += name;
+    mapFile();
+    return true;
+}
+
+bool ShapeCache::mapFile() {
+    entryCount = 0;
+    if (!mapping.openReadOnly(filename.c_str()))
+        return false;
+    const byte *data = mapping.data();
+    size_t size = mapping.size();
+    if (!(size >= SHAPE_CACHE_HEADER_SIZE && !memcmp(data, SHAPE_CACHE_SIGNATURE, 8) && readUint32(data+8) == SHAPE_CACHE_VERSION && readUint32(data+12) <= (size-SHAPE_CACHE_HEADER_SIZE)/SHAPE_CACHE_ENTRY_SIZE)) {
+        mapping.close();
+        return false;
+    }
+    entryCount = readUint32(data+12);
+    return true;
+}
+
+bool ShapeCache::findEntry(const byte *&data, size_t &size, const EntryKey &key) const {
+    // Entries of the mapped file are sorted, so binary search is used
+    const byte *fileData = mapping.data();
+    size_t fileSize = mapping.size();
+    size_t lo = 0, hi = entryCount;
+    while (lo < hi) {
+        size_t mid = (lo+hi)>>1;
+        const byte *entry = fileData+SHAPE_CACHE_HEADER_SIZE+SHAPE_CACHE_ENTRY_SIZE*mid;
+        EntryKey entryKey = { readUint32(entry), readUint32(entry+4), readUint64(entry+8) };
+        if (entryKey < key)
+            lo = mid+1;
+        else if (key < entryKey)
+            hi = mid;
+        else {
+            unsigned long long offset = readUint64(entry+16), length = readUint64(entry+24);
+            if (offset > fileSize || length > fileSize-offset)
+                return false;
+            data = fileData+offset;
+            size = (size_t) length;
+            return true;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = newEntries.find(key);
+    if (it != newEntries.end()) {
+        data = it->second.data();
+        size = it->second.size();
+        return true;
+    }
+    return false;
+}
+
+void ShapeCache::addEntry(const EntryKey &key, std::vector<byte, Allocator<byte>> &&data) {
+    std::lock_guard<std::mutex> lock(mutex);
+    newEntries.insert(std::make_pair(key, std::move(data)));
+}
+
+bool ShapeCache::loadGlyph(GlyphGeometry &glyph, msdfgen::FontHandle *font, double geometryScale, msdfgen::GlyphIndex index) {
+    return loadGlyphShape(glyph, font, geometryScale, index, 0);
+}
+
+bool ShapeCache::loadGlyph(GlyphGeometry &glyph, msdfgen::FontHandle *font, double geometryScale, unicode_t codepoint) {
+    msdfgen::GlyphIndex index;
+    if (font && msdfgen::getGlyphIndex(index, font, codepoint))
+        return loadGlyphShape(glyph, font, geometryScale, index, codepoint);
+    return false;
+}
+
+bool ShapeCache::loadGlyphShape(GlyphGeometry &glyph, msdfgen::FontHandle *font, double geometryScale, msdfgen::GlyphIndex index, unicode_t codepoint) {
+    EntryKey key = { index.getIndex(), SHAPE_ENTRY, 0 };
+    const byte *data = nullptr;
+    size_t size = 0;
+    msdfgen::Shape shape;
+    double advance = 0;
+    if (findEntry(data, size, key) && readShape(shape, advance, data, size) && glyph.loadPreprocessed(shape, geometryScale, index, codepoint, advance)) {
+        ++hitCount;
+        return true;
+    }
+    if (!(font && msdfgen::loadGlyph(shape, font, index, msdfgen::FONT_SCALING_NONE, &advance) && glyph.load(shape, geometryScale, index, codepoint, advance, preprocessGeometry)))
+        return false;
+    ByteVector entryData;
+    writeShape(entryData, glyph.getShape(), advance);
+    addEntry(key, std::move(entryData));
+    return true;
+}
+
+void ShapeCache::edgeColoring(GlyphGeometry &glyph, void (*fn)(msdfgen::Shape &, double, unsigned long long), double angleThreshold, unsigned long long seed) {
+    int id = coloringId(fn);
+    if (!id) {
+        glyph.edgeColoring(fn, angleThreshold, seed);
+        return;
+    }
+    ByteVector parameters;
+    writeUint32(parameters, (unsigned) id);
+    writeDouble(parameters, angleThreshold);
+    writeUint64(parameters, seed);
+    EntryKey key = { (unsigned) glyph.getIndex(), COLORING_ENTRY, fnv1a(parameters.data(), parameters.size()) };
+    const byte *data = nullptr;
+    size_t size = 0;
+    if (findEntry(data, size, key) && size >= 4 && readUint32(data) == size-4) {
+        std::vector<msdfgen::EdgeColor, Allocator<msdfgen::EdgeColor>> colors(size-4);
+        for (size_t i = 0; i < colors.size(); ++i)
+            colors[i] = msdfgen::EdgeColor(data[4+i]&msdfgen::WHITE);
+        if (glyph.setEdgeColors(colors.data(), colors.size())) {
+            ++hitCount;
+            return;
+        }
+    }
+    glyph.edgeColoring(fn, angleThreshold, seed);
+    ByteVector entryData;
+    writeUint32(entryData, 0);
+    for (const msdfgen::Contour &contour : glyph.getShape().contours) {
+        for (const msdfgen::EdgeHolder &edge : contour.edges)
+            entryData.push_back(byte(edge->color));
+    }
+    unsigned edgeCount = (unsigned) entryData.size()-4;
+    for (int i = 0; i < 4; ++i)
+        entryData[i] = byte(edgeCount>>(8*i));
+    addEntry(key, std::move(entryData));
+}
+
+bool ShapeCache::save() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (filename.empty())
+        return false;
+    if (newEntries.empty())
+        return true;
+    // The file is mapped again in case it has been updated since it was opened, e.g. by another instance
+    mapFile();
+
+    // Merge mapped and new entries into a sorted list
+    struct Entry {
+        EntryKey key;
+        const byte *data;
+        size_t size;
+    };
+    std::vector<Entry, Allocator<Entry>> entries;
+    entries.reserve(entryCount+newEntries.size());
+    const byte *fileData = mapping.data();
+    size_t fileSize = mapping.size();
+    for (size_t i = 0; i < entryCount; ++i) {
+        const byte *entry = fileData+SHAPE_CACHE_HEADER_SIZE+SHAPE_CACHE_ENTRY_SIZE*i;
+        unsigned long long offset = readUint64(entry+16), length = readUint64(entry+24);
+        if (offset > fileSize || length > fileSize-offset)
+            continue;
+        Entry e = { { readUint32(entry), readUint32(entry+4), readUint64(entry+8) }, fileData+offset, (size_t) length };
+        entries.push_back(e);
+    }
+    for (const auto &newEntry : newEntries) {
+        Entry e = { newEntry.first, newEntry.second.data(), newEntry.second.size() };
+        entries.push_back(e);
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.key < b.key;
+    });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return !(a.key < b.key || b.key < a.key);
+    }), entries.end());
+
+    ByteVector output;
+    output.insert(output.end(), SHAPE_CACHE_SIGNATURE, SHAPE_CACHE_SIGNATURE+8);
+    writeUint32(output, SHAPE_CACHE_VERSION);
+    writeUint32(output, (unsigned) entries.size());
+    size_t offset = SHAPE_CACHE_HEADER_SIZE+SHAPE_CACHE_ENTRY_SIZE*entries.size();
+    for (const Entry &entry : entries) {
+        writeUint32(output, entry.key.glyphIndex);
+        writeUint32(output, entry.key.kind);
+        writeUint64(output, entry.key.hash);
+        writeUint64(output, offset);
+        writeUint64(output, entry.size);
+        offset += (entry.size+7)&~(size_t) 7;
+    }
+    for (const Entry &entry : entries) {
+        output.insert(output.end(), entry.data, entry.data+entry.size);
+        output.resize((output.size()+7)&~(size_t) 7);
+    }
+    mapping.close();
+    newEntries.clear();
+    entryCount = 0;
+
+    // The file is replaced at once so that concurrent runs never read a partially written cache
+    std::string tempFilename = filename+"."+std::to_string((unsigned long long) std::chrono::steady_clock::now().time_since_epoch().count())+".tmp";
+    FILE *f = fopen(tempFilename.c_str(), "wb");
+    if (!f) {
+        mapFile();
+        return false;
+    }
+    bool success = fwrite(output.data(), 1, output.size(), f) == output.size();
+    success = !fclose(f) && success;
+    if (success && rename(tempFilename.c_str(), filename.c_str())) {
+        remove(filename.c_str());
+        success = !rename(tempFilename.c_str(), filename.c_str());
+    }
+    if (!success) {
+        remove(tempFilename.c_str());
+        mapFile();
+        return false;
+    }
+    return mapFile();
+}
+
+int ShapeCache::getHitCount() const {
+    return hitCount;
+}
+
+}
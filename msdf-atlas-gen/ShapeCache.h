@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <msdfgen.h>
+#include <msdfgen-ext.h>
+#include "types.h"
+#include "FileMapping.h"
+#include "GlyphGeometry.h"
+
+namespace msdf_atlas {
+
+/**
+ * An on-disk cache of the preprocessed and edge-colored glyph shapes of a single font (or font variant).
+ * The cache file is named after a hash of the font file's contents, the variation coordinates and the preprocessing options,
+ * so that it can be shared between runs with different sizes or charsets. It is memory-mapped and looked up in place.
+ * Shapes and edge colors which were not found are kept in memory until save is called.
+ */
+class ShapeCache {
+
+public:
+    ShapeCache();
+    ShapeCache(const ShapeCache &) = delete;
+    ShapeCache &operator=(const ShapeCache &) = delete;
+    /// Opens (or prepares to create) the cache of the font file with variation coordinates (e.g. "wght=700", may be null) in directory, returns false on failure
+    bool open(const char *directory, const char *fontFilename, const char *variation, bool preprocessGeometry = true);
+    /// Loads glyph geometry from the cache or from font if not present. Same as GlyphGeometry::load, may be called concurrently with different fonts
+    bool loadGlyph(GlyphGeometry &glyph, msdfgen::FontHandle *font, double geometryScale, msdfgen::GlyphIndex index);
+    bool loadGlyph(GlyphGeometry &glyph, msdfgen::FontHandle *font, double geometryScale, unicode_t codepoint);
+    /// Applies edge coloring to glyph shape, or its cached result if present. Same as GlyphGeometry::edgeColoring, may be called concurrently
+    void edgeColoring(GlyphGeometry &glyph, void (*fn)(msdfgen::Shape &, double, unsigned long long), double angleThreshold, unsigned long long seed);
+    /// Writes the cache file if any new entries have been added, returns false on failure
+    bool save();
+    /// Returns the number of shapes and edge colorings that were found in the cache
+    int getHitCount() const;
+
+private:
+    enum EntryKind {
+        SHAPE_ENTRY = 0,
+        COLORING_ENTRY = 1
+    };
+    struct EntryKey {
+        unsigned glyphIndex;
+        unsigned kind;
+        unsigned long long hash;
+        bool operator<(const EntryKey &other) const;
+    };
+
+    std::string filename;
+    bool preprocessGeometry;
+    FileMapping mapping;
+    size_t entryCount;
+    std::map<EntryKey, std::vector<byte, Allocator<byte>>, std::less<EntryKey>, Allocator<std::pair<const EntryKey, std::vector<byte, Allocator<byte>>>>> newEntries;
+    mutable std::mutex mutex;
+    std::atomic<int> hitCount;
+
+    bool loadGlyphShape(GlyphGeometry &glyph, msdfgen::FontHandle *font, double geometryScale, msdfgen::GlyphIndex index, unicode_t codepoint);
+    bool findEntry(const byte *&data, size_t &size, const EntryKey &key) const;
+    void addEntry(const EntryKey &key, std::vector<byte, Allocator<byte>> &&data);
+    bool mapFile();
+
+};
+
+}
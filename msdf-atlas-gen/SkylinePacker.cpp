@@ -0,0 +1,147 @@
+
+#include "SkylinePacker.h"
+
+#include <algorithm>
+
+namespace msdf_atlas {
+
+#define NO_POSITION 0x7fffffff
+
+SkylinePacker::SkylinePacker() : SkylinePacker(0, 0) { }
+
+SkylinePacker::SkylinePacker(int width, int height) : width(0), height(0) {
+    if (width > 0 && height > 0) {
+        this->width = width, this->height = height;
+        skyline.push_back(Segment { 0, 0, width });
+    }
+}
+
+void SkylinePacker::expand(int width, int height) {
+    if (width > 0 && height > 0) {
+        if (width > this->width) {
+            if (!skyline.empty() && !skyline.back().y)
+                skyline.back().w += width-this->width;
+            else
+                skyline.push_back(Segment { this->width, 0, width-this->width });
+            this->width = width;
+        }
+        if (height > this->height)
+            this->height = height;
+    }
+}
+
+int SkylinePacker::findPosition(int w, int h, int &x, int &y) const {
+    int bestSegment = -1;
+    int bestTop = NO_POSITION;
+    for (int i = 0; i < (int) skyline.size() && skyline[i].x+w <= width; ++i) {
+        // The rectangle rests on the highest segment it spans
+        int top = skyline[i].y+h;
+        for (int j = i+1, end = skyline[i].x+w; j < (int) skyline.size() && skyline[j].x < end && top < bestTop; ++j)
+            top = std::max(top, skyline[j].y+h);
+        if (top <= height && top < bestTop) {
+            bestSegment = i;
+            bestTop = top;
+            x = skyline[i].x;
+            y = top-h;
+        }
+    }
+    return bestSegment;
+}
+
+void SkylinePacker::place(int segment, int x, int y, int w, int h) {
+    skyline.insert(skyline.begin()+segment, Segment { x, y+h, w });
+    // Remove or shorten the segments covered by the new one
+    int end = x+w;
+    int next = segment+1;
+    while (next < (int) skyline.size() && skyline[next].x < end) {
+        Segment &covered = skyline[next];
+        if (covered.x+covered.w <= end)
+            skyline.erase(skyline.begin()+next);
+        else {
+            covered.w -= end-covered.x;
+            covered.x = end;
+            break;
+        }
+    }
+    // Merge with neighbors at the same height
+    if (next < (int) skyline.size() && skyline[next].y == skyline[segment].y) {
+        skyline[segment].w += skyline[next].w;
+        skyline.erase(skyline.begin()+next);
+    }
+    if (segment > 0 && skyline[segment-1].y == skyline[segment].y) {
+        skyline[segment-1].w += skyline[segment].w;
+        skyline.erase(skyline.begin()+segment);
+    }
+}
+
+int SkylinePacker::pack(Rectangle *rectangles, int count) {
+    std::vector<int, Allocator<int>> order(count);
+    for (int i = 0; i < count; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [rectangles](int a, int b) -> bool {
+        if (rectangles[a].h != rectangles[b].h)
+            return rectangles[a].h > rectangles[b].h;
+        return rectangles[a].w > rectangles[b].w;
+    });
+    int remaining = 0;
+    for (int index : order) {
+        Rectangle &rect = rectangles[index];
+        if (rect.w <= 0 || rect.h <= 0) {
+            rect.x = 0, rect.y = 0;
+            continue;
+        }
+        int x, y;
+        int segment = findPosition(rect.w, rect.h, x, y);
+        if (segment < 0) {
+            ++remaining;
+            continue;
+        }
+        rect.x = x, rect.y = y;
+        place(segment, x, y, rect.w, rect.h);
+    }
+    return remaining;
+}
+
+int SkylinePacker::pack(OrientedRectangle *rectangles, int count) {
+    std::vector<int, Allocator<int>> order(count);
+    for (int i = 0; i < count; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [rectangles](int a, int b) -> bool {
+        int aLong = std::max(rectangles[a].w, rectangles[a].h), bLong = std::max(rectangles[b].w, rectangles[b].h);
+        if (aLong != bLong)
+            return aLong > bLong;
+        return std::min(rectangles[a].w, rectangles[a].h) > std::min(rectangles[b].w, rectangles[b].h);
+    });
+    int remaining = 0;
+    for (int index : order) {
+        OrientedRectangle &rect = rectangles[index];
+        rect.rotated = false;
+        if (rect.w <= 0 || rect.h <= 0) {
+            rect.x = 0, rect.y = 0;
+            continue;
+        }
+        int x, y;
+        int segment = findPosition(rect.w, rect.h, x, y);
+        if (rect.w != rect.h) {
+            int rx, ry;
+            int rotatedSegment = findPosition(rect.h, rect.w, rx, ry);
+            if (rotatedSegment >= 0 && (segment < 0 || ry+rect.w < y+rect.h)) {
+                segment = rotatedSegment;
+                x = rx, y = ry;
+                rect.rotated = true;
+            }
+        }
+        if (segment < 0) {
+            ++remaining;
+            continue;
+        }
+        rect.x = x, rect.y = y;
+        if (rect.rotated)
+            place(segment, x, y, rect.h, rect.w);
+        else
+            place(segment, x, y, rect.w, rect.h);
+    }
+    return remaining;
+}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include "Rectangle.h"
+
+#include "types.h"
+
+namespace msdf_atlas {
+
+/**
+ * Skyline 2D single bin packer - places rectangles sorted by decreasing height at the lowest
+ * position of the packing area's upper contour. Each placement is proportional to the number
+ * of contour segments rather than to the number of free spaces and remaining rectangles,
+ * which makes it much faster than RectanglePacker for large numbers of rectangles at the cost of slightly lower density
+ */
+class SkylinePacker {
+
+public:
+    SkylinePacker();
+    SkylinePacker(int width, int height);
+    /// Expands the packing area - both width and height must be greater or equal to the previous value
+    void expand(int width, int height);
+    /// Packs the rectangle array, returns how many didn't fit (0 on success)
+    int pack(Rectangle *rectangles, int count);
+    int pack(OrientedRectangle *rectangles, int count);
+
+private:
+    /// A horizontal section of the contour, spanning from x to x+w at height y
+    struct Segment {
+        int x, y, w;
+    };
+
+    int width, height;
+    std::vector<Segment, Allocator<Segment>> skyline;
+
+    int findPosition(int w, int h, int &x, int &y) const;
+    void place(int segment, int x, int y, int w, int h);
+
+};
+
+}
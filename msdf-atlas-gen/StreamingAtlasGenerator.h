@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include "ImmediateAtlasGenerator.h"
+
+namespace msdf_atlas {
+
+/// An AtlasStorage which maps the rows of the atlas onto a smaller ring buffer of rows, top to bottom, owned by StreamingAtlasGenerator
+template <typename T, int N>
+class RowRingAtlasStorage {
+
+public:
+    RowRingAtlasStorage();
+    /// The atlas width must be equal to that of the ring
+    RowRingAtlasStorage(int width, int height, const msdfgen::BitmapRef<T, N> &ring);
+    template <typename S>
+    void put(int x, int y, const msdfgen::BitmapConstRef<S, N> &subBitmap);
+    void get(int x, int y, const msdfgen::BitmapRef<T, N> &subBitmap) const;
+
+private:
+    msdfgen::BitmapRef<T, N> ring;
+    int height;
+
+    T *row(int y) const;
+
+};
+
+/**
+ * Generates the atlas in horizontal bands of rows from top to bottom using ImmediateAtlasGenerator
+ * and passes each finished band to a callback on a separate thread (e.g. to encode it into an image file)
+ * while the following band is being generated.
+ * Only a few bands are held in memory at a time rather than the whole atlas.
+ * T is the type of the output pixels, S that of the generator function.
+ */
+template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
+class StreamingAtlasGenerator {
+
+public:
+    /// Receives a band of finished rows of the atlas as its section (bottom-up like the rest of the atlas), returns false to abort
+    typedef std::function<bool(const msdfgen::BitmapConstSection<T, N> &band)> BandCallback;
+
+    StreamingAtlasGenerator(int width, int height, int bandHeight = 256);
+    /// Generates the glyphs into the atlas and passes all of its rows to bandCallback, band by band from the top. Returns false if bandCallback does
+    bool generate(const GlyphGeometry *glyphs, int count, const BandCallback &bandCallback);
+    /// Sets attributes for the generator function
+    void setAttributes(const GeneratorAttributes &attributes);
+    /// Sets the number of threads to generate each band with
+    void setThreadCount(int threadCount);
+    /// Sets the ThreadPool to generate each band on (nullptr for the default pool)
+    void setThreadPool(ThreadPool *threadPool);
+    /// Sets a Tracer to record the generation of each glyph into (nullptr to disable)
+    void setTracer(Tracer *tracer);
+
+private:
+    int width, height;
+    int bandHeight;
+    GeneratorAttributes attributes;
+    int threadCount;
+    ThreadPool *threadPool;
+    Tracer *tracer;
+
+};
+
+}
+
+#include "StreamingAtlasGenerator.hpp"
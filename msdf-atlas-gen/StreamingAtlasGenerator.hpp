@@ -0,0 +1,118 @@
+
+#include "StreamingAtlasGenerator.h"
+
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <thread>
+#include "bitmap-blit.h"
+
+namespace msdf_atlas {
+
+template <typename T, int N>
+RowRingAtlasStorage<T, N>::RowRingAtlasStorage() : height(0) { }
+
+template <typename T, int N>
+RowRingAtlasStorage<T, N>::RowRingAtlasStorage(int, int height, const msdfgen::BitmapRef<T, N> &ring) : ring(ring), height(height) { }
+
+template <typename T, int N>
+template <typename S>
+void RowRingAtlasStorage<T, N>::put(int x, int y, const msdfgen::BitmapConstRef<S, N> &subBitmap) {
+    for (int i = 0; i < subBitmap.height; ++i)
+        blit(msdfgen::BitmapRef<T, N>(row(y+i), ring.width, 1), msdfgen::BitmapConstRef<S, N>(subBitmap(0, i), subBitmap.width, 1), x, 0, 0, 0, subBitmap.width, 1);
+}
+
+template <typename T, int N>
+void RowRingAtlasStorage<T, N>::get(int x, int y, const msdfgen::BitmapRef<T, N> &subBitmap) const {
+    for (int i = 0; i < subBitmap.height; ++i)
+        blit(msdfgen::BitmapRef<T, N>(subBitmap(0, i), subBitmap.width, 1), msdfgen::BitmapConstRef<T, N>(row(y+i), ring.width, 1), 0, 0, x, 0, subBitmap.width, 1);
+}
+
+template <typename T, int N>
+T *RowRingAtlasStorage<T, N>::row(int y) const {
+    return ring.pixels+N*ring.width*((height-y-1)%ring.height);
+}
+
+template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
+StreamingAtlasGenerator<T, S, N, GEN_FN>::StreamingAtlasGenerator(int width, int height, int bandHeight) : width(width), height(height), bandHeight(std::max(bandHeight, 1)), threadCount(1), threadPool(), tracer() { }
+
+template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
+bool StreamingAtlasGenerator<T, S, N, GEN_FN>::generate(const GlyphGeometry *glyphs, int count, const BandCallback &bandCallback) {
+    if (!(width > 0 && height > 0))
+        return false;
+    int bandCount = (height+bandHeight-1)/bandHeight;
+
+    // Assign each glyph to the band containing its top row
+    std::vector<std::pair<int, int>, Allocator<std::pair<int, int> > > order;
+    order.reserve(count);
+    int maxGlyphHeight = 0;
+    for (int i = 0; i < count; ++i) {
+        int l, b, w, h;
+        glyphs[i].getBoxRect(l, b, w, h);
+        if (w > 0 && h > 0) {
+            order.push_back(std::make_pair((height-b-h)/bandHeight, i));
+            maxGlyphHeight = std::max(maxGlyphHeight, h);
+        }
+    }
+    std::sort(order.begin(), order.end());
+
+    // While a band is passed to the callback, the next one is generated and glyphs starting in it may extend below it,
+    // so the ring must hold two bands plus the tallest glyph. Bands are contiguous in the ring since its height is their multiple
+    int ringHeight = bandHeight*std::min(2+(maxGlyphHeight+bandHeight-1)/bandHeight, bandCount);
+    msdfgen::Bitmap<T, N> ring(width, ringHeight);
+    memset((T *) ring, 0, sizeof(T)*N*width*ringHeight);
+    ImmediateAtlasGenerator<S, N, GEN_FN, RowRingAtlasStorage<T, N> > generator(width, height, msdfgen::BitmapRef<T, N>(ring));
+    generator.setAttributes(attributes);
+    generator.setThreadCount(threadCount);
+    generator.setThreadPool(threadPool);
+    generator.setTracer(tracer);
+
+    std::vector<GlyphGeometry, Allocator<GlyphGeometry>> batch;
+    std::thread bandThread;
+    bool success = true;
+    size_t next = 0;
+    for (int band = 0; band < bandCount; ++band) {
+        batch.clear();
+        for (; next < order.size() && order[next].first == band; ++next)
+            batch.push_back(glyphs[order[next].second]);
+        generator.generate(batch.data(), (int) batch.size());
+        generator.clearLayout();
+        // The band before the previous one shares rows of the ring with the band to be generated next, so it must be finished and cleared
+        if (bandThread.joinable())
+            bandThread.join();
+        if (!success)
+            break;
+        int bandRows = std::min(bandHeight, height-band*bandHeight);
+        T *bandPixels = (T *) ring+N*width*(band*bandHeight%ringHeight);
+        bandThread = std::thread([this, &bandCallback, &success, bandPixels, bandRows]() {
+            // The ring is stored top to bottom, so the section starts at the band's last row and has a negative stride
+            success = bandCallback(msdfgen::BitmapConstSection<T, N>(bandPixels+N*width*(bandRows-1), width, bandRows, -N*width));
+            memset(bandPixels, 0, sizeof(T)*N*width*bandRows);
+        });
+    }
+    if (bandThread.joinable())
+        bandThread.join();
+    return success;
+}
+
+template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
+void StreamingAtlasGenerator<T, S, N, GEN_FN>::setAttributes(const GeneratorAttributes &attributes) {
+    this->attributes = attributes;
+}
+
+template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
+void StreamingAtlasGenerator<T, S, N, GEN_FN>::setThreadCount(int threadCount) {
+    this->threadCount = threadCount;
+}
+
+template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
+void StreamingAtlasGenerator<T, S, N, GEN_FN>::setThreadPool(ThreadPool *threadPool) {
+    this->threadPool = threadPool;
+}
+
+template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
+void StreamingAtlasGenerator<T, S, N, GEN_FN>::setTracer(Tracer *tracer) {
+    this->tracer = tracer;
+}
+
+}
@@ -0,0 +1,226 @@
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace msdf_atlas {
+
+#define RANGE_PACK(begin, end) ((unsigned long long) (unsigned) (begin)<<32|(unsigned long long) (unsigned) (end))
+#define RANGE_BEGIN(range) ((int) ((range)>>32))
+#define RANGE_END(range) ((int) ((range)&0xffffffffull))
+
+/// The pool whose worker function is being executed by the current thread, to prevent deadlock on nested run calls
+static thread_local const ThreadPool *currentPool = nullptr;
+
+static bool runSequential(const std::function<bool(int, int)> &workerFunction, int chunks) {
+    for (int i = 0; i < chunks; ++i)
+        if (!workerFunction(i, 0))
+            return false;
+    return true;
+}
+
+ThreadPool &ThreadPool::getDefault() {
+    static ThreadPool defaultPool;
+    return defaultPool;
+}
+
+ThreadPool::ThreadPool(int workerCount) : stopped(false) {
+    reserveWorkers(workerCount);
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+void ThreadPool::reserveWorkers(int workerCount) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopped)
+        return;
+    workers.reserve(std::max(workerCount, (int) workers.size()));
+    while ((int) workers.size() < workerCount) {
+        int workerNo = (int) workers.size();
+        workers.emplace_back(&ThreadPool::workerMain, this);
+        if (workerNo < (int) affinity.size() && affinity[workerNo] >= 0)
+            applyAffinity(workers.back(), affinity[workerNo]);
+    }
+}
+
+int ThreadPool::getWorkerCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (int) workers.size();
+}
+
+bool ThreadPool::setAffinity(int workerNo, int cpu) {
+    if (workerNo < 0)
+        return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (workerNo >= (int) affinity.size())
+        affinity.resize(workerNo+1, -1);
+    affinity[workerNo] = cpu;
+    if (workerNo < (int) workers.size())
+        return applyAffinity(workers[workerNo], cpu);
+#if defined(_WIN32) || defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ThreadPool::run(const std::function<bool(int, int)> &workerFunction, int chunks, int threadCount) {
+    if (chunks <= 0)
+        return true;
+    threadCount = std::min(threadCount, chunks);
+    // A worker function of this pool waits for its own workload's chunks, so nested workloads run sequentially
+    if (threadCount <= 1 || currentPool == this)
+        return runSequential(workerFunction, chunks);
+
+    reserveWorkers(threadCount-1);
+    std::vector<RangeSlot, Allocator<RangeSlot>> slots(threadCount);
+    Job job;
+    job.function = &workerFunction;
+    job.slots = slots.data();
+    job.joinedWorkers = 0;
+    job.activeWorkers = 0;
+    job.result = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        threadCount = std::min(threadCount, stopped ? 1 : (int) workers.size()+1);
+        if (threadCount > 1) {
+            for (int i = 0; i < threadCount; ++i)
+                slots[i].range = RANGE_PACK((long long) chunks*i/threadCount, (long long) chunks*(i+1)/threadCount);
+            job.threads = threadCount;
+            jobs.push_back(&job);
+        }
+    }
+    if (threadCount <= 1)
+        return runSequential(workerFunction, chunks);
+    workCondition.notify_all();
+
+    // Mark the calling thread as well so that nested workloads run sequentially
+    const ThreadPool *previousPool = currentPool;
+    currentPool = this;
+    participate(job, 0);
+    currentPool = previousPool;
+
+    // No chunks are left, stop further workers from joining and wait for those still processing their last chunk
+    std::unique_lock<std::mutex> lock(mutex);
+    jobs.erase(std::find(jobs.begin(), jobs.end(), &job));
+    doneCondition.wait(lock, [&job]() -> bool {
+        return !job.activeWorkers;
+    });
+    return job.result;
+}
+
+void ThreadPool::shutdown() {
+    std::vector<std::thread, Allocator<std::thread>> stoppedWorkers;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+        stoppedWorkers.swap(workers);
+    }
+    workCondition.notify_all();
+    for (std::thread &worker : stoppedWorkers)
+        worker.join();
+}
+
+void ThreadPool::workerMain() {
+    currentPool = this;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        Job *job = nullptr;
+        workCondition.wait(lock, [this, &job]() -> bool {
+            return stopped || (job = nextJob()) != nullptr;
+        });
+        if (!job)
+            return;
+        int threadNo = ++job->joinedWorkers;
+        ++job->activeWorkers;
+        lock.unlock();
+        participate(*job, threadNo);
+        lock.lock();
+        if (!--job->activeWorkers)
+            doneCondition.notify_all();
+    }
+}
+
+ThreadPool::Job *ThreadPool::nextJob() {
+    for (Job *job : jobs) {
+        if (job->joinedWorkers+1 < job->threads)
+            return job;
+    }
+    return nullptr;
+}
+
+void ThreadPool::participate(Job &job, int threadNo) {
+    for (int i = nextChunk(job, threadNo); i >= 0 && job.result; i = nextChunk(job, threadNo)) {
+        if (!(*job.function)(i, threadNo))
+            job.result = false;
+    }
+}
+
+int ThreadPool::nextChunk(Job &job, int threadNo) {
+    // Take the next chunk from the front of own range
+    std::atomic<unsigned long long> &own = job.slots[threadNo].range;
+    for (unsigned long long range = own.load(); RANGE_BEGIN(range) < RANGE_END(range);) {
+        if (own.compare_exchange_weak(range, RANGE_PACK(RANGE_BEGIN(range)+1, RANGE_END(range))))
+            return RANGE_BEGIN(range);
+    }
+    // Steal the back half of another thread's remaining range
+    for (int offset = 1; offset < job.threads; ++offset) {
+        std::atomic<unsigned long long> &victim = job.slots[(threadNo+offset)%job.threads].range;
+        for (unsigned long long range = victim.load(); RANGE_BEGIN(range) < RANGE_END(range);) {
+            int begin = RANGE_BEGIN(range), end = RANGE_END(range);
+            int split = end-(end-begin+1)/2;
+            if (victim.compare_exchange_weak(range, RANGE_PACK(begin, split))) {
+                own = RANGE_PACK(split+1, end);
+                return split;
+            }
+        }
+    }
+    return -1;
+}
+
+bool ThreadPool::applyAffinity(std::thread &thread, int cpu) {
+#if defined(_WIN32)
+    DWORD_PTR processMask, systemMask;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+        return false;
+    DWORD_PTR mask = processMask;
+    if (cpu >= 0) {
+        if (cpu >= (int) (8*sizeof(DWORD_PTR)))
+            return false;
+        mask = (DWORD_PTR) 1<<cpu;
+    }
+    return SetThreadAffinityMask((HANDLE) thread.native_handle(), mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (cpu >= 0) {
+        if (cpu >= CPU_SETSIZE)
+            return false;
+        CPU_SET(cpu, &cpuSet);
+    } else {
+        for (int i = 0; i < CPU_SETSIZE; ++i)
+            CPU_SET(i, &cpuSet);
+    }
+    return !pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet);
+#else
+    (void) thread, (void) cpu;
+    return false;
+#endif
+}
+
+}
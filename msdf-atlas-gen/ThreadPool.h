@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include "types.h"
+
+namespace msdf_atlas {
+
+/**
+ * A set of long-lived worker threads which process workloads split into chunks
+ * so that threads don't have to be created for each batch of glyphs.
+ * The worker function has the same form as in Workload:
+ *     bool FN(int chunk, int threadNo);
+ * Thread i of threadCount initially receives the contiguous range of chunks
+ * [chunks*i/threadCount, chunks*(i+1)/threadCount) and processes it in order,
+ * and a thread which runs out of work steals half of the remaining range of another thread.
+ * The calling thread also participates in the work as threadNo 0.
+ * Workloads run concurrently from multiple threads share the workers - a worker joins the oldest workload
+ * which still accepts more threads, and the calling thread steals the ranges of threads which never joined.
+ * A workload run from within a worker function of the same pool is processed sequentially by the calling thread.
+ */
+class ThreadPool {
+
+public:
+    /// Returns the process-wide pool used by Workload and the atlas generators by default
+    static ThreadPool &getDefault();
+
+    explicit ThreadPool(int workerCount = 0);
+    ThreadPool(const ThreadPool &) = delete;
+    ~ThreadPool();
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    /// Starts additional worker threads so that at least workerCount of them are available
+    void reserveWorkers(int workerCount);
+    /// Returns the number of worker threads (excluding the calling thread)
+    int getWorkerCount() const;
+    /// Pins worker thread workerNo to the given CPU, or allows it to run on any CPU if cpu is negative. Returns false if not supported by the platform
+    bool setAffinity(int workerNo, int cpu);
+    /// Processes all chunks using up to threadCount threads (including the calling one) and returns true if all chunks have been processed
+    bool run(const std::function<bool(int, int)> &workerFunction, int chunks, int threadCount);
+    /// Joins all worker threads once they finish their part of the current workloads - any further workloads will be processed by the calling thread only. Must not be called from a worker function
+    void shutdown();
+
+private:
+    struct RangeSlot {
+        std::atomic<unsigned long long> range;
+        char padding[64-sizeof(std::atomic<unsigned long long>)];
+    };
+
+    /// A workload in progress, owned by the thread which called run
+    struct Job {
+        const std::function<bool(int, int)> *function;
+        RangeSlot *slots;
+        int threads;
+        int joinedWorkers;
+        int activeWorkers;
+        std::atomic<bool> result;
+    };
+
+    std::vector<std::thread, Allocator<std::thread>> workers;
+    std::vector<int, Allocator<int>> affinity;
+    mutable std::mutex mutex;
+    std::condition_variable workCondition, doneCondition;
+    std::vector<Job *, Allocator<Job *>> jobs;
+    bool stopped;
+
+    void workerMain();
+    Job *nextJob();
+    static void participate(Job &job, int threadNo);
+    static int nextChunk(Job &job, int threadNo);
+    static bool applyAffinity(std::thread &thread, int cpu);
+
+};
+
+}
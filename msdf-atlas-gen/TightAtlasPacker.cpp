@@ -2,15 +2,37 @@
 #include "TightAtlasPacker.h"
 
 #include <vector>
+#include <algorithm>
 #include "Rectangle.h"
 #include "rectangle-packing.h"
+#include "RectanglePacker.h"
+#include "SkylinePacker.h"
 #include "size-selectors.h"
+#include "Workload.h"
 
 namespace msdf_atlas {
 
+template <class Packer>
+static std::pair<int, int> packRectanglesConstrained(Rectangle *rectangles, int count, DimensionsConstraint dimensionsConstraint, int spacing) {
+    switch (dimensionsConstraint) {
+        case DimensionsConstraint::POWER_OF_TWO_SQUARE:
+            return packRectangles<Packer, SquarePowerOfTwoSizeSelector>(rectangles, count, spacing);
+        case DimensionsConstraint::POWER_OF_TWO_RECTANGLE:
+            return packRectangles<Packer, PowerOfTwoSizeSelector>(rectangles, count, spacing);
+        case DimensionsConstraint::MULTIPLE_OF_FOUR_SQUARE:
+            return packRectangles<Packer, SquareSizeSelector<4> >(rectangles, count, spacing);
+        case DimensionsConstraint::EVEN_SQUARE:
+            return packRectangles<Packer, SquareSizeSelector<2> >(rectangles, count, spacing);
+        case DimensionsConstraint::SQUARE:
+        default:
+            return packRectangles<Packer, SquareSizeSelector<> >(rectangles, count, spacing);
+    }
+}
+
 TightAtlasPacker::TightAtlasPacker() :
     width(-1), height(-1),
     spacing(0),
+    skylinePacking(false),
     dimensionsConstraint(DimensionsConstraint::POWER_OF_TWO_SQUARE),
     scale(-1),
     minScale(1),
@@ -18,15 +40,11 @@ TightAtlasPacker::TightAtlasPacker() :
     pxRange(0),
     miterLimit(0),
     pxAlignOriginX(false), pxAlignOriginY(false),
-    scaleMaximizationTolerance(.001)
+    scaleMaximizationTolerance(.001),
+    threadCount(1)
 { }
 
-int TightAtlasPacker::tryPack(GlyphGeometry *glyphs, int count, DimensionsConstraint dimensionsConstraint, int &width, int &height, double scale) const {
-    // Wrap glyphs into boxes
-    std::vector<Rectangle, Allocator<Rectangle>> rectangles;
-    std::vector<GlyphGeometry *, Allocator<GlyphGeometry *>> rectangleGlyphs;
-    rectangles.reserve(count);
-    rectangleGlyphs.reserve(count);
+GlyphGeometry::GlyphAttributes TightAtlasPacker::getGlyphAttributes(double scale) const {
     GlyphGeometry::GlyphAttributes attribs = { };
     attribs.scale = scale;
     attribs.range = unitRange+pxRange/scale;
@@ -35,6 +53,16 @@ int TightAtlasPacker::tryPack(GlyphGeometry *glyphs, int count, DimensionsConstr
     attribs.miterLimit = miterLimit;
     attribs.pxAlignOriginX = pxAlignOriginX;
     attribs.pxAlignOriginY = pxAlignOriginY;
+    return attribs;
+}
+
+int TightAtlasPacker::tryPack(GlyphGeometry *glyphs, int count, DimensionsConstraint dimensionsConstraint, int &width, int &height, double scale) const {
+    // Wrap glyphs into boxes
+    std::vector<Rectangle, Allocator<Rectangle>> rectangles;
+    std::vector<GlyphGeometry *, Allocator<GlyphGeometry *>> rectangleGlyphs;
+    rectangles.reserve(count);
+    rectangleGlyphs.reserve(count);
+    GlyphGeometry::GlyphAttributes attribs = getGlyphAttributes(scale);
     for (GlyphGeometry *glyph = glyphs, *end = glyphs+count; glyph < end; ++glyph) {
         if (!glyph->isWhitespace()) {
             Rectangle rect = { };
@@ -54,30 +82,17 @@ int TightAtlasPacker::tryPack(GlyphGeometry *glyphs, int count, DimensionsConstr
     }
     // Box rectangle packing
     if (width < 0 || height < 0) {
-        std::pair<int, int> dimensions = std::make_pair(width, height);
-        switch (dimensionsConstraint) {
-            case DimensionsConstraint::POWER_OF_TWO_SQUARE:
-                dimensions = packRectangles<SquarePowerOfTwoSizeSelector>(rectangles.data(), rectangles.size(), spacing);
-                break;
-            case DimensionsConstraint::POWER_OF_TWO_RECTANGLE:
-                dimensions = packRectangles<PowerOfTwoSizeSelector>(rectangles.data(), rectangles.size(), spacing);
-                break;
-            case DimensionsConstraint::MULTIPLE_OF_FOUR_SQUARE:
-                dimensions = packRectangles<SquareSizeSelector<4> >(rectangles.data(), rectangles.size(), spacing);
-                break;
-            case DimensionsConstraint::EVEN_SQUARE:
-                dimensions = packRectangles<SquareSizeSelector<2> >(rectangles.data(), rectangles.size(), spacing);
-                break;
-            case DimensionsConstraint::SQUARE:
-            default:
-                dimensions = packRectangles<SquareSizeSelector<> >(rectangles.data(), rectangles.size(), spacing);
-                break;
-        }
+        std::pair<int, int> dimensions = skylinePacking ?
+            packRectanglesConstrained<SkylinePacker>(rectangles.data(), rectangles.size(), dimensionsConstraint, spacing) :
+            packRectanglesConstrained<RectanglePacker>(rectangles.data(), rectangles.size(), dimensionsConstraint, spacing);
         if (!(dimensions.first > 0 && dimensions.second > 0))
             return -1;
         width = dimensions.first, height = dimensions.second;
     } else {
-        if (int result = packRectangles(rectangles.data(), rectangles.size(), width, height, spacing))
+        int result = skylinePacking ?
+            packRectangles<SkylinePacker>(rectangles.data(), rectangles.size(), width, height, spacing) :
+            packRectangles<RectanglePacker>(rectangles.data(), rectangles.size(), width, height, spacing);
+        if (result)
             return result;
     }
     // Set glyph box placement
@@ -86,29 +101,92 @@ int TightAtlasPacker::tryPack(GlyphGeometry *glyphs, int count, DimensionsConstr
     return 0;
 }
 
+bool TightAtlasPacker::fits(const GlyphGeometry *glyphs, int count, int width, int height, double scale, std::vector<Rectangle, Allocator<Rectangle>> &rectangles) const {
+    rectangles.clear();
+    GlyphGeometry::GlyphAttributes attribs = getGlyphAttributes(scale);
+    for (const GlyphGeometry *glyph = glyphs, *end = glyphs+count; glyph < end; ++glyph) {
+        if (!glyph->isWhitespace()) {
+            Rectangle rect = glyph->computeBox(attribs).rect;
+            if (rect.w > 0 && rect.h > 0)
+                rectangles.push_back(rect);
+        }
+    }
+    if (rectangles.empty())
+        return true;
+    if (skylinePacking)
+        return !packRectangles<SkylinePacker>(rectangles.data(), rectangles.size(), width, height, spacing);
+    return !packRectangles<RectanglePacker>(rectangles.data(), rectangles.size(), width, height, spacing);
+}
+
 double TightAtlasPacker::packAndScale(GlyphGeometry *glyphs, int count) const {
-    bool lastResult = false;
+    // Up to threadCount candidate scales are evaluated concurrently in each step, each with its own rectangle array
+    int candidateCount = std::max(threadCount, 1);
+    std::vector<double, Allocator<double>> candidates(candidateCount);
+    std::vector<char, Allocator<char>> results(candidateCount);
+    std::vector<std::vector<Rectangle, Allocator<Rectangle>>, Allocator<std::vector<Rectangle, Allocator<Rectangle>>>> rectangleBuffers(candidateCount);
     int w = width, h = height;
-    #define TRY_PACK(scale) (lastResult = !tryPack(glyphs, count, DimensionsConstraint(), w, h, (scale)))
+    auto evaluate = [&](int n) {
+        Workload([&](int i, int threadNo) -> bool {
+            results[i] = fits(glyphs, count, w, h, candidates[i], rectangleBuffers[threadNo]);
+            return true;
+        }, n).finish(candidateCount);
+    };
     double minScale = 1, maxScale = 1;
-    if (TRY_PACK(1)) {
-        while (maxScale < 1e+32 && ((maxScale = 2*minScale), TRY_PACK(maxScale)))
-            minScale = maxScale;
+    candidates[0] = 1;
+    evaluate(1);
+    if (results[0]) {
+        // Find the first scale that doesn't fit by repeated doubling
+        while (maxScale < 1e+32) {
+            int n = 0;
+            for (double s = minScale; n < candidateCount && s < 1e+32; ++n)
+                candidates[n] = s *= 2;
+            evaluate(n);
+            int i = 0;
+            while (i < n && results[i])
+                ++i;
+            if (i < n) {
+                if (i)
+                    minScale = candidates[i-1];
+                maxScale = candidates[i];
+                break;
+            }
+            minScale = maxScale = candidates[n-1];
+        }
     } else {
-        while (minScale > 1e-32 && ((minScale = .5*maxScale), !TRY_PACK(minScale)))
-            maxScale = minScale;
+        // Find the first scale that fits by repeated halving
+        while (minScale > 1e-32) {
+            int n = 0;
+            for (double s = maxScale; n < candidateCount && s > 1e-32; ++n)
+                candidates[n] = s *= .5;
+            evaluate(n);
+            int i = 0;
+            while (i < n && !results[i])
+                ++i;
+            if (i < n) {
+                if (i)
+                    maxScale = candidates[i-1];
+                minScale = candidates[i];
+                break;
+            }
+            minScale = maxScale = candidates[n-1];
+        }
     }
     if (minScale == maxScale)
         return 0;
+    // Narrow down the interval by splitting it into candidateCount+1 parts and keeping the largest scale that fits
     while (minScale/maxScale < 1-scaleMaximizationTolerance) {
-        double midScale = .5*(minScale+maxScale);
-        if (TRY_PACK(midScale))
-            minScale = midScale;
-        else
-            maxScale = midScale;
+        for (int i = 0; i < candidateCount; ++i)
+            candidates[i] = ((candidateCount-i)*minScale+(i+1)*maxScale)/(candidateCount+1);
+        evaluate(candidateCount);
+        int best = candidateCount-1;
+        while (best >= 0 && !results[best])
+            --best;
+        if (best >= 0)
+            minScale = candidates[best];
+        if (best+1 < candidateCount)
+            maxScale = candidates[best+1];
     }
-    if (!lastResult)
-        TRY_PACK(minScale);
+    tryPack(glyphs, count, DimensionsConstraint(), w, h, minScale);
     return minScale;
 }
 
@@ -142,6 +220,10 @@ void TightAtlasPacker::setSpacing(int spacing) {
     this->spacing = spacing;
 }
 
+void TightAtlasPacker::setSkylinePacking(bool enable) {
+    skylinePacking = enable;
+}
+
 void TightAtlasPacker::setScale(double scale) {
     this->scale = scale;
 }
@@ -186,6 +268,10 @@ void TightAtlasPacker::setOuterPixelPadding(const Padding &padding) {
     outerPxPadding = padding;
 }
 
+void TightAtlasPacker::setThreadCount(int threadCount) {
+    this->threadCount = threadCount;
+}
+
 void TightAtlasPacker::getDimensions(int &width, int &height) const {
     width = this->width, height = this->height;
 }
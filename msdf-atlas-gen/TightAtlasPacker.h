@@ -1,7 +1,9 @@
 
 #pragma once
 
+#include <vector>
 #include "types.h"
+#include "Rectangle.h"
 #include "Padding.h"
 #include "GlyphGeometry.h"
 
@@ -27,6 +29,8 @@ public:
     void setDimensionsConstraint(DimensionsConstraint dimensionsConstraint);
     /// Sets the spacing between glyph boxes
     void setSpacing(int spacing);
+    /// Sets whether the faster but less dense SkylinePacker should be used instead of RectanglePacker
+    void setSkylinePacking(bool enable);
     /// Sets fixed glyph scale
     void setScale(double scale);
     /// Sets the minimum glyph scale
@@ -48,6 +52,8 @@ public:
     void setInnerPixelPadding(const Padding &padding);
     /// Sets the pixel component of width of additional padding around each glyph quad
     void setOuterPixelPadding(const Padding &padding);
+    /// Sets the number of candidate scales evaluated concurrently when maximizing glyph scale
+    void setThreadCount(int threadCount);
 
     /// Outputs the atlas's final dimensions
     void getDimensions(int &width, int &height) const;
@@ -59,6 +65,7 @@ public:
 private:
     int width, height;
     int spacing;
+    bool skylinePacking;
     DimensionsConstraint dimensionsConstraint;
     double scale;
     double minScale;
@@ -69,8 +76,12 @@ private:
     Padding innerUnitPadding, outerUnitPadding;
     Padding innerPxPadding, outerPxPadding;
     double scaleMaximizationTolerance;
+    int threadCount;
 
+    GlyphGeometry::GlyphAttributes getGlyphAttributes(double scale) const;
     int tryPack(GlyphGeometry *glyphs, int count, DimensionsConstraint dimensionsConstraint, int &width, int &height, double scale) const;
+    /// Checks if the glyphs fit into the atlas with fixed dimensions at the given scale without modifying them, rectangles is a working buffer
+    bool fits(const GlyphGeometry *glyphs, int count, int width, int height, double scale, std::vector<Rectangle, Allocator<Rectangle>> &rectangles) const;
     double packAndScale(GlyphGeometry *glyphs, int count) const;
 
 };
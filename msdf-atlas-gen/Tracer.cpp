@@ -0,0 +1,55 @@
+
+#include "Tracer.h"
+
+#include <cstdio>
+
+namespace msdf_atlas {
+
+static double microseconds(Tracer::TimePoint time, Tracer::TimePoint epoch) {
+    return std::chrono::duration<double, std::micro>(time-epoch).count();
+}
+
+Tracer::Tracer() : epoch(now()), threadEvents(1) { }
+
+Tracer::TimePoint Tracer::now() {
+    return std::chrono::steady_clock::now();
+}
+
+void Tracer::reserveThreads(int threadCount) {
+    if (threadCount > (int) threadEvents.size())
+        threadEvents.resize(threadCount);
+}
+
+void Tracer::record(int threadNo, const char *stage, int glyphIndex, TimePoint begin, TimePoint end) {
+    Event event;
+    event.stage = stage;
+    event.glyphIndex = glyphIndex;
+    event.begin = begin;
+    event.end = end;
+    threadEvents[threadNo].push_back(event);
+}
+
+bool Tracer::exportJSON(const char *filename) const {
+    FILE *f = fopen(filename, "w");
+    if (!f)
+        return false;
+
+    fputs("{\"traceEvents\":[", f);
+    bool first = true;
+    for (int threadNo = 0; threadNo < (int) threadEvents.size(); ++threadNo) {
+        fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"Thread %d\"}}", first ? "" : ",", threadNo, threadNo);
+        first = false;
+        for (const Event &event : threadEvents[threadNo]) {
+            fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"msdf-atlas-gen\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f", event.stage, threadNo, microseconds(event.begin, epoch), microseconds(event.end, event.begin));
+            if (event.glyphIndex >= 0)
+                fprintf(f, ",\"args\":{\"glyph\":%d}", event.glyphIndex);
+            fputs("}", f);
+        }
+    }
+    fputs("\n],\"displayTimeUnit\":\"ms\"}\n", f);
+
+    fclose(f);
+    return true;
+}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include "types.h"
+
+namespace msdf_atlas {
+
+/**
+ * Records timed spans of the atlas generation process, such as the processing of individual glyphs,
+ * and writes them as a Trace Event Format JSON file, which can be viewed in chrome://tracing or Perfetto.
+ * Each thread has its own list of events, so record may be called concurrently
+ * as long as each thread uses a different threadNo within the reserved thread count.
+ */
+class Tracer {
+
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    Tracer();
+    /// Returns the current time point to be used as the beginning or end of a span
+    static TimePoint now();
+    /// Makes sure that threads with numbers up to threadCount-1 can record events. Must not be called concurrently with record
+    void reserveThreads(int threadCount);
+    /// Records a span named stage (must be a string literal or otherwise outlive the Tracer) of the given glyph (-1 if not applicable)
+    void record(int threadNo, const char *stage, int glyphIndex, TimePoint begin, TimePoint end);
+    /// Writes the recorded events into a JSON file in the Trace Event Format
+    bool exportJSON(const char *filename) const;
+
+private:
+    struct Event {
+        const char *stage;
+        int glyphIndex;
+        TimePoint begin, end;
+    };
+
+    TimePoint epoch;
+    std::vector<std::vector<Event, Allocator<Event> >, Allocator<std::vector<Event, Allocator<Event> > > > threadEvents;
+
+};
+
+}
@@ -1,7 +1,7 @@
-
 #pragma once
 
 #include <functional>
+#include "ThreadPool.h"
 
 namespace msdf_atlas {
 
@@ -17,16 +17,15 @@ class Workload {
 public:
     Workload();
     Workload(const std::function<bool(int, int)> &workerFunction, int chunks);
-    /// Runs the process and returns true if all chunks have been processed
+    /// Runs the process on the default ThreadPool and returns true if all chunks have been processed
     bool finish(int threadCount);
+    /// Runs the process on the specified ThreadPool and returns true if all chunks have been processed
+    bool finish(ThreadPool &threadPool, int threadCount);
 
 private:
     std::function<bool(int, int)> workerFunction;
     int chunks;
 
-    bool finishSequential();
-    bool finishParallel(int threadCount);
-
 };
 
 }
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <msdfgen.h>
+#include "types.h"
+#include "Remap.h"
+
+namespace msdf_atlas {
+
+/**
+ * Moves the pixels of each source rectangle to its target within the same bitmap and clears the parts of sources not covered by targets.
+ * The moves are ordered so that no source is overwritten before it is moved, and only rectangles whose moves block each other
+ * in a cycle are copied into a scratch buffer. Sources must not overlap each other, and neither must targets.
+ */
+template <typename T, int N>
+void remapInPlace(const msdfgen::BitmapSection<T, N> &bitmap, const Remap *remapping, int count);
+
+}
+
+#include "bitmap-remap.hpp"
@@ -0,0 +1,146 @@
+
+#include "bitmap-remap.h"
+
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <utility>
+
+namespace msdf_atlas {
+
+template <typename T, int N>
+void remapInPlace(const msdfgen::BitmapSection<T, N> &bitmap, const Remap *remapping, int count) {
+    int width = bitmap.width, height = bitmap.height;
+    std::vector<int, Allocator<int>> moves;
+    int cellSize = 1;
+    for (int i = 0; i < count; ++i) {
+        const Remap &remap = remapping[i];
+        if ((remap.source.x != remap.target.x || remap.source.y != remap.target.y) && remap.width > 0 && remap.height > 0) {
+            moves.push_back(i);
+            cellSize = std::max(cellSize, std::max(remap.width, remap.height));
+        }
+    }
+    int moveCount = (int) moves.size();
+    if (!moveCount)
+        return;
+
+    // Index the sources in a grid of cells at least as large as any rectangle, so that each one covers at most 4 cells
+    int columns = (width+cellSize-1)/cellSize, rows = (height+cellSize-1)/cellSize;
+    std::vector<int, Allocator<int>> cellStart(columns*rows+1), cellSources;
+    std::vector<int, Allocator<int>> cellEnd;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < moveCount; ++i) {
+            const Remap &remap = remapping[moves[i]];
+            for (int cy = remap.source.y/cellSize; cy <= (remap.source.y+remap.height-1)/cellSize && cy < rows; ++cy) {
+                for (int cx = remap.source.x/cellSize; cx <= (remap.source.x+remap.width-1)/cellSize && cx < columns; ++cx) {
+                    if (pass)
+                        cellSources[cellEnd[cy*columns+cx]++] = i;
+                    else
+                        ++cellStart[cy*columns+cx+1];
+                }
+            }
+        }
+        if (!pass) {
+            for (int j = 0; j < columns*rows; ++j)
+                cellStart[j+1] += cellStart[j];
+            cellSources.resize(cellStart.back());
+            cellEnd.assign(cellStart.begin(), cellStart.end()-1);
+        }
+    }
+
+    // A move is blocked by every other move whose source overlaps its target until that source is vacated
+    std::vector<int, Allocator<int>> blockers(moveCount), dependentStart(moveCount+1), dependents, lastSeen(moveCount, -1);
+    std::vector<std::pair<int, int>, Allocator<std::pair<int, int>>> edges;
+    for (int i = 0; i < moveCount; ++i) {
+        const Remap &remap = remapping[moves[i]];
+        for (int cy = std::max(remap.target.y, 0)/cellSize; cy <= (remap.target.y+remap.height-1)/cellSize && cy < rows; ++cy) {
+            for (int cx = std::max(remap.target.x, 0)/cellSize; cx <= (remap.target.x+remap.width-1)/cellSize && cx < columns; ++cx) {
+                for (int k = cellStart[cy*columns+cx]; k < cellStart[cy*columns+cx+1]; ++k) {
+                    int j = cellSources[k];
+                    const Remap &other = remapping[moves[j]];
+                    if (j != i && lastSeen[j] != i &&
+                        remap.target.x < other.source.x+other.width && other.source.x < remap.target.x+remap.width &&
+                        remap.target.y < other.source.y+other.height && other.source.y < remap.target.y+remap.height
+                    ) {
+                        lastSeen[j] = i;
+                        ++blockers[i];
+                        ++dependentStart[j+1];
+                        edges.push_back(std::make_pair(j, i));
+                    }
+                }
+            }
+        }
+    }
+    for (int i = 0; i < moveCount; ++i)
+        dependentStart[i+1] += dependentStart[i];
+    dependents.resize(edges.size());
+    {
+        std::vector<int, Allocator<int>> dependentEnd(dependentStart.begin(), dependentStart.end()-1);
+        for (const std::pair<int, int> &edge : edges)
+            dependents[dependentEnd[edge.first]++] = edge.second;
+    }
+
+    std::vector<int, Allocator<int>> ready, scratchOffset(moveCount, -1);
+    std::vector<T, Allocator<T>> scratch;
+    std::vector<bool, Allocator<bool>> vacated(moveCount, false);
+    for (int i = moveCount-1; i >= 0; --i) {
+        if (!blockers[i])
+            ready.push_back(i);
+    }
+    int nextCycleBreak = 0;
+    for (int remaining = moveCount; remaining > 0;) {
+        if (ready.empty()) {
+            // All remaining moves block each other in cycles - move a source out of the way into the scratch buffer
+            while (vacated[nextCycleBreak])
+                ++nextCycleBreak;
+            int i = nextCycleBreak;
+            const Remap &remap = remapping[moves[i]];
+            scratchOffset[i] = (int) scratch.size();
+            scratch.resize(scratch.size()+N*remap.width*remap.height);
+            for (int y = 0; y < remap.height; ++y) {
+                memcpy(scratch.data()+scratchOffset[i]+N*remap.width*y, bitmap(remap.source.x, remap.source.y+y), sizeof(T)*N*remap.width);
+                memset(bitmap(remap.source.x, remap.source.y+y), 0, sizeof(T)*N*remap.width);
+            }
+            vacated[i] = true;
+            for (int k = dependentStart[i]; k < dependentStart[i+1]; ++k) {
+                if (!--blockers[dependents[k]])
+                    ready.push_back(dependents[k]);
+            }
+            continue;
+        }
+        int i = ready.back();
+        ready.pop_back();
+        const Remap &remap = remapping[moves[i]];
+        if (scratchOffset[i] >= 0) {
+            for (int y = 0; y < remap.height; ++y)
+                memcpy(bitmap(remap.target.x, remap.target.y+y), scratch.data()+scratchOffset[i]+N*remap.width*y, sizeof(T)*N*remap.width);
+        } else {
+            // Rows are copied in the direction that doesn't overwrite the rectangle's own rows not yet copied
+            for (int row = 0; row < remap.height; ++row) {
+                int y = remap.target.y > remap.source.y ? remap.height-1-row : row;
+                memmove(bitmap(remap.target.x, remap.target.y+y), bitmap(remap.source.x, remap.source.y+y), sizeof(T)*N*remap.width);
+            }
+            // Clear the part of the source not covered by the target
+            for (int y = remap.source.y; y < remap.source.y+remap.height; ++y) {
+                if (y < remap.target.y || y >= remap.target.y+remap.height)
+                    memset(bitmap(remap.source.x, y), 0, sizeof(T)*N*remap.width);
+                else {
+                    int leftEnd = std::min(remap.source.x+remap.width, remap.target.x);
+                    int rightBegin = std::max(remap.source.x, remap.target.x+remap.width);
+                    if (leftEnd > remap.source.x)
+                        memset(bitmap(remap.source.x, y), 0, sizeof(T)*N*(leftEnd-remap.source.x));
+                    if (remap.source.x+remap.width > rightBegin)
+                        memset(bitmap(rightBegin, y), 0, sizeof(T)*N*(remap.source.x+remap.width-rightBegin));
+                }
+            }
+            vacated[i] = true;
+            for (int k = dependentStart[i]; k < dependentStart[i+1]; ++k) {
+                if (!--blockers[dependents[k]])
+                    ready.push_back(dependents[k]);
+            }
+        }
+        --remaining;
+    }
+}
+
+}
@@ -0,0 +1,602 @@
+
+#include "block-compression.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "Workload.h"
+
+namespace msdf_atlas {
+
+/// Error weight of each byte value - values near 0.5 (glyph edges) count up to 16 times more than saturated ones
+class ValueWeights {
+
+public:
+    float weights[256];
+
+    ValueWeights() {
+        for (int i = 0; i < 256; ++i) {
+            double proximity = std::max(1-fabs(i-127.5)/64, 0.);
+            weights[i] = float(1+15*proximity*proximity);
+        }
+    }
+
+};
+
+static const ValueWeights valueWeights;
+
+static int clampByte(double value) {
+    return std::min(std::max((int) floor(value+.5), 0), 255);
+}
+
+/// Copies a block of 4x4 pixels (row by row from the top) into texels, repeating edge pixels beyond the bitmap's bounds
+template <int N>
+static void fetchBlock(byte *texels, const msdfgen::BitmapConstRef<byte, N> &bitmap, int blockX, int blockY) {
+    for (int y = 0; y < 4; ++y) {
+        int row = bitmap.height-1-std::min(4*blockY+y, bitmap.height-1);
+        for (int x = 0; x < 4; ++x) {
+            const byte *pixel = bitmap(std::min(4*blockX+x, bitmap.width-1), row);
+            for (int i = 0; i < N; ++i)
+                texels[N*(4*y+x)+i] = pixel[i];
+        }
+    }
+}
+
+static void writeBits(byte *block, int &pos, unsigned value, int bits) {
+    for (int i = 0; i < bits; ++i, ++pos) {
+        if (value>>i&1)
+            block[pos>>3] |= byte(1<<(pos&7));
+    }
+}
+
+// BC4
+
+/// Returns the interpolation parameter between e0 and e1 of a BC4 index, or a negative value for the constant 0 and 255 entries
+static float bc4Parameter(int index, bool sixValues) {
+    if (index < 2)
+        return float(index);
+    if (sixValues)
+        return index < 6 ? float(index-1)/5.f : -1.f;
+    return float(index-1)/7.f;
+}
+
+/// Finds the best index of each value for endpoints e0, e1 and returns the total weighted squared error
+static float bc4Indices(byte *indices, const byte *values, const float *weights, int e0, int e1) {
+    bool sixValues = e0 <= e1;
+    float palette[8];
+    for (int i = 0; i < 8; ++i) {
+        float t = bc4Parameter(i, sixValues);
+        palette[i] = t >= 0 ? (1-t)*e0+t*e1 : i == 6 ? 0.f : 255.f;
+    }
+    float totalError = 0;
+    for (int i = 0; i < 16; ++i) {
+        float bestError = 1e30f;
+        for (int j = 0; j < 8; ++j) {
+            float delta = values[i]-palette[j];
+            if (delta*delta < bestError) {
+                bestError = delta*delta;
+                indices[i] = byte(j);
+            }
+        }
+        totalError += weights[i]*bestError;
+    }
+    return totalError;
+}
+
+/// Weighted least squares fit of the endpoints to the values given their indices
+static bool bc4Fit(int &e0, int &e1, const byte *values, const float *weights, const byte *indices, bool sixValues) {
+    double a00 = 0, a01 = 0, a11 = 0, b0 = 0, b1 = 0;
+    for (int i = 0; i < 16; ++i) {
+        double t = bc4Parameter(indices[i], sixValues);
+        if (t < 0)
+            continue;
+        a00 += weights[i]*(1-t)*(1-t);
+        a01 += weights[i]*t*(1-t);
+        a11 += weights[i]*t*t;
+        b0 += weights[i]*(1-t)*values[i];
+        b1 += weights[i]*t*values[i];
+    }
+    double det = a00*a11-a01*a01;
+    if (fabs(det) < 1e-9)
+        return false;
+    e0 = clampByte((b0*a11-b1*a01)/det);
+    e1 = clampByte((a00*b1-a01*b0)/det);
+    return true;
+}
+
+static void encodeBc4Block(byte *output, const byte *values) {
+    float weights[16];
+    int minValue = 255, maxValue = 0, minInner = 255, maxInner = 0;
+    for (int i = 0; i < 16; ++i) {
+        weights[i] = valueWeights.weights[values[i]];
+        minValue = std::min(minValue, (int) values[i]);
+        maxValue = std::max(maxValue, (int) values[i]);
+        if (values[i] > 0 && values[i] < 255) {
+            minInner = std::min(minInner, (int) values[i]);
+            maxInner = std::max(maxInner, (int) values[i]);
+        }
+    }
+    byte indices[16], bestIndices[16] = { };
+    int bestE0 = minValue, bestE1 = minValue;
+    float bestError = 1e30f;
+    auto tryEndpoints = [&](int e0, int e1) -> bool {
+        float error = bc4Indices(indices, values, weights, e0, e1);
+        if (error < bestError) {
+            bestError = error;
+            bestE0 = e0, bestE1 = e1;
+            memcpy(bestIndices, indices, sizeof(indices));
+            return true;
+        }
+        return false;
+    };
+
+    // Mode with 8 interpolated values, which requires e0 > e1
+    if (maxValue > minValue) {
+        int e0 = maxValue, e1 = minValue;
+        for (int iteration = 0; iteration < 3; ++iteration) {
+            tryEndpoints(e0, e1);
+            if (!bc4Fit(e0, e1, values, weights, indices, false))
+                break;
+            if (e0 < e1)
+                std::swap(e0, e1);
+            if (e0 == e1) {
+                if (e0 < 255)
+                    ++e0;
+                else
+                    --e1;
+            }
+        }
+    }
+    // Mode with 6 interpolated values and constant 0 and 255, which requires e0 <= e1
+    if (minInner > maxInner)
+        minInner = maxInner = minValue == 255 ? 255 : 0;
+    {
+        int e0 = minInner, e1 = maxInner;
+        for (int iteration = 0; iteration < 3; ++iteration) {
+            tryEndpoints(e0, e1);
+            if (!bc4Fit(e0, e1, values, weights, indices, true))
+                break;
+            if (e0 > e1)
+                std::swap(e0, e1);
+        }
+    }
+    // Local search around the best endpoints
+    int centerE0 = bestE0, centerE1 = bestE1;
+    for (int d0 = -2; d0 <= 2; ++d0) {
+        for (int d1 = -2; d1 <= 2; ++d1) {
+            int e0 = centerE0+d0, e1 = centerE1+d1;
+            // Both endpoints must stay in the same mode
+            if ((d0 || d1) && e0 >= 0 && e0 <= 255 && e1 >= 0 && e1 <= 255 && (e0 > e1) == (centerE0 > centerE1))
+                tryEndpoints(e0, e1);
+        }
+    }
+
+    output[0] = byte(bestE0);
+    output[1] = byte(bestE1);
+    unsigned long long bits = 0;
+    for (int i = 0; i < 16; ++i)
+        bits |= (unsigned long long) bestIndices[i]<<3*i;
+    for (int i = 0; i < 6; ++i)
+        output[2+i] = byte(bits>>8*i);
+}
+
+// BC7 - mode 6 (one subset, RGBA) for all blocks, mode 1 (two subsets, RGB) for opaque blocks and mode 7 (two subsets, RGBA) for others
+
+/// Layout parameters of a BC7 mode
+struct Bc7Mode {
+    int mode;
+    int partitionBits;
+    /// Bits per endpoint channel excluding the p-bit
+    int endpointBits;
+    bool sharedPBit;
+    int indexBits;
+    int channels;
+};
+
+static const Bc7Mode bc7Mode1 = { 1, 6, 6, true, 3, 3 };
+static const Bc7Mode bc7Mode6 = { 6, 0, 7, false, 4, 4 };
+static const Bc7Mode bc7Mode7 = { 7, 6, 5, false, 2, 4 };
+
+/// Interpolation weights (out of 64) of 2-bit, 3-bit, and 4-bit indices
+static const int bc7Weights2[4] = { 0, 21, 43, 64 };
+static const int bc7Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const int bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+/// Texels of the second subset of each two-subset partition as bit masks
+static const unsigned short bc7Partitions2[64] = {
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80, 0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+    0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce, 0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+    0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a, 0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+    0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c, 0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22
+};
+
+/// Anchor texel of the second subset of each two-subset partition
+static const byte bc7Anchors2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+    15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+    6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15
+};
+
+/// Quantized endpoints of one subset
+struct Bc7Subset {
+    int quantized[2][4];
+    int pBits[2];
+};
+
+static const int *bc7Weights(const Bc7Mode &mode) {
+    switch (mode.indexBits) {
+        case 2:
+            return bc7Weights2;
+        case 3:
+            return bc7Weights3;
+    }
+    return bc7Weights4;
+}
+
+/// Expands a quantized endpoint channel with its p-bit to 8 bits
+static int bc7Unquantize(int value, int pBit, const Bc7Mode &mode) {
+    int bits = mode.endpointBits+1;
+    value = value<<1|pBit;
+    return value<<(8-bits)|value>>(2*bits-8);
+}
+
+/// Finds the best index of each texel of the subset (mask) for the 8-bit endpoints and returns the total weighted squared error
+static float bc7Indices(byte *indices, const byte *texels, const float *weights, int mask, const int endpoints[2][4], const Bc7Mode &mode) {
+    const int *interpolation = bc7Weights(mode);
+    int maxIndex = (1<<mode.indexBits)-1;
+    int palette[16][4];
+    for (int i = 0; i <= maxIndex; ++i) {
+        for (int c = 0; c < 4; ++c)
+            palette[i][c] = ((64-interpolation[i])*endpoints[0][c]+interpolation[i]*endpoints[1][c]+32)>>6;
+    }
+    float direction[4], directionSquared = 0;
+    for (int c = 0; c < 4; ++c) {
+        direction[c] = float(endpoints[1][c]-endpoints[0][c]);
+        directionSquared += direction[c]*direction[c];
+    }
+    float totalError = 0;
+    for (int i = 0; i < 16; ++i) {
+        if (!(mask>>i&1))
+            continue;
+        const byte *texel = texels+4*i;
+        const float *texelWeights = weights+4*i;
+        // Only the indices around the texel's projection onto the endpoint line are evaluated
+        int nearest = 0;
+        if (directionSquared > 0) {
+            float t = 0;
+            for (int c = 0; c < 4; ++c)
+                t += (texel[c]-endpoints[0][c])*direction[c];
+            nearest = std::min(std::max((int) floor(maxIndex*t/directionSquared+.5f), 0), maxIndex);
+        }
+        float bestError = 1e30f;
+        for (int j = std::max(nearest-2, 0); j <= std::min(nearest+2, maxIndex); ++j) {
+            float error = 0;
+            for (int c = 0; c < 4; ++c) {
+                float delta = float(texel[c]-palette[j][c]);
+                error += texelWeights[c]*delta*delta;
+            }
+            if (error < bestError) {
+                bestError = error;
+                indices[i] = byte(j);
+            }
+        }
+        totalError += bestError;
+    }
+    return totalError;
+}
+
+/// Computes the weighted mean and principal axis (unit length) of the texels of the subset (mask), returns their weighted variance off the axis
+static float bc7PrincipalAxis(float mean[4], float axis[4], const byte *texels, const float *weights, int mask) {
+    float texelWeights[16], totalWeight = 0;
+    for (int c = 0; c < 4; ++c)
+        mean[c] = 0;
+    for (int i = 0; i < 16; ++i) {
+        texelWeights[i] = mask>>i&1 ? .25f*(weights[4*i]+weights[4*i+1]+weights[4*i+2]+weights[4*i+3]) : 0.f;
+        for (int c = 0; c < 4; ++c)
+            mean[c] += texelWeights[i]*texels[4*i+c];
+        totalWeight += texelWeights[i];
+    }
+    for (int c = 0; c < 4; ++c) {
+        mean[c] /= totalWeight;
+        axis[c] = 0;
+    }
+    float covariance[4][4] = { };
+    for (int i = 0; i < 16; ++i) {
+        if (!texelWeights[i])
+            continue;
+        float delta[4];
+        for (int c = 0; c < 4; ++c)
+            delta[c] = texels[4*i+c]-mean[c];
+        for (int c = 0; c < 4; ++c) {
+            for (int d = 0; d < 4; ++d)
+                covariance[c][d] += texelWeights[i]*delta[c]*delta[d];
+        }
+    }
+    // Power iteration starting from the covariance of the channel with the largest variance (never orthogonal to the principal axis)
+    int maxChannel = 0;
+    for (int c = 1; c < 4; ++c) {
+        if (covariance[c][c] > covariance[maxChannel][maxChannel])
+            maxChannel = c;
+    }
+    float trace = covariance[0][0]+covariance[1][1]+covariance[2][2]+covariance[3][3];
+    if (covariance[maxChannel][maxChannel] <= 0)
+        return 0;
+    for (int c = 0; c < 4; ++c)
+        axis[c] = covariance[maxChannel][c];
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        float next[4] = { }, length = 0;
+        for (int c = 0; c < 4; ++c) {
+            for (int d = 0; d < 4; ++d)
+                next[c] += covariance[c][d]*axis[d];
+            length = std::max(length, fabsf(next[c]));
+        }
+        if (length <= 0)
+            break;
+        for (int c = 0; c < 4; ++c)
+            axis[c] = next[c]/length;
+    }
+    float length = sqrtf(axis[0]*axis[0]+axis[1]*axis[1]+axis[2]*axis[2]+axis[3]*axis[3]);
+    float variance = 0;
+    for (int c = 0; c < 4; ++c) {
+        axis[c] /= length;
+        for (int d = 0; d < 4; ++d)
+            variance += axis[c]*covariance[c][d]*axis[d];
+    }
+    return std::max(trace-variance, 0.f);
+}
+
+/// Weighted least squares fit of the endpoints of each channel to the texels of the subset (mask) given their indices
+static void bc7Fit(float endpoints[2][4], const byte *texels, const float *weights, int mask, const byte *indices, const Bc7Mode &mode) {
+    const int *interpolation = bc7Weights(mode);
+    for (int c = 0; c < 4; ++c) {
+        double a00 = 0, a01 = 0, a11 = 0, b0 = 0, b1 = 0, totalWeight = 0, weightedSum = 0;
+        for (int i = 0; i < 16; ++i) {
+            if (!(mask>>i&1))
+                continue;
+            double t = interpolation[indices[i]]/64., w = weights[4*i+c];
+            a00 += w*(1-t)*(1-t);
+            a01 += w*t*(1-t);
+            a11 += w*t*t;
+            b0 += w*(1-t)*texels[4*i+c];
+            b1 += w*t*texels[4*i+c];
+            totalWeight += w;
+            weightedSum += w*texels[4*i+c];
+        }
+        double det = a00*a11-a01*a01;
+        if (fabs(det) > 1e-9) {
+            endpoints[0][c] = float(std::min(std::max((b0*a11-b1*a01)/det, 0.), 255.));
+            endpoints[1][c] = float(std::min(std::max((a00*b1-a01*b0)/det, 0.), 255.));
+        } else if (totalWeight > 0)
+            endpoints[0][c] = endpoints[1][c] = float(weightedSum/totalWeight);
+    }
+}
+
+/// Quantizes the endpoints with the p-bit combination of the lowest error, returns the error
+static float bc7Quantize(Bc7Subset &subset, byte *indices, const float endpoints[2][4], const byte *texels, const float *weights, int mask, const Bc7Mode &mode, bool opaque) {
+    int maxValue = (1<<mode.endpointBits)-1;
+    float scale = float((2<<mode.endpointBits)-1)/255.f;
+    float bestError = 1e30f;
+    byte candidateIndices[16];
+    for (int p = 0; p < 4; ++p) {
+        int pBits[2] = { p&1, p>>1 };
+        // Opaque blocks keep both p-bits of RGBA endpoints set so that alpha is exactly 255
+        if ((mode.sharedPBit && pBits[0] != pBits[1]) || (opaque && mode.channels == 4 && p != 3))
+            continue;
+        Bc7Subset candidate;
+        int unquantized[2][4];
+        for (int j = 0; j < 2; ++j) {
+            candidate.pBits[j] = pBits[j];
+            for (int c = 0; c < 4; ++c) {
+                if (c < mode.channels) {
+                    candidate.quantized[j][c] = opaque && c == 3 ? maxValue : std::min(std::max((int) floor((scale*endpoints[j][c]-pBits[j])/2+.5f), 0), maxValue);
+                    unquantized[j][c] = bc7Unquantize(candidate.quantized[j][c], pBits[j], mode);
+                } else {
+                    candidate.quantized[j][c] = 0;
+                    unquantized[j][c] = 255;
+                }
+            }
+        }
+        float error = bc7Indices(candidateIndices, texels, weights, mask, unquantized, mode);
+        if (error < bestError) {
+            bestError = error;
+            subset = candidate;
+            memcpy(indices, candidateIndices, sizeof(candidateIndices));
+        }
+    }
+    return bestError;
+}
+
+/// Encodes the texels of the subset (mask) with the precision of mode, returns the error. Only indices of the subset's texels are written
+static float bc7EncodeSubset(Bc7Subset &subset, byte *indices, const byte *texels, const float *weights, int mask, const Bc7Mode &mode, bool opaque) {
+    // Initial endpoints at the extremes of the texels along the weighted principal axis
+    float mean[4], axis[4];
+    bc7PrincipalAxis(mean, axis, texels, weights, mask);
+    float minT = 0, maxT = 0;
+    for (int i = 0; i < 16; ++i) {
+        if (!(mask>>i&1))
+            continue;
+        float t = 0;
+        for (int c = 0; c < 4; ++c)
+            t += (texels[4*i+c]-mean[c])*axis[c];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    float endpoints[2][4];
+    for (int c = 0; c < 4; ++c) {
+        endpoints[0][c] = std::min(std::max(mean[c]+minT*axis[c], 0.f), 255.f);
+        endpoints[1][c] = std::min(std::max(mean[c]+maxT*axis[c], 0.f), 255.f);
+    }
+
+    // Alternating refinement of indices and endpoints
+    byte candidateIndices[16];
+    float bestError = bc7Quantize(subset, indices, endpoints, texels, weights, mask, mode, opaque);
+    for (int iteration = 0; iteration < 2 && bestError > 0; ++iteration) {
+        Bc7Subset candidate;
+        bc7Fit(endpoints, texels, weights, mask, indices, mode);
+        float error = bc7Quantize(candidate, candidateIndices, endpoints, texels, weights, mask, mode, opaque);
+        if (error >= bestError)
+            break;
+        bestError = error;
+        subset = candidate;
+        memcpy(indices, candidateIndices, sizeof(candidateIndices));
+    }
+    return bestError;
+}
+
+/// Swaps the endpoints of the subset (mask) if the most significant bit of its anchor texel's index is set, since it is implicitly zero
+static void bc7FixAnchor(Bc7Subset &subset, byte *indices, int mask, int anchor, const Bc7Mode &mode) {
+    int maxIndex = (1<<mode.indexBits)-1;
+    if (indices[anchor] > maxIndex>>1) {
+        for (int c = 0; c < 4; ++c)
+            std::swap(subset.quantized[0][c], subset.quantized[1][c]);
+        std::swap(subset.pBits[0], subset.pBits[1]);
+        for (int i = 0; i < 16; ++i) {
+            if (mask>>i&1)
+                indices[i] = byte(maxIndex-indices[i]);
+        }
+    }
+}
+
+static void writeBc7Block(byte *output, const Bc7Mode &mode, int partition, Bc7Subset *subsets, const byte *indices) {
+    int subsetCount = mode.partitionBits ? 2 : 1;
+    int secondAnchor = subsetCount > 1 ? bc7Anchors2[partition] : 0;
+    memset(output, 0, 16);
+    int pos = 0;
+    writeBits(output, pos, 1<<mode.mode, mode.mode+1);
+    writeBits(output, pos, partition, mode.partitionBits);
+    for (int c = 0; c < mode.channels; ++c) {
+        for (int s = 0; s < subsetCount; ++s) {
+            writeBits(output, pos, subsets[s].quantized[0][c], mode.endpointBits);
+            writeBits(output, pos, subsets[s].quantized[1][c], mode.endpointBits);
+        }
+    }
+    for (int s = 0; s < subsetCount; ++s) {
+        writeBits(output, pos, subsets[s].pBits[0], 1);
+        if (!mode.sharedPBit)
+            writeBits(output, pos, subsets[s].pBits[1], 1);
+    }
+    for (int i = 0; i < 16; ++i)
+        writeBits(output, pos, indices[i], mode.indexBits-(i == 0 || (subsetCount > 1 && i == secondAnchor)));
+}
+
+static void encodeBc7Block(byte *output, const byte *texels, bool opaque) {
+    opaque = opaque || (texels[3]&texels[7]&texels[11]&texels[15]&texels[19]&texels[23]&texels[27]&texels[31]&texels[35]&texels[39]&texels[43]&texels[47]&texels[51]&texels[55]&texels[59]&texels[63]) == 255;
+    float weights[64];
+    for (int i = 0; i < 64; ++i)
+        weights[i] = opaque && (i&3) == 3 ? 0.f : valueWeights.weights[texels[i]];
+
+    Bc7Subset subsets[2];
+    byte indices[16];
+    float error = bc7EncodeSubset(subsets[0], indices, texels, weights, 0xffff, bc7Mode6, opaque);
+
+    // Blocks which do not fit one line well (e.g. where the channels of a multi-channel distance field disagree) are also tried with two subsets
+    if (error > 0) {
+        const Bc7Mode &mode = opaque ? bc7Mode1 : bc7Mode7;
+        // Only the partitions whose subsets deviate the least from their principal axes are fully encoded
+        const int candidateCount = 4;
+        int candidates[candidateCount];
+        float candidateSpreads[candidateCount];
+        for (int i = 0; i < candidateCount; ++i)
+            candidates[i] = -1, candidateSpreads[i] = 1e30f;
+        for (int partition = 0; partition < 64; ++partition) {
+            float mean[4], axis[4];
+            int mask = bc7Partitions2[partition];
+            float spread = bc7PrincipalAxis(mean, axis, texels, weights, 0xffff&~mask)+bc7PrincipalAxis(mean, axis, texels, weights, mask);
+            for (int i = 0; i < candidateCount; ++i) {
+                if (spread < candidateSpreads[i]) {
+                    for (int j = candidateCount-1; j > i; --j)
+                        candidates[j] = candidates[j-1], candidateSpreads[j] = candidateSpreads[j-1];
+                    candidates[i] = partition, candidateSpreads[i] = spread;
+                    break;
+                }
+            }
+        }
+        int bestPartition = -1;
+        Bc7Subset partitionSubsets[2];
+        byte partitionIndices[16];
+        for (int i = 0; i < candidateCount; ++i) {
+            int mask = bc7Partitions2[candidates[i]];
+            float partitionError = bc7EncodeSubset(partitionSubsets[0], partitionIndices, texels, weights, 0xffff&~mask, mode, opaque);
+            if (partitionError < error)
+                partitionError += bc7EncodeSubset(partitionSubsets[1], partitionIndices, texels, weights, mask, mode, opaque);
+            if (partitionError < error) {
+                error = partitionError;
+                bestPartition = candidates[i];
+                subsets[0] = partitionSubsets[0], subsets[1] = partitionSubsets[1];
+                memcpy(indices, partitionIndices, sizeof(partitionIndices));
+            }
+        }
+        if (bestPartition >= 0) {
+            int mask = bc7Partitions2[bestPartition];
+            bc7FixAnchor(subsets[0], indices, 0xffff&~mask, 0, mode);
+            bc7FixAnchor(subsets[1], indices, mask, bc7Anchors2[bestPartition], mode);
+            writeBc7Block(output, mode, bestPartition, subsets, indices);
+            return;
+        }
+    }
+
+    bc7FixAnchor(subsets[0], indices, 0xffff, 0, bc7Mode6);
+    writeBc7Block(output, bc7Mode6, 0, subsets, indices);
+}
+
+template <int N>
+static bool compressImageBlocks(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<byte, N> &bitmap, int threadCount) {
+    if (!(bitmap.pixels && bitmap.width > 0 && bitmap.height > 0))
+        return false;
+    BlockFormat format = blockFormatForChannels(N);
+    int blocksX = (bitmap.width+3)/4, blocksY = (bitmap.height+3)/4;
+    size_t blockSize = blockCompressedSize(format, 4, 4);
+    size_t start = output.size();
+    output.resize(start+blockCompressedSize(format, bitmap.width, bitmap.height));
+    byte *blocks = output.data()+start;
+    return Workload([&](int blockY, int) -> bool {
+        byte texels[16*N], rgbaTexels[64];
+        for (int blockX = 0; blockX < blocksX; ++blockX) {
+            byte *block = blocks+blockSize*((size_t) blocksX*blockY+blockX);
+            fetchBlock<N>(texels, bitmap, blockX, blockY);
+            switch (format) {
+                case BlockFormat::BC4:
+                    encodeBc4Block(block, texels);
+                    break;
+                case BlockFormat::BC7:
+                    for (int i = 0; i < 16; ++i) {
+                        for (int c = 0; c < 4; ++c)
+                            rgbaTexels[4*i+c] = c < N ? texels[N*i+c] : byte(255);
+                    }
+                    encodeBc7Block(block, rgbaTexels, N < 4);
+                    break;
+            }
+        }
+        return true;
+    }, blocksY).finish(threadCount);
+}
+
+BlockFormat blockFormatForChannels(int channels) {
+    return channels == 1 ? BlockFormat::BC4 : BlockFormat::BC7;
+}
+
+size_t blockCompressedSize(BlockFormat format, int width, int height) {
+    size_t blocks = (size_t) ((width+3)/4)*((height+3)/4);
+    switch (format) {
+        case BlockFormat::BC4:
+            return 8*blocks;
+        case BlockFormat::BC7:
+            return 16*blocks;
+    }
+    return 0;
+}
+
+bool compressBlocks(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<byte, 1> &bitmap, int threadCount) {
+    return compressImageBlocks(output, bitmap, threadCount);
+}
+
+bool compressBlocks(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<byte, 3> &bitmap, int threadCount) {
+    return compressImageBlocks(output, bitmap, threadCount);
+}
+
+bool compressBlocks(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<byte, 4> &bitmap, int threadCount) {
+    return compressImageBlocks(output, bitmap, threadCount);
+}
+
+}
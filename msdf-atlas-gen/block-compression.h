@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <msdfgen.h>
+#include "types.h"
+
+namespace msdf_atlas {
+
+// Functions to compress an image into GPU texture blocks of 4x4 pixels
+// Blocks are ordered in rows from the top of the image, partial blocks at the edges are padded by repeating edge pixels
+// The encoders minimize an error weighted towards values near 0.5, i.e. near the glyph edges of distance fields and masks
+
+/// GPU texture block compression format
+enum class BlockFormat {
+    /// Single channel, 8 bytes per block
+    BC4,
+    /// RGBA, 16 bytes per block (only modes 1, 6, and 7 are used)
+    BC7
+};
+
+/// Returns the block format used for images with the given number of channels (BC4 for 1, BC7 for 3 or 4)
+BlockFormat blockFormatForChannels(int channels);
+/// Returns the number of bytes of an image of the given dimensions compressed in the given format
+size_t blockCompressedSize(BlockFormat format, int width, int height);
+
+/// Compresses the bitmap as BC4 using threadCount threads
+bool compressBlocks(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<byte, 1> &bitmap, int threadCount);
+/// Compresses the bitmap as BC7 (with opaque alpha) using threadCount threads
+bool compressBlocks(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<byte, 3> &bitmap, int threadCount);
+/// Compresses the bitmap as BC7 using threadCount threads
+bool compressBlocks(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<byte, 4> &bitmap, int threadCount);
+
+}
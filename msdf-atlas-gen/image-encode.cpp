@@ -5,7 +5,12 @@
 
 #ifdef MSDFGEN_USE_LIBPNG
 
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
 #include <png.h>
+#include <zlib.h>
+#include "Workload.h"
 
 namespace msdf_atlas {
 
@@ -87,6 +92,231 @@ bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::Bitmap
     return pngEncode(output, bitmap.pixels, bitmap.width, bitmap.height, 4, PNG_COLOR_TYPE_RGB_ALPHA);
 }
 
+// Filtered image data compressed by each thread (not less than one row)
+#define MSDF_ATLAS_PNG_CHUNK_SIZE 262144
+// Maximum size of the data of each IDAT chunk
+#define MSDF_ATLAS_PNG_IDAT_SIZE 1048576
+
+static byte pngPaeth(int a, int b, int c) {
+    int p = a+b-c;
+    int pa = abs(p-a), pb = abs(p-b), pc = abs(p-c);
+    if (pa <= pb && pa <= pc)
+        return byte(a);
+    if (pb <= pc)
+        return byte(b);
+    return byte(c);
+}
+
+/// Writes the row filtered with filter type (0 to 4) preceded by the type into output, prev is the previous unfiltered row or nullptr
+static void pngFilterRow(byte *output, const byte *row, const byte *prev, int rowBytes, int bpp, int filter) {
+    *output++ = byte(filter);
+    for (int i = 0; i < rowBytes; ++i) {
+        int a = i >= bpp ? row[i-bpp] : 0;
+        int b = prev ? prev[i] : 0;
+        int c = prev && i >= bpp ? prev[i-bpp] : 0;
+        switch (filter) {
+            case 0:
+                output[i] = row[i];
+                break;
+            case 1:
+                output[i] = byte(row[i]-a);
+                break;
+            case 2:
+                output[i] = byte(row[i]-b);
+                break;
+            case 3:
+                output[i] = byte(row[i]-((a+b)>>1));
+                break;
+            case 4:
+                output[i] = byte(row[i]-pngPaeth(a, b, c));
+                break;
+        }
+    }
+}
+
+/// Sum of filtered values as signed bytes - the usual heuristic for picking a filter
+static unsigned pngFilterCost(const byte *filtered, int rowBytes) {
+    unsigned cost = 0;
+    for (int i = 0; i < rowBytes; ++i)
+        cost += filtered[i] < 128 ? filtered[i] : 256-filtered[i];
+    return cost;
+}
+
+static void pngWriteUint32(std::vector<byte, Allocator<byte>> &output, unsigned long value) {
+    output.push_back(byte(value>>24));
+    output.push_back(byte(value>>16));
+    output.push_back(byte(value>>8));
+    output.push_back(byte(value));
+}
+
+static void pngWriteChunk(std::vector<byte, Allocator<byte>> &output, const char *type, const byte *data, size_t length) {
+    pngWriteUint32(output, (unsigned long) length);
+    size_t start = output.size();
+    output.insert(output.end(), type, type+4);
+    if (length)
+        output.insert(output.end(), data, data+length);
+    pngWriteUint32(output, crc32(crc32(0L, Z_NULL, 0), &output[start], (uInt) (output.size()-start)));
+}
+
+static bool pngEncodeParallel(std::vector<byte, Allocator<byte>> &output, const byte *pixels, int width, int height, int channels, int colorType, PngCompression compression, int threadCount) {
+    if (!(pixels && width > 0 && height > 0))
+        return false;
+    threadCount = std::max(threadCount, 1);
+    int level = Z_BEST_COMPRESSION;
+    bool adaptiveFilter = true;
+    switch (compression) {
+        case PngCompression::FAST:
+            level = Z_BEST_SPEED;
+            adaptiveFilter = false;
+            break;
+        case PngCompression::DEFAULT:
+            level = 6;
+            break;
+        case PngCompression::MAX:
+            break;
+    }
+    int rowBytes = channels*width;
+    size_t filteredRowBytes = (size_t) rowBytes+1;
+    int chunkRows = std::max((int) (MSDF_ATLAS_PNG_CHUNK_SIZE/filteredRowBytes), 1);
+    int chunkCount = (height+chunkRows-1)/chunkRows;
+
+    // Filters only refer to the unfiltered previous row, so all chunks can be filtered independently
+    std::vector<byte, Allocator<byte>> filtered(filteredRowBytes*height);
+    std::vector<byte, Allocator<byte>> filterBuffer(adaptiveFilter ? 4*filteredRowBytes*threadCount : 0);
+    std::vector<uLong, Allocator<uLong>> chunkChecksums(chunkCount);
+    Workload([&](int chunk, int threadNo) -> bool {
+        int rowEnd = std::min(chunkRows*(chunk+1), height);
+        for (int row = chunkRows*chunk; row < rowEnd; ++row) {
+            // Bitmap rows are stored bottom-up
+            const byte *cur = pixels+(size_t) rowBytes*(height-row-1);
+            const byte *prev = row ? cur+rowBytes : nullptr;
+            byte *out = filtered.data()+filteredRowBytes*row;
+            if (adaptiveFilter) {
+                byte *candidate = filterBuffer.data()+4*filteredRowBytes*threadNo;
+                pngFilterRow(out, cur, prev, rowBytes, channels, 0);
+                unsigned bestCost = pngFilterCost(out+1, rowBytes);
+                for (int filter = 1; filter <= 4; ++filter, candidate += filteredRowBytes) {
+                    pngFilterRow(candidate, cur, prev, rowBytes, channels, filter);
+                    unsigned cost = pngFilterCost(candidate+1, rowBytes);
+                    if (cost < bestCost) {
+                        memcpy(out, candidate, filteredRowBytes);
+                        bestCost = cost;
+                    }
+                }
+            } else
+                pngFilterRow(out, cur, prev, rowBytes, channels, 2);
+        }
+        const byte *chunkData = filtered.data()+filteredRowBytes*chunkRows*chunk;
+        chunkChecksums[chunk] = adler32(adler32(0L, Z_NULL, 0), chunkData, (uInt) (filteredRowBytes*(rowEnd-chunkRows*chunk)));
+        return true;
+    }, chunkCount).finish(threadCount);
+
+    // Each chunk is compressed into a part of the deflate stream ending at a byte boundary (sync flush),
+    // with the data preceding it as the dictionary so that matches across chunk boundaries are not lost
+    std::vector<std::vector<byte, Allocator<byte>>, Allocator<std::vector<byte, Allocator<byte>>>> compressedChunks(chunkCount);
+    if (!Workload([&](int chunk, int) -> bool {
+        bool last = chunk == chunkCount-1;
+        size_t begin = filteredRowBytes*chunkRows*chunk;
+        size_t length = filteredRowBytes*(std::min(chunkRows*(chunk+1), height)-chunkRows*chunk);
+        z_stream stream = { };
+        if (deflateInit2(&stream, level, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+            return false;
+        if (begin) {
+            size_t dictionaryLength = std::min(begin, (size_t) 32768);
+            deflateSetDictionary(&stream, filtered.data()+begin-dictionaryLength, (uInt) dictionaryLength);
+        }
+        std::vector<byte, Allocator<byte>> &compressed = compressedChunks[chunk];
+        compressed.resize(deflateBound(&stream, (uLong) length)+16);
+        stream.next_in = filtered.data()+begin;
+        stream.avail_in = (uInt) length;
+        stream.next_out = compressed.data();
+        stream.avail_out = (uInt) compressed.size();
+        bool success = false;
+        while (true) {
+            int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+            if (result == Z_STREAM_ERROR)
+                break;
+            if (last ? result == Z_STREAM_END : !stream.avail_in && stream.avail_out) {
+                success = true;
+                break;
+            }
+            size_t used = stream.total_out;
+            compressed.resize(2*compressed.size());
+            stream.next_out = compressed.data()+used;
+            stream.avail_out = (uInt) (compressed.size()-used);
+        }
+        compressed.resize(stream.total_out);
+        deflateEnd(&stream);
+        return success;
+    }, chunkCount).finish(threadCount))
+        return false;
+
+    // zlib header and trailer enclose the concatenated deflate stream
+    std::vector<byte, Allocator<byte>> zlibStream;
+    zlibStream.push_back(byte(0x78));
+    zlibStream.push_back(byte(level == Z_BEST_SPEED ? 0x01 : level == Z_BEST_COMPRESSION ? 0xda : 0x9c));
+    uLong checksum = chunkChecksums[0];
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        if (chunk) {
+            size_t length = filteredRowBytes*(std::min(chunkRows*(chunk+1), height)-chunkRows*chunk);
+            checksum = adler32_combine(checksum, chunkChecksums[chunk], (z_off_t) length);
+        }
+        zlibStream.insert(zlibStream.end(), compressedChunks[chunk].begin(), compressedChunks[chunk].end());
+        compressedChunks[chunk] = std::vector<byte, Allocator<byte>>();
+    }
+    pngWriteUint32(zlibStream, checksum);
+
+    static const byte signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    byte header[13] = { };
+    header[0] = byte(width>>24), header[1] = byte(width>>16), header[2] = byte(width>>8), header[3] = byte(width);
+    header[4] = byte(height>>24), header[5] = byte(height>>16), header[6] = byte(height>>8), header[7] = byte(height);
+    header[8] = 8;
+    header[9] = byte(colorType);
+    output.insert(output.end(), signature, signature+8);
+    pngWriteChunk(output, "IHDR", header, sizeof(header));
+    for (size_t pos = 0; pos < zlibStream.size(); pos += MSDF_ATLAS_PNG_IDAT_SIZE)
+        pngWriteChunk(output, "IDAT", zlibStream.data()+pos, std::min(zlibStream.size()-pos, (size_t) MSDF_ATLAS_PNG_IDAT_SIZE));
+    pngWriteChunk(output, "IEND", nullptr, 0);
+    return true;
+}
+
+static bool pngEncodeParallel(std::vector<byte, Allocator<byte>> &output, const float *pixels, int width, int height, int channels, int colorType, PngCompression compression, int threadCount) {
+    if (!(pixels && width > 0 && height > 0))
+        return false;
+    int rowSubpixels = channels*width;
+    std::vector<byte, Allocator<byte>> bytePixels((size_t) rowSubpixels*height);
+    Workload([&](int y, int) -> bool {
+        for (size_t i = (size_t) rowSubpixels*y, end = i+rowSubpixels; i < end; ++i)
+            bytePixels[i] = msdfgen::pixelFloatToByte(pixels[i]);
+        return true;
+    }, height).finish(threadCount);
+    return pngEncodeParallel(output, bytePixels.data(), width, height, channels, colorType, compression, threadCount);
+}
+
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<msdfgen::byte, 1> &bitmap, PngCompression compression, int threadCount) {
+    return pngEncodeParallel(output, bitmap.pixels, bitmap.width, bitmap.height, 1, PNG_COLOR_TYPE_GRAY, compression, threadCount);
+}
+
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<msdfgen::byte, 3> &bitmap, PngCompression compression, int threadCount) {
+    return pngEncodeParallel(output, bitmap.pixels, bitmap.width, bitmap.height, 3, PNG_COLOR_TYPE_RGB, compression, threadCount);
+}
+
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<msdfgen::byte, 4> &bitmap, PngCompression compression, int threadCount) {
+    return pngEncodeParallel(output, bitmap.pixels, bitmap.width, bitmap.height, 4, PNG_COLOR_TYPE_RGB_ALPHA, compression, threadCount);
+}
+
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<float, 1> &bitmap, PngCompression compression, int threadCount) {
+    return pngEncodeParallel(output, bitmap.pixels, bitmap.width, bitmap.height, 1, PNG_COLOR_TYPE_GRAY, compression, threadCount);
+}
+
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<float, 3> &bitmap, PngCompression compression, int threadCount) {
+    return pngEncodeParallel(output, bitmap.pixels, bitmap.width, bitmap.height, 3, PNG_COLOR_TYPE_RGB, compression, threadCount);
+}
+
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<float, 4> &bitmap, PngCompression compression, int threadCount) {
+    return pngEncodeParallel(output, bitmap.pixels, bitmap.width, bitmap.height, 4, PNG_COLOR_TYPE_RGB_ALPHA, compression, threadCount);
+}
+
 }
 
 #endif
@@ -19,6 +19,19 @@ bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::Bitmap
 bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<float, 3> &bitmap);
 bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<float, 4> &bitmap);
 
+#ifdef MSDFGEN_USE_LIBPNG
+
+// Parallel PNG encoding - chunks of rows are filtered and compressed by separate threads into a single deflate stream
+
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<msdfgen::byte, 1> &bitmap, PngCompression compression, int threadCount);
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<msdfgen::byte, 3> &bitmap, PngCompression compression, int threadCount);
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<msdfgen::byte, 4> &bitmap, PngCompression compression, int threadCount);
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<float, 1> &bitmap, PngCompression compression, int threadCount);
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<float, 3> &bitmap, PngCompression compression, int threadCount);
+bool encodePng(std::vector<byte, Allocator<byte>> &output, const msdfgen::BitmapConstRef<float, 4> &bitmap, PngCompression compression, int threadCount);
+
+#endif
+
 }
 
 #endif
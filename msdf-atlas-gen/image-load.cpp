@@ -0,0 +1,158 @@
+
+#include "image-load.h"
+
+#include <cstdio>
+
+#ifdef MSDFGEN_USE_LIBPNG
+#include <png.h>
+#endif
+
+namespace msdf_atlas {
+
+static void reverseBytes(byte &) { }
+
+static void reverseBytes(float &value) {
+    unsigned char *b = reinterpret_cast<unsigned char *>(&value);
+    for (int i = 0, j = sizeof(float)-1; i < j; ++i, --j) {
+        unsigned char t = b[i];
+        b[i] = b[j];
+        b[j] = t;
+    }
+}
+
+template <typename T, int N>
+static bool loadImageBinary(msdfgen::Bitmap<T, N> &bitmap, const char *filename, int width, int height, YDirection yDirection, bool reversedByteOrder) {
+    FILE *f = fopen(filename, "rb");
+    if (!f)
+        return false;
+    msdfgen::Bitmap<T, N> result(width, height);
+    size_t read = 0;
+    for (int y = 0; y < height; ++y)
+        read += fread(result(0, yDirection == YDirection::TOP_DOWN ? height-y-1 : y), sizeof(T), (size_t) N*width, f);
+    // The file must contain exactly the expected number of pixels
+    bool success = read == (size_t) N*width*height && fgetc(f) == EOF;
+    fclose(f);
+    if (!success)
+        return false;
+    if (reversedByteOrder) {
+        T *pixels = (T *) result(0, 0);
+        for (size_t i = 0; i < (size_t) N*width*height; ++i)
+            reverseBytes(pixels[i]);
+    }
+    bitmap = (msdfgen::Bitmap<T, N> &&) result;
+    return true;
+}
+
+#ifdef MSDFGEN_USE_LIBPNG
+
+class PngReadGuard {
+    png_structp png;
+    png_infop info;
+
+public:
+    inline PngReadGuard(png_structp png, png_infop info) : png(png), info(info) { }
+    inline ~PngReadGuard() {
+        png_destroy_read_struct(&png, &info, NULL);
+    }
+
+};
+
+static void pngIgnoreError(png_structp, png_const_charp) { }
+
+template <int N>
+static bool loadImagePng(msdfgen::Bitmap<byte, N> &bitmap, const char *filename, int width, int height) {
+    FILE *f = fopen(filename, "rb");
+    if (!f)
+        return false;
+    bool success = false;
+    msdfgen::Bitmap<byte, N> result(width, height);
+    png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, &pngIgnoreError, &pngIgnoreError);
+    if (png) {
+        png_infop info = png_create_info_struct(png);
+        PngReadGuard guard(png, info);
+        if (info && !setjmp(png_jmpbuf(png))) {
+            png_init_io(png, f);
+            png_read_info(png, info);
+            png_set_expand(png);
+            png_set_strip_16(png);
+            int passes = png_set_interlace_handling(png);
+            png_read_update_info(png, info);
+            if ((int) png_get_image_width(png, info) == width && (int) png_get_image_height(png, info) == height && png_get_channels(png, info) == N && png_get_bit_depth(png, info) == 8 && passes == 1) {
+                // PNG rows are stored top-down
+                for (int y = height-1; y >= 0; --y)
+                    png_read_row(png, (png_bytep) result(0, y), NULL);
+                success = true;
+            }
+        }
+    }
+    fclose(f);
+    if (success)
+        bitmap = (msdfgen::Bitmap<byte, N> &&) result;
+    return success;
+}
+
+#endif
+
+template <int N>
+static bool loadByteImage(msdfgen::Bitmap<byte, N> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection) {
+    if (!(filename && width > 0 && height > 0))
+        return false;
+    switch (format) {
+    #ifdef MSDFGEN_USE_LIBPNG
+        case ImageFormat::PNG:
+            return loadImagePng(bitmap, filename, width, height);
+    #endif
+        case ImageFormat::BINARY:
+            return loadImageBinary(bitmap, filename, width, height, yDirection, false);
+        default:;
+    }
+    return false;
+}
+
+template <int N>
+static bool loadFloatImage(msdfgen::Bitmap<float, N> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection) {
+    if (!(filename && width > 0 && height > 0))
+        return false;
+    switch (format) {
+        case ImageFormat::BINARY_FLOAT:
+            #ifdef __BIG_ENDIAN__
+                return loadImageBinary(bitmap, filename, width, height, yDirection, true);
+            #else
+                return loadImageBinary(bitmap, filename, width, height, yDirection, false);
+            #endif
+        case ImageFormat::BINARY_FLOAT_BE:
+            #ifdef __BIG_ENDIAN__
+                return loadImageBinary(bitmap, filename, width, height, yDirection, false);
+            #else
+                return loadImageBinary(bitmap, filename, width, height, yDirection, true);
+            #endif
+        default:;
+    }
+    return false;
+}
+
+bool loadImage(msdfgen::Bitmap<byte, 1> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection) {
+    return loadByteImage(bitmap, format, filename, width, height, yDirection);
+}
+
+bool loadImage(msdfgen::Bitmap<byte, 3> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection) {
+    return loadByteImage(bitmap, format, filename, width, height, yDirection);
+}
+
+bool loadImage(msdfgen::Bitmap<byte, 4> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection) {
+    return loadByteImage(bitmap, format, filename, width, height, yDirection);
+}
+
+bool loadImage(msdfgen::Bitmap<float, 1> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection) {
+    return loadFloatImage(bitmap, format, filename, width, height, yDirection);
+}
+
+bool loadImage(msdfgen::Bitmap<float, 3> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection) {
+    return loadFloatImage(bitmap, format, filename, width, height, yDirection);
+}
+
+bool loadImage(msdfgen::Bitmap<float, 4> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection) {
+    return loadFloatImage(bitmap, format, filename, width, height, yDirection);
+}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <msdfgen.h>
+#include "types.h"
+
+namespace msdf_atlas {
+
+// Functions to load an atlas image previously saved in one of the lossless formats that can be read back exactly:
+// PNG (requires libpng) and BINARY for 8-bit bitmaps, BINARY_FLOAT and BINARY_FLOAT_BE for floating-point bitmaps.
+// Width and height are the expected dimensions (raw binary files do not store them), loading fails on mismatch
+
+bool loadImage(msdfgen::Bitmap<byte, 1> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection = YDirection::BOTTOM_UP);
+bool loadImage(msdfgen::Bitmap<byte, 3> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection = YDirection::BOTTOM_UP);
+bool loadImage(msdfgen::Bitmap<byte, 4> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection = YDirection::BOTTOM_UP);
+bool loadImage(msdfgen::Bitmap<float, 1> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection = YDirection::BOTTOM_UP);
+bool loadImage(msdfgen::Bitmap<float, 3> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection = YDirection::BOTTOM_UP);
+bool loadImage(msdfgen::Bitmap<float, 4> &bitmap, ImageFormat format, const char *filename, int width, int height, YDirection yDirection = YDirection::BOTTOM_UP);
+
+}
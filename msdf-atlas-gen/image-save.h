@@ -6,10 +6,20 @@
 
 namespace msdf_atlas {
 
-/// Saves the bitmap as an image file with the specified format
+/// Saves the bitmap as an image file with the specified format (PNG through msdfgen::savePng, whose compression level is fixed)
 template <typename T, int N>
 bool saveImage(const msdfgen::BitmapConstRef<T, N> &bitmap, ImageFormat format, const char *filename, YDirection outputYDirection = YDirection::BOTTOM_UP);
 
+/// Compresses the bitmap and its mipLevelCount following mip levels into GPU texture blocks using threadCount threads and saves them as a DDS or KTX2 file (8-bit bitmaps only)
+template <typename T, int N>
+bool saveCompressedImage(const msdfgen::BitmapConstRef<T, N> &bitmap, const msdfgen::Bitmap<T, N> *mipLevels, int mipLevelCount, ImageFormat format, const char *filename, int threadCount);
+
+#ifdef MSDFGEN_USE_LIBPNG
+/// Saves the bitmap as a PNG file encoded by threadCount threads with the selected compression
+template <typename T, int N>
+bool savePng(const msdfgen::BitmapConstRef<T, N> &bitmap, const char *filename, PngCompression compression, int threadCount);
+#endif
+
 }
 
 #include "image-save.hpp"
@@ -3,6 +3,8 @@
 
 #include <cstdio>
 #include <msdfgen-ext.h>
+#include "image-encode.h"
+#include "texture-export.h"
 
 namespace msdf_atlas {
 
@@ -42,6 +44,9 @@ bool saveImage(const msdfgen::BitmapConstRef<byte, N> &bitmap, ImageFormat forma
         case ImageFormat::BINARY_FLOAT:
         case ImageFormat::BINARY_FLOAT_BE:
             return false;
+        case ImageFormat::DDS:
+        case ImageFormat::KTX2:
+            return saveCompressedTexture(bitmap, format, filename, 1);
         default:;
     }
     return false;
@@ -72,6 +77,9 @@ bool saveImage(const msdfgen::BitmapConstRef<float, N> &bitmap, ImageFormat form
             return saveImageBinaryLE(bitmap, filename, outputYDirection);
         case ImageFormat::BINARY_FLOAT_BE:
             return saveImageBinaryBE(bitmap, filename, outputYDirection);
+        case ImageFormat::DDS:
+        case ImageFormat::KTX2:
+            return false;
         default:;
     }
     return false;
@@ -181,4 +189,31 @@ bool saveImageText(const msdfgen::BitmapConstRef<float, N> &bitmap, const char *
     return success;
 }
 
+template <int N>
+bool saveCompressedImage(const msdfgen::BitmapConstRef<byte, N> &bitmap, const msdfgen::Bitmap<byte, N> *mipLevels, int mipLevelCount, ImageFormat format, const char *filename, int threadCount) {
+    return saveCompressedTexture(bitmap, mipLevels, mipLevelCount, format, filename, threadCount);
+}
+
+template <int N>
+bool saveCompressedImage(const msdfgen::BitmapConstRef<float, N> &, const msdfgen::Bitmap<float, N> *, int, ImageFormat, const char *, int) {
+    return false;
+}
+
+#ifdef MSDFGEN_USE_LIBPNG
+
+template <typename T, int N>
+bool savePng(const msdfgen::BitmapConstRef<T, N> &bitmap, const char *filename, PngCompression compression, int threadCount) {
+    std::vector<byte, Allocator<byte>> pngData;
+    if (!encodePng(pngData, bitmap, compression, threadCount))
+        return false;
+    bool success = false;
+    if (FILE *f = fopen(filename, "wb")) {
+        success = fwrite(pngData.data(), 1, pngData.size(), f) == pngData.size();
+        success = !fclose(f) && success;
+    }
+    return success;
+}
+
+#endif
+
 }
@@ -0,0 +1,282 @@
+
+#include "kerning-tables.h"
+
+#include <vector>
+#include <algorithm>
+#include "FlatHashMap.h"
+
+#define SFNT_TAG(a, b, c, d) ((unsigned) (a)<<24|(unsigned) (b)<<16|(unsigned) (c)<<8|(unsigned) (d))
+#define SFNT_MAX_GLYPHS 0x10000
+
+namespace msdf_atlas {
+
+typedef std::map<std::pair<int, int>, double, std::less<std::pair<int, int>>, Allocator<std::pair<const std::pair<int, int>, double>>> KerningMap;
+
+/// A font table - all reads are bounds-checked and yield zero outside of it, so that malformed offsets cannot cause harm
+struct FontTable {
+    std::vector<msdfgen::byte, Allocator<msdfgen::byte>> data;
+
+    unsigned uint16(size_t offset) const {
+        if (offset+2 > data.size())
+            return 0;
+        return (unsigned) data[offset]<<8|(unsigned) data[offset+1];
+    }
+    int int16(size_t offset) const {
+        return (int) (short) uint16(offset);
+    }
+    unsigned uint32(size_t offset) const {
+        return uint16(offset)<<16|uint16(offset+2);
+    }
+};
+
+static unsigned long long pairKey(unsigned glyph1, unsigned glyph2) {
+    return (unsigned long long) glyph1<<32|glyph2;
+}
+
+/// Returns the size of a GPOS ValueRecord with the given format
+static size_t valueRecordSize(unsigned valueFormat) {
+    size_t size = 0;
+    for (valueFormat &= 0xff; valueFormat; valueFormat &= valueFormat-1)
+        size += 2;
+    return size;
+}
+
+/// Returns the position of XAdvance within a GPOS ValueRecord with the given format
+static size_t xAdvanceOffset(unsigned valueFormat) {
+    return 2*((valueFormat&0x01)+(valueFormat>>1&0x01));
+}
+
+/// Calls fn(glyph, coverageIndex) for each glyph listed in a Coverage table
+template <typename FN>
+static void forEachCoveredGlyph(const FontTable &table, size_t offset, FN fn) {
+    switch (table.uint16(offset)) {
+        case 1:
+            for (unsigned i = 0, count = table.uint16(offset+2); i < count; ++i)
+                fn(table.uint16(offset+4+2*i), i);
+            break;
+        case 2:
+            for (unsigned i = 0, count = table.uint16(offset+2); i < count; ++i) {
+                size_t range = offset+4+6*i;
+                unsigned start = table.uint16(range), end = table.uint16(range+2), startIndex = table.uint16(range+4);
+                for (unsigned glyph = start; glyph <= end; ++glyph)
+                    fn(glyph, startIndex+glyph-start);
+            }
+            break;
+    }
+}
+
+/// Returns the class of glyph in a ClassDef table (zero if not listed)
+static unsigned glyphClass(const FontTable &table, size_t offset, unsigned glyph) {
+    switch (table.uint16(offset)) {
+        case 1: {
+            unsigned start = table.uint16(offset+2), count = table.uint16(offset+4);
+            if (glyph >= start && glyph-start < count)
+                return table.uint16(offset+6+2*(glyph-start));
+            break;
+        }
+        case 2: {
+            // Class ranges are sorted by start glyph
+            unsigned lo = 0, hi = table.uint16(offset+2);
+            while (lo < hi) {
+                unsigned mid = (lo+hi)>>1;
+                size_t range = offset+4+6*mid;
+                if (glyph < table.uint16(range))
+                    hi = mid;
+                else if (glyph > table.uint16(range+2))
+                    lo = mid+1;
+                else
+                    return table.uint16(range+4);
+            }
+            break;
+        }
+    }
+    return 0;
+}
+
+/// Tracks which pairs have already been matched by a subtable of the current lookup, as only the first matching subtable applies
+struct PairMatches {
+    std::vector<bool, Allocator<bool>> firstGlyphs;
+    FlatHashMap<bool> pairs;
+
+    PairMatches() : firstGlyphs(SFNT_MAX_GLYPHS) { }
+    bool matched(unsigned glyph1, unsigned glyph2) const {
+        return firstGlyphs[glyph1] || pairs.find(pairKey(glyph1, glyph2));
+    }
+};
+
+/// Adds the kerning of a PairPos subtable of format 1 (individual glyph pairs)
+static void readPairPosFormat1(KerningMap &kerning, PairMatches &matches, const FontTable &gpos, size_t offset, const std::vector<bool, Allocator<bool>> &present) {
+    unsigned valueFormat1 = gpos.uint16(offset+4), valueFormat2 = gpos.uint16(offset+6);
+    unsigned pairSetCount = gpos.uint16(offset+8);
+    size_t recordSize = 2+valueRecordSize(valueFormat1)+valueRecordSize(valueFormat2);
+    std::vector<unsigned long long, Allocator<unsigned long long>> newMatches;
+    forEachCoveredGlyph(gpos, offset+gpos.uint16(offset+2), [&](unsigned first, unsigned coverageIndex) {
+        if (!present[first] || matches.firstGlyphs[first] || coverageIndex >= pairSetCount)
+            return;
+        size_t pairSet = offset+gpos.uint16(offset+10+2*coverageIndex);
+        for (unsigned i = 0, count = gpos.uint16(pairSet); i < count; ++i) {
+            size_t record = pairSet+2+recordSize*i;
+            unsigned second = gpos.uint16(record);
+            if (!present[second] || matches.pairs.find(pairKey(first, second)))
+                continue;
+            newMatches.push_back(pairKey(first, second));
+            if (valueFormat1&0x04) {
+                if (int value = gpos.int16(record+2+xAdvanceOffset(valueFormat1)))
+                    kerning[std::make_pair<int, int>((int) first, (int) second)] += value;
+            }
+        }
+    });
+    for (unsigned long long key : newMatches)
+        matches.pairs.insert(key, true);
+}
+
+/// Adds the kerning of a PairPos subtable of format 2 (pairs of glyph classes)
+static void readPairPosFormat2(KerningMap &kerning, PairMatches &matches, const FontTable &gpos, size_t offset, const std::vector<bool, Allocator<bool>> &present, const std::vector<unsigned, Allocator<unsigned>> &presentGlyphs) {
+    unsigned valueFormat1 = gpos.uint16(offset+4), valueFormat2 = gpos.uint16(offset+6);
+    size_t classDef1 = offset+gpos.uint16(offset+8), classDef2 = offset+gpos.uint16(offset+10);
+    unsigned class1Count = gpos.uint16(offset+12), class2Count = gpos.uint16(offset+14);
+    size_t recordSize = valueRecordSize(valueFormat1)+valueRecordSize(valueFormat2);
+    size_t records = offset+16;
+    // Glyphs are grouped by their second class so that each non-zero class pair only visits its own glyphs
+    std::vector<std::vector<unsigned, Allocator<unsigned>>, Allocator<std::vector<unsigned, Allocator<unsigned>>>> secondGlyphs;
+    if (valueFormat1&0x04) {
+        secondGlyphs.resize(class2Count);
+        for (unsigned glyph : presentGlyphs) {
+            unsigned class2 = glyphClass(gpos, classDef2, glyph);
+            if (class2 < class2Count)
+                secondGlyphs[class2].push_back(glyph);
+        }
+    }
+    std::vector<unsigned, Allocator<unsigned>> newMatches;
+    forEachCoveredGlyph(gpos, offset+gpos.uint16(offset+2), [&](unsigned first, unsigned) {
+        if (!present[first] || matches.firstGlyphs[first])
+            return;
+        newMatches.push_back(first);
+        unsigned class1 = glyphClass(gpos, classDef1, first);
+        if (class1 >= class1Count || secondGlyphs.empty())
+            return;
+        for (unsigned class2 = 0; class2 < class2Count; ++class2) {
+            if (int value = gpos.int16(records+recordSize*(class1*class2Count+class2)+xAdvanceOffset(valueFormat1))) {
+                for (unsigned second : secondGlyphs[class2]) {
+                    if (!matches.pairs.find(pairKey(first, second)))
+                        kerning[std::make_pair<int, int>((int) first, (int) second)] += value;
+                }
+            }
+        }
+    });
+    // Every pair starting with a covered glyph matches the subtable
+    for (unsigned first : newMatches)
+        matches.firstGlyphs[first] = true;
+}
+
+/// Adds the kerning of all PairPos lookups of the GPOS kern feature, returns false if there is no kern feature
+static bool readGposKerning(KerningMap &kerning, const FontTable &gpos, const std::vector<bool, Allocator<bool>> &present, const std::vector<unsigned, Allocator<unsigned>> &presentGlyphs) {
+    if (gpos.uint16(0) != 1)
+        return false;
+    size_t featureList = gpos.uint16(6), lookupList = gpos.uint16(8);
+    // Lookups of the kern feature of all scripts and languages are applied, each one once, in lookup list order
+    std::vector<unsigned, Allocator<unsigned>> lookups;
+    for (unsigned i = 0, featureCount = gpos.uint16(featureList); i < featureCount; ++i) {
+        size_t featureRecord = featureList+2+6*i;
+        if (gpos.uint32(featureRecord) == SFNT_TAG('k', 'e', 'r', 'n')) {
+            size_t feature = featureList+gpos.uint16(featureRecord+4);
+            for (unsigned j = 0, lookupCount = gpos.uint16(feature+2); j < lookupCount; ++j)
+                lookups.push_back(gpos.uint16(feature+4+2*j));
+        }
+    }
+    if (lookups.empty())
+        return false;
+    std::sort(lookups.begin(), lookups.end());
+    lookups.erase(std::unique(lookups.begin(), lookups.end()), lookups.end());
+    for (unsigned lookupIndex : lookups) {
+        if (lookupIndex >= gpos.uint16(lookupList))
+            continue;
+        size_t lookup = lookupList+gpos.uint16(lookupList+2+2*lookupIndex);
+        unsigned lookupType = gpos.uint16(lookup);
+        PairMatches matches;
+        for (unsigned i = 0, subtableCount = gpos.uint16(lookup+4); i < subtableCount; ++i) {
+            size_t subtable = lookup+gpos.uint16(lookup+6+2*i);
+            unsigned subtableType = lookupType;
+            // Extension subtables point to a subtable of the actual type with a 32-bit offset
+            if (lookupType == 9) {
+                if (gpos.uint16(subtable) != 1)
+                    continue;
+                subtableType = gpos.uint16(subtable+2);
+                subtable += gpos.uint32(subtable+4);
+            }
+            if (subtableType != 2)
+                continue;
+            switch (gpos.uint16(subtable)) {
+                case 1:
+                    readPairPosFormat1(kerning, matches, gpos, subtable, present);
+                    break;
+                case 2:
+                    readPairPosFormat2(kerning, matches, gpos, subtable, present, presentGlyphs);
+                    break;
+            }
+        }
+    }
+    return true;
+}
+
+/// Adds the kerning of the horizontal format 0 subtables of a legacy kern table, the same ones that FreeType uses
+static void readKernKerning(KerningMap &kerning, const FontTable &kern, const std::vector<bool, Allocator<bool>> &present) {
+    // Like FreeType, only the original version of the table is supported
+    if (kern.uint16(0) != 0)
+        return;
+    size_t subtable = 4;
+    for (unsigned i = 0, subtableCount = kern.uint16(2); i < subtableCount && subtable < kern.data.size(); ++i) {
+        size_t length = kern.uint16(subtable+2);
+        unsigned coverage = kern.uint16(subtable+4);
+        // Format 0, horizontal, no cross-stream or minimum values - bit 3 means values override rather than add to previous subtables
+        if ((coverage&~0x08u) == 0x0001) {
+            // The number of pairs is trusted over the subtable length, which overflows in large tables
+            size_t pairs = subtable+14;
+            size_t pairCount = std::min((size_t) kern.uint16(subtable+6), pairs < kern.data.size() ? (kern.data.size()-pairs)/6 : 0);
+            for (size_t j = 0; j < pairCount; ++j) {
+                size_t pair = pairs+6*j;
+                unsigned first = kern.uint16(pair), second = kern.uint16(pair+2);
+                if (present[first] && present[second]) {
+                    double &value = kerning[std::make_pair<int, int>((int) first, (int) second)];
+                    if (coverage&0x08)
+                        value = kern.int16(pair+4);
+                    else
+                        value += kern.int16(pair+4);
+                }
+            }
+        }
+        if (length < 6)
+            break;
+        subtable += length;
+    }
+}
+
+bool readKerningTables(KerningMap &kerning, msdfgen::FontHandle *font, const int *glyphIndices, int glyphCount) {
+    kerning.clear();
+    std::vector<bool, Allocator<bool>> present(SFNT_MAX_GLYPHS);
+    std::vector<unsigned, Allocator<unsigned>> presentGlyphs;
+    for (int i = 0; i < glyphCount; ++i) {
+        if (glyphIndices[i] >= 0 && glyphIndices[i] < SFNT_MAX_GLYPHS && !present[glyphIndices[i]]) {
+            present[glyphIndices[i]] = true;
+            presentGlyphs.push_back(glyphIndices[i]);
+        }
+    }
+    FontTable table;
+    if (!(msdfgen::getFontTable(table.data, font, SFNT_TAG('G', 'P', 'O', 'S')) && readGposKerning(kerning, table, present, presentGlyphs))) {
+        if (msdfgen::getFontTable(table.data, font, SFNT_TAG('k', 'e', 'r', 'n')))
+            readKernKerning(kerning, table, present);
+        else if (!msdfgen::getFontTable(table.data, font, SFNT_TAG('m', 'a', 'x', 'p'))) {
+            // Not an SFNT font - FreeType may still provide kerning from other sources, such as AFM files
+            return false;
+        }
+    }
+    for (KerningMap::iterator it = kerning.begin(); it != kerning.end();) {
+        if (it->second)
+            ++it;
+        else
+            it = kerning.erase(it);
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <utility>
+#include <map>
+#include <msdfgen.h>
+#include <msdfgen-ext.h>
+#include "types.h"
+
+namespace msdf_atlas {
+
+/**
+ * Reads the kerning between all pairs of the listed glyphs, in font units, directly from the font's GPOS table (pair adjustments of the kern feature),
+ * or from its legacy kern table if there is no GPOS kerning. Only non-zero values are output, replacing the previous contents of kerning.
+ * Returns false if the font is not an SFNT (TrueType or OpenType) font, in which case kerning must be queried pair by pair with msdfgen::getKerning.
+ */
+bool readKerningTables(std::map<std::pair<int, int>, double, std::less<std::pair<int, int>>, Allocator<std::pair<const std::pair<int, int>, double>>> &kerning, msdfgen::FontHandle *font, const int *glyphIndices, int glyphCount);
+
+}
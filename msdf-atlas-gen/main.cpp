@@ -13,6 +13,7 @@
 #include <cstring>
 #include <cassert>
 #include <vector>
+#include <deque>
 #include <algorithm>
 #include <thread>
 
@@ -87,17 +88,30 @@ ATLAS CONFIGURATION
       Selects the type of atlas to be generated.
 )"
 #ifndef MSDFGEN_DISABLE_PNG
-R"(  -format <png / bmp / tiff / rgba / fl32 / text / textfloat / bin / binfloat / binfloatbe>)"
+R"(  -format <png / bmp / tiff / rgba / fl32 / text / textfloat / bin / binfloat / binfloatbe / dds / ktx2>)"
 #else
-R"(  -format <bmp / tiff / rgba / fl32 / text / textfloat / bin / binfloat / binfloatbe>)"
+R"(  -format <bmp / tiff / rgba / fl32 / text / textfloat / bin / binfloat / binfloatbe / dds / ktx2>)"
 #endif
 R"(
       Selects the format for the atlas image output. Some image formats may be incompatible with embedded output formats.
+      DDS and KTX2 hold GPU block-compressed textures (BC4 for single-channel, BC7 for multi-channel atlases).
+  -mipmaps
+      Includes the full mip chain in DDS or KTX2 image output. Glyphs are downsampled within their own boxes
+      and distance fields keep the same pixel range in each level's own pixels.)"
+#ifdef MSDFGEN_USE_LIBPNG
+R"(
+  -pngcompression <fast / default / max>
+      Selects the trade-off between the speed and size of the PNG atlas image, which is encoded in parallel. The default is max.
+      Applies only to the atlas image output, PNG files saved through msdfgen::savePng always use the maximum level.)"
+#endif
+R"(
   -dimensions <width> <height>
       Sets the atlas to have fixed dimensions (width x height).
   -pots / -potr / -square / -square2 / -square4
       Picks the minimum atlas dimensions that fit all glyphs and satisfy the selected constraint:
       power of two square / ... rectangle / any square / square with side divisible by 2 / ... 4
+  -skyline
+      Uses a faster skyline packing algorithm for the tight layout, suitable for very large charsets, at the cost of slightly lower density.
   -uniformgrid
       Lays out the atlas into a uniform grid. Enables following options starting with -uniform:
     -uniformcols <N>
@@ -186,8 +200,22 @@ R"(
 R"(
   -seed <N>
       Sets the initial seed for the edge coloring heuristic.
+  -shapecache <directory>
+      Keeps preprocessed and colored glyph shapes in the directory, indexed by the font file's contents, so that subsequent runs need not process them again.
+  -incremental <layout.bin>
+      Rebuilds the atlas incrementally. Glyphs found unchanged in the layout file keep their bitmaps from the previous atlas image and if possible, their placement.
+      Only new or changed glyphs are generated and the layout file is updated afterwards. PNG and binary image output only.
   -threads <N>
       Sets the number of threads for the parallel computation. (0 = auto)
+  -streaming
+      Generates the atlas without ever holding all of it in memory.)"
+#ifdef MSDFGEN_USE_LIBPNG
+R"( PNG image output is generated in bands of rows, each encoded into the image file while the next one is generated.)"
+#endif
+R"(
+      FL32 image output is generated directly into the image file mapped into memory. PNG and FL32 image output only.
+  -trace <filename.json>
+      Records the duration of each processing stage of each glyph per thread into a Trace Event Format JSON file.
 )";
 
 static const char *errorCorrectionHelpText = R"(
@@ -257,31 +285,57 @@ static bool strStartsWith(const char *str, const char *prefix) {
     return true;
 }
 
-#ifndef MSDFGEN_DISABLE_VARIABLE_FONTS
-static msdfgen::FontHandle *loadVarFont(msdfgen::FreetypeHandle *library, const char *filename) {
-    std::string buffer;
+struct VariationAxis {
+    std::string name;
+    double coordinate;
+};
+
+/// Splits a filename of the form "path?axis=value&axis=value..." into the path of the font file and its variation axis coordinates
+static std::string parseVarFontFilename(const char *filename, std::vector<VariationAxis, Allocator<VariationAxis>> &axes) {
+    std::string path;
     while (*filename && *filename != '?')
-        buffer.push_back(*filename++);
-    msdfgen::FontHandle *font = msdfgen::loadFont(library, buffer.c_str());
-    if (font && *filename++ == '?') {
+        path.push_back(*filename++);
+    if (*filename++ == '?') {
         do {
-            buffer.clear();
+            VariationAxis axis = { };
             while (*filename && *filename != '=')
-                buffer.push_back(*filename++);
+                axis.name.push_back(*filename++);
             if (*filename == '=') {
-                double value = 0;
                 int skip = 0;
-                if (sscanf(++filename, "%lf%n", &value, &skip) == 1) {
-                    msdfgen::setFontVariationAxis(library, font, buffer.c_str(), value);
+                if (sscanf(++filename, "%lf%n", &axis.coordinate, &skip) == 1) {
+                    axes.push_back((VariationAxis &&) axis);
                     filename += skip;
                 }
             }
         } while (*filename++ == '&');
     }
+    return path;
+}
+
+#ifndef MSDFGEN_DISABLE_VARIABLE_FONTS
+static msdfgen::FontHandle *loadVarFont(msdfgen::FreetypeHandle *library, const char *filename) {
+    std::vector<VariationAxis, Allocator<VariationAxis>> axes;
+    msdfgen::FontHandle *font = msdfgen::loadFont(library, parseVarFontFilename(filename, axes).c_str());
+    if (font) {
+        for (const VariationAxis &axis : axes)
+            msdfgen::setFontVariationAxis(library, font, axis.name.c_str(), axis.coordinate);
+    }
     return font;
 }
 #endif
 
+/// Maps the font file for loading from multiple threads, with variation coordinates specified the same way as for loadVarFont
+static bool openFontFile(FontFile &fontFile, const char *filename, bool isVarFont) {
+    if (!isVarFont)
+        return fontFile.open(filename);
+    std::vector<VariationAxis, Allocator<VariationAxis>> axes;
+    if (!fontFile.open(parseVarFontFilename(filename, axes).c_str()))
+        return false;
+    for (const VariationAxis &axis : axes)
+        fontFile.setVariationAxis(axis.name.c_str(), axis.coordinate);
+    return true;
+}
+
 enum class Units {
     /// Value is specified in ems
     EMS,
@@ -302,6 +356,7 @@ struct FontInput {
 struct Configuration {
     ImageType imageType;
     ImageFormat imageFormat;
+    PngCompression pngCompression;
     YDirection yDirection;
     int width, height;
     double emSize;
@@ -321,12 +376,20 @@ struct Configuration {
     bool preprocessGeometry;
     bool kerning;
     int threadCount;
+    bool streaming;
+    bool mipmaps;
+    const char *shapeCacheDirectory;
+    const char *layoutStateFilename;
+    /// Box of each glyph in the previous atlas image to reuse its bitmap from (empty if none), null if not rebuilding incrementally
+    const Rectangle *previousBoxes;
+    int previousWidth, previousHeight;
     const char *arteryFontFilename;
     const char *imageFilename;
     const char *jsonFilename;
     const char *csvFilename;
     const char *shadronPreviewFilename;
     const char *shadronPreviewText;
+    Tracer *tracer;
 };
 
 template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
@@ -334,13 +397,48 @@ static bool makeAtlas(const std::vector<GlyphGeometry, Allocator<GlyphGeometry>>
     ImmediateAtlasGenerator<S, N, GEN_FN, BitmapAtlasStorage<T, N> > generator(config.width, config.height);
     generator.setAttributes(config.generatorAttributes);
     generator.setThreadCount(config.threadCount);
-    generator.generate(glyphs.data(), glyphs.size());
+    generator.setTracer(config.tracer);
+    const GlyphGeometry *generatedGlyphs = glyphs.data();
+    size_t generatedCount = glyphs.size();
+    std::vector<GlyphGeometry, Allocator<GlyphGeometry>> changedGlyphs;
+    if (config.previousBoxes) {
+        // Copy bitmaps of unchanged glyphs from the previous atlas image and only generate the rest
+        msdfgen::Bitmap<T, N> previousBitmap;
+        if (loadImage(previousBitmap, config.imageFormat, config.imageFilename, config.previousWidth, config.previousHeight, config.yDirection)) {
+            msdfgen::BitmapRef<T, N> atlas = (msdfgen::BitmapRef<T, N>) generator.mutableAtlasStorage();
+            for (size_t i = 0; i < glyphs.size(); ++i) {
+                const Rectangle &previousBox = config.previousBoxes[i];
+                if (previousBox.w > 0 && previousBox.h > 0) {
+                    int x, y, w, h;
+                    glyphs[i].getBoxRect(x, y, w, h);
+                    blit(atlas, previousBitmap, x, y, previousBox.x, previousBox.y, w, h);
+                } else
+                    changedGlyphs.push_back(glyphs[i]);
+            }
+            generatedGlyphs = changedGlyphs.data();
+            generatedCount = changedGlyphs.size();
+        } else
+            fputs("Failed to load the previous atlas image, all glyphs will be generated.\n", stderr);
+    }
+    generator.generate(generatedGlyphs, generatedCount);
     msdfgen::BitmapConstRef<T, N> bitmap = (msdfgen::BitmapConstRef<T, N>) generator.atlasStorage();
 
     bool success = true;
 
     if (config.imageFilename) {
-        if (saveImage(bitmap, config.imageFormat, config.imageFilename, config.yDirection))
+        std::vector<msdfgen::Bitmap<T, N>, Allocator<msdfgen::Bitmap<T, N> > > mipLevels;
+        if (config.mipmaps && !generateMipmaps(mipLevels, bitmap, glyphs.data(), (int) glyphs.size(), config.imageType, mipLevelCount(bitmap.width, bitmap.height), config.threadCount)) {
+            mipLevels.clear();
+            fputs("Failed to generate mipmaps.\n", stderr);
+        }
+        bool saved = (
+        #ifdef MSDFGEN_USE_LIBPNG
+            config.imageFormat == ImageFormat::PNG ? savePng(bitmap, config.imageFilename, config.pngCompression, config.threadCount) :
+        #endif
+            config.imageFormat == ImageFormat::DDS || config.imageFormat == ImageFormat::KTX2 ? saveCompressedImage(bitmap, mipLevels.data(), (int) mipLevels.size(), config.imageFormat, config.imageFilename, config.threadCount) :
+            saveImage(bitmap, config.imageFormat, config.imageFilename, config.yDirection)
+        );
+        if (saved)
             fputs("Atlas image file saved.\n", stderr);
         else {
             success = false;
@@ -368,6 +466,47 @@ static bool makeAtlas(const std::vector<GlyphGeometry, Allocator<GlyphGeometry>>
     return success;
 }
 
+template <typename S, int N, GeneratorFunction<S, N> GEN_FN>
+static bool makeAtlasStreamed(const std::vector<GlyphGeometry, Allocator<GlyphGeometry>> &glyphs, const Configuration &config) {
+#ifdef MSDFGEN_USE_LIBPNG
+    StreamingAtlasGenerator<byte, S, N, GEN_FN> generator(config.width, config.height);
+    generator.setAttributes(config.generatorAttributes);
+    generator.setThreadCount(config.threadCount);
+    generator.setTracer(config.tracer);
+    PngWriter pngWriter;
+    bool success = pngWriter.open(config.imageFilename, config.width, config.height, N, config.pngCompression) && generator.generate(glyphs.data(), glyphs.size(), [&pngWriter](const msdfgen::BitmapConstSection<byte, N> &band) -> bool {
+        for (int y = band.height-1; y >= 0; --y) {
+            if (!pngWriter.writeRow(band(0, y)))
+                return false;
+        }
+        return true;
+    });
+    if (pngWriter.close() && success) {
+        fputs("Atlas image file saved.\n", stderr);
+        return true;
+    }
+#endif
+    fputs("Failed to save the atlas as an image file.\n", stderr);
+    return false;
+}
+
+template <int N, GeneratorFunction<float, N> GEN_FN>
+static bool makeAtlasMapped(const std::vector<GlyphGeometry, Allocator<GlyphGeometry>> &glyphs, const Configuration &config) {
+    ImmediateAtlasGenerator<float, N, GEN_FN, MappedAtlasStorage<float, N> > generator(config.width, config.height, config.imageFilename, MappedAtlasStorage<float, N>::FL32);
+    if (generator.atlasStorage().isValid()) {
+        generator.setAttributes(config.generatorAttributes);
+        generator.setThreadCount(config.threadCount);
+        generator.setTracer(config.tracer);
+        generator.generate(glyphs.data(), glyphs.size());
+        if (generator.mutableAtlasStorage().flush()) {
+            fputs("Atlas image file saved.\n", stderr);
+            return true;
+        }
+    }
+    fputs("Failed to save the atlas as an image file.\n", stderr);
+    return false;
+}
+
 int main(int argc, const char *const *argv) {
     #define ABORT(msg) do { fputs(msg "\n", stderr); return 1; } while (false)
 
@@ -379,6 +518,7 @@ int main(int argc, const char *const *argv) {
     fontInput.fontScale = -1;
     config.imageType = ImageType::MSDF;
     config.imageFormat = ImageFormat::UNSPECIFIED;
+    config.pngCompression = PngCompression::MAX;
     config.yDirection = YDirection::BOTTOM_UP;
     config.grid.fixedOriginX = false, config.grid.fixedOriginY = true;
     config.edgeColoring = msdfgen::edgeColoringInkTrap;
@@ -409,6 +549,7 @@ int main(int argc, const char *const *argv) {
     config.miterLimit = DEFAULT_MITER_LIMIT;
     config.pxAlignOriginX = false, config.pxAlignOriginY = true;
     config.threadCount = 0;
+    const char *traceFilename = nullptr;
 
     // Parse command line
     int argPos = 1;
@@ -467,17 +608,39 @@ int main(int argc, const char *const *argv) {
                 config.imageFormat = ImageFormat::BINARY_FLOAT;
             else if (ARG_IS("binfloatbe"))
                 config.imageFormat = ImageFormat::BINARY_FLOAT_BE;
+            else if (ARG_IS("dds"))
+                config.imageFormat = ImageFormat::DDS;
+            else if (ARG_IS("ktx2") || ARG_IS("ktx"))
+                config.imageFormat = ImageFormat::KTX2;
             else {
                 #ifndef MSDFGEN_DISABLE_PNG
-                    ABORT("Invalid image format. Valid formats are: png, bmp, tiff, rgba, fl32, text, textfloat, bin, binfloat, binfloatbe");
+                    ABORT("Invalid image format. Valid formats are: png, bmp, tiff, rgba, fl32, text, textfloat, bin, binfloat, binfloatbe, dds, ktx2");
                 #else
-                    ABORT("Invalid image format. Valid formats are: bmp, tiff, rgba, fl32, text, textfloat, bin, binfloat, binfloatbe");
+                    ABORT("Invalid image format. Valid formats are: bmp, tiff, rgba, fl32, text, textfloat, bin, binfloat, binfloatbe, dds, ktx2");
                 #endif
             }
             imageFormatName = arg;
             ++argPos;
             continue;
         }
+        ARG_CASE("-mipmaps", 0) {
+            config.mipmaps = true;
+            continue;
+        }
+    #ifdef MSDFGEN_USE_LIBPNG
+        ARG_CASE("-pngcompression", 1) {
+            if (ARG_IS("fast"))
+                config.pngCompression = PngCompression::FAST;
+            else if (ARG_IS("default"))
+                config.pngCompression = PngCompression::DEFAULT;
+            else if (ARG_IS("max"))
+                config.pngCompression = PngCompression::MAX;
+            else
+                ABORT("Invalid PNG compression. Use -pngcompression <fast / default / max>.");
+            ++argPos;
+            continue;
+        }
+    #endif
         ARG_CASE("-font", 1) {
             fontInput.fontFilename = argv[argPos++];
             fontInput.variableFont = false;
@@ -740,6 +903,10 @@ int main(int argc, const char *const *argv) {
             config.angleThreshold = at;
             continue;
         }
+        ARG_CASE("-skyline", 0) {
+            packingStyle = PackingStyle::SKYLINE;
+            continue;
+        }
         ARG_CASE("-uniformgrid", 0) {
             packingStyle = PackingStyle::GRID;
             continue;
@@ -899,6 +1066,14 @@ int main(int argc, const char *const *argv) {
                 ABORT("Invalid seed. Use -seed <N> with N being a non-negative integer.");
             continue;
         }
+        ARG_CASE("-shapecache", 1) {
+            config.shapeCacheDirectory = argv[argPos++];
+            continue;
+        }
+        ARG_CASE("-incremental", 1) {
+            config.layoutStateFilename = argv[argPos++];
+            continue;
+        }
         ARG_CASE("-threads", 1) {
             unsigned tc;
             if (!(parseUnsigned(tc, argv[argPos++]) && (int) tc >= 0))
@@ -906,6 +1081,14 @@ int main(int argc, const char *const *argv) {
             config.threadCount = (int) tc;
             continue;
         }
+        ARG_CASE("-streaming", 0) {
+            config.streaming = true;
+            continue;
+        }
+        ARG_CASE("-trace", 1) {
+            traceFilename = argv[argPos++];
+            continue;
+        }
         ARG_CASE("-version", 0) {
             puts(versionText);
             return 0;
@@ -959,7 +1142,7 @@ int main(int argc, const char *const *argv) {
         fontInputs.push_back(fontInput);
 
     // Fix up configuration based on related values
-    if (packingStyle == PackingStyle::TIGHT && atlasSizeConstraint == DimensionsConstraint::NONE)
+    if ((packingStyle == PackingStyle::TIGHT || packingStyle == PackingStyle::SKYLINE) && atlasSizeConstraint == DimensionsConstraint::NONE)
         atlasSizeConstraint = DimensionsConstraint::MULTIPLE_OF_FOUR_SQUARE;
     if (!(config.imageType == ImageType::PSDF || config.imageType == ImageType::MSDF || config.imageType == ImageType::MTSDF))
         config.miterLimit = 0;
@@ -1009,6 +1192,8 @@ int main(int argc, const char *const *argv) {
         else if (cmpExtension(config.imageFilename, ".fl32")) imageExtension = ImageFormat::FL32;
         else if (cmpExtension(config.imageFilename, ".txt")) imageExtension = ImageFormat::TEXT;
         else if (cmpExtension(config.imageFilename, ".bin")) imageExtension = ImageFormat::BINARY;
+        else if (cmpExtension(config.imageFilename, ".dds")) imageExtension = ImageFormat::DDS;
+        else if (cmpExtension(config.imageFilename, ".ktx2")) imageExtension = ImageFormat::KTX2;
     }
     if (config.imageFormat == ImageFormat::UNSPECIFIED) {
         #ifndef MSDFGEN_DISABLE_PNG
@@ -1056,6 +1241,34 @@ int main(int argc, const char *const *argv) {
             fprintf(stderr, "Warning: Output image file extension does not match the image's actual format (%s)!\n", imageFormatName);
     }
     imageFormatName = nullptr; // No longer consistent with imageFormat
+    if (config.streaming && !(config.imageFilename && (
+        #ifdef MSDFGEN_USE_LIBPNG
+            config.imageFormat == ImageFormat::PNG ||
+        #endif
+        config.imageFormat == ImageFormat::FL32
+    ) && !config.arteryFontFilename)) {
+        config.streaming = false;
+        fputs("Warning: Streaming is only possible with PNG or FL32 image output and no Artery Font output, the atlas will be generated at once.\n", stderr);
+    }
+    if (config.mipmaps && !(config.imageFilename && (config.imageFormat == ImageFormat::DDS || config.imageFormat == ImageFormat::KTX2))) {
+        config.mipmaps = false;
+        fputs("Warning: Mipmaps can only be stored in DDS or KTX2 image output and will not be generated.\n", stderr);
+    }
+    if (config.layoutStateFilename && !(config.imageFilename && (
+        #ifdef MSDFGEN_USE_LIBPNG
+            config.imageFormat == ImageFormat::PNG ||
+        #endif
+        config.imageFormat == ImageFormat::BINARY ||
+        config.imageFormat == ImageFormat::BINARY_FLOAT ||
+        config.imageFormat == ImageFormat::BINARY_FLOAT_BE
+    ))) {
+        config.layoutStateFilename = nullptr;
+        fputs("Warning: Incremental rebuild is only possible with PNG or binary image output, the whole atlas will be generated.\n", stderr);
+    }
+    if (config.layoutStateFilename && config.streaming) {
+        config.streaming = false;
+        fputs("Warning: Streaming is not possible with incremental rebuild, the atlas will be generated at once.\n", stderr);
+    }
     bool floatingPointFormat = (
         config.imageFormat == ImageFormat::TIFF ||
         config.imageFormat == ImageFormat::FL32 ||
@@ -1066,10 +1279,18 @@ int main(int argc, const char *const *argv) {
     // TODO: In this case (if spacing is -1), the border pixels of each glyph are black, but still computed. For floating-point output, this may play a role.
     int spacing = config.imageType == ImageType::MSDF || config.imageType == ImageType::MTSDF ? 0 : -1;
     double uniformOriginX, uniformOriginY;
+    Tracer tracer;
+    if (traceFilename)
+        config.tracer = &tracer;
 
     // Load fonts
     std::vector<GlyphGeometry, Allocator<GlyphGeometry>> glyphs;
     std::vector<FontGeometry, Allocator<FontGeometry>> fonts;
+    std::deque<ShapeCache, Allocator<ShapeCache>> shapeCaches;
+    std::vector<Rectangle, Allocator<Rectangle>> previousBoxes;
+    unsigned long long settingsHash = AtlasLayoutState::hashSettings(config.imageType, config.imageFormat, config.yDirection, config.generatorAttributes);
+    // Shape cache of each glyph (null if not cached), empty if shape cache is disabled
+    std::vector<ShapeCache *, Allocator<ShapeCache *>> glyphShapeCaches;
     bool anyCodepointsAvailable = false;
     {
         class FontHolder {
@@ -1129,24 +1350,58 @@ int main(int argc, const char *const *argv) {
             else
                 charset = Charset::ASCII;
 
-            // Load glyphs
+            // Open shape cache
+            ShapeCache *shapeCache = nullptr;
+            if (config.shapeCacheDirectory) {
+                std::string fontFilename = fontInput.fontFilename;
+                const char *variation = nullptr;
+                size_t variationPos = fontInput.variableFont ? fontFilename.find('?') : std::string::npos;
+                if (variationPos != std::string::npos) {
+                    variation = fontInput.fontFilename+variationPos+1;
+                    fontFilename.resize(variationPos);
+                }
+                shapeCaches.emplace_back();
+                if (shapeCaches.back().open(config.shapeCacheDirectory, fontFilename.c_str(), variation, config.preprocessGeometry))
+                    shapeCache = &shapeCaches.back();
+                else {
+                    shapeCaches.pop_back();
+                    fputs("Warning: Failed to open shape cache, glyphs will be loaded from the font.\n", stderr);
+                }
+            }
+
+            // Load glyphs - in parallel if the font file can be mapped into memory
             FontGeometry fontGeometry(&glyphs);
+            FontFile fontFile;
+            bool parallelLoad = config.threadCount > 1 && openFontFile(fontFile, fontInput.fontFilename, fontInput.variableFont);
             int glyphsLoaded = -1;
+            Tracer::TimePoint loadBegin = Tracer::now();
             switch (fontInput.glyphIdentifierType) {
                 case GlyphIdentifierType::GLYPH_INDEX:
                     if (allGlyphCount)
-                        glyphsLoaded = fontGeometry.loadGlyphRange(font, fontInput.fontScale, 0, allGlyphCount, config.preprocessGeometry, config.kerning);
+                        glyphsLoaded = parallelLoad ?
+                            fontGeometry.loadGlyphRange(fontFile, fontInput.fontScale, 0, allGlyphCount, config.threadCount, config.preprocessGeometry, config.kerning, shapeCache) :
+                            fontGeometry.loadGlyphRange(font, fontInput.fontScale, 0, allGlyphCount, config.preprocessGeometry, config.kerning, shapeCache);
                     else
-                        glyphsLoaded = fontGeometry.loadGlyphset(font, fontInput.fontScale, charset, config.preprocessGeometry, config.kerning);
+                        glyphsLoaded = parallelLoad ?
+                            fontGeometry.loadGlyphset(fontFile, fontInput.fontScale, charset, config.threadCount, config.preprocessGeometry, config.kerning, shapeCache) :
+                            fontGeometry.loadGlyphset(font, fontInput.fontScale, charset, config.preprocessGeometry, config.kerning, shapeCache);
                     break;
                 case GlyphIdentifierType::UNICODE_CODEPOINT:
-                    glyphsLoaded = fontGeometry.loadCharset(font, fontInput.fontScale, charset, config.preprocessGeometry, config.kerning);
+                    glyphsLoaded = parallelLoad ?
+                        fontGeometry.loadCharset(fontFile, fontInput.fontScale, charset, config.threadCount, config.preprocessGeometry, config.kerning, shapeCache) :
+                        fontGeometry.loadCharset(font, fontInput.fontScale, charset, config.preprocessGeometry, config.kerning, shapeCache);
                     anyCodepointsAvailable |= glyphsLoaded > 0;
                     break;
             }
             if (glyphsLoaded < 0)
                 ABORT("Failed to load glyphs from font.");
+            if (config.tracer)
+                config.tracer->record(0, "load", -1, loadBegin, Tracer::now());
+            if (config.shapeCacheDirectory)
+                glyphShapeCaches.resize(glyphs.size(), shapeCache);
             printf("Loaded geometry of %d out of %d glyphs", glyphsLoaded, (int) (allGlyphCount+charset.size()));
+            if (shapeCache)
+                printf(" (%d from cache)", shapeCache->getHitCount());
             if (fontInputs.size() > 1)
                 printf(" from font \"%s\"", fontInput.fontFilename);
             printf(".\n");
@@ -1216,10 +1471,14 @@ int main(int argc, const char *const *argv) {
         }
         bool fixedDimensions = fixedWidth >= 0 && fixedHeight >= 0;
         bool fixedScale = config.emSize > 0;
+        Tracer::TimePoint packBegin = Tracer::now();
         switch (packingStyle) {
 
-            case PackingStyle::TIGHT: {
+            case PackingStyle::TIGHT:
+            case PackingStyle::SKYLINE: {
                 TightAtlasPacker atlasPacker;
+                atlasPacker.setSkylinePacking(packingStyle == PackingStyle::SKYLINE);
+                atlasPacker.setThreadCount(config.threadCount);
                 if (fixedDimensions)
                     atlasPacker.setDimensions(fixedWidth, fixedHeight);
                 else
@@ -1278,6 +1537,7 @@ int main(int argc, const char *const *argv) {
                 atlasPacker.setPixelRange(pxRange);
                 atlasPacker.setUnitRange(emRange);
                 atlasPacker.setMiterLimit(config.miterLimit);
+                atlasPacker.setThreadCount(config.threadCount);
                 atlasPacker.setOriginPixelAlignment(config.pxAlignOriginX, config.pxAlignOriginY);
                 atlasPacker.setInnerUnitPadding(innerEmPadding);
                 atlasPacker.setOuterUnitPadding(outerEmPadding);
@@ -1328,6 +1588,8 @@ int main(int argc, const char *const *argv) {
             }
 
         }
+        if (config.tracer)
+            config.tracer->record(0, "pack", -1, packBegin, Tracer::now());
     }
 
     // Generate atlas bitmap
@@ -1335,57 +1597,112 @@ int main(int argc, const char *const *argv) {
 
         // Edge coloring
         if (config.imageType == ImageType::MSDF || config.imageType == ImageType::MTSDF) {
-            if (config.expensiveColoring) {
-                Workload([&glyphs, &config](int i, int threadNo) -> bool {
-                    unsigned long long glyphSeed = (LCG_MULTIPLIER*(config.coloringSeed^i)+LCG_INCREMENT)*!!config.coloringSeed;
-                    glyphs[i].edgeColoring(config.edgeColoring, config.angleThreshold, glyphSeed);
-                    return true;
-                }, glyphs.size()).finish(config.threadCount);
-            } else {
+            // The seeds of the non-expensive strategies form a sequence, which is precomputed so that glyphs can be colored in parallel
+            std::vector<unsigned long long, Allocator<unsigned long long>> glyphSeeds;
+            if (!config.expensiveColoring) {
+                glyphSeeds.resize(glyphs.size());
                 unsigned long long glyphSeed = config.coloringSeed;
-                for (GlyphGeometry &glyph : glyphs) {
-                    glyphSeed *= LCG_MULTIPLIER;
-                    glyph.edgeColoring(config.edgeColoring, config.angleThreshold, glyphSeed);
-                }
+                for (unsigned long long &seed : glyphSeeds)
+                    seed = glyphSeed *= LCG_MULTIPLIER;
             }
+            if (config.tracer)
+                config.tracer->reserveThreads(config.threadCount);
+            Workload([&glyphs, &glyphSeeds, &glyphShapeCaches, &config](int i, int threadNo) -> bool {
+                unsigned long long glyphSeed = glyphSeeds.empty() ? (LCG_MULTIPLIER*(config.coloringSeed^i)+LCG_INCREMENT)*!!config.coloringSeed : glyphSeeds[i];
+                Tracer::TimePoint coloringBegin = Tracer::now();
+                if (ShapeCache *shapeCache = glyphShapeCaches.empty() ? nullptr : glyphShapeCaches[i])
+                    shapeCache->edgeColoring(glyphs[i], config.edgeColoring, config.angleThreshold, glyphSeed);
+                else
+                    glyphs[i].edgeColoring(config.edgeColoring, config.angleThreshold, glyphSeed);
+                if (config.tracer)
+                    config.tracer->record(threadNo, "edge coloring", glyphs[i].getIndex(), coloringBegin, Tracer::now());
+                return true;
+            }, glyphs.size()).finish(config.threadCount);
+        }
+
+        // Find glyphs unchanged since the previous build
+        if (config.layoutStateFilename) {
+            AtlasLayoutState previousLayout;
+            if (previousLayout.load(config.layoutStateFilename)) {
+                previousBoxes.resize(glyphs.size());
+                int reusable = previousLayout.findGlyphs(previousBoxes.data(), glyphs.data(), (int) glyphs.size(), settingsHash);
+                bool placementKept = reusable && packingStyle != PackingStyle::GRID && AtlasLayoutState::restorePlacement(glyphs.data(), previousBoxes.data(), (int) glyphs.size(), config.width, config.height, spacing);
+                config.previousBoxes = previousBoxes.data();
+                config.previousWidth = previousLayout.getWidth(), config.previousHeight = previousLayout.getHeight();
+                printf("Reusing %d out of %d glyphs from the previous atlas%s.\n", reusable, (int) glyphs.size(), placementKept ? " in place" : "");
+            } else
+                fputs("Previous atlas layout not found, all glyphs will be generated.\n", stderr);
         }
 
         bool success = false;
         switch (config.imageType) {
             case ImageType::HARD_MASK:
-                if (floatingPointFormat)
+                if (floatingPointFormat && config.streaming)
+                    success = makeAtlasMapped<1, scanlineGenerator>(glyphs, config);
+                else if (floatingPointFormat)
                     success = makeAtlas<float, float, 1, scanlineGenerator>(glyphs, fonts, config);
+                else if (config.streaming)
+                    success = makeAtlasStreamed<float, 1, scanlineGenerator>(glyphs, config);
                 else
                     success = makeAtlas<byte, float, 1, scanlineGenerator>(glyphs, fonts, config);
                 break;
             case ImageType::SOFT_MASK:
             case ImageType::SDF:
-                if (floatingPointFormat)
+                if (floatingPointFormat && config.streaming)
+                    success = makeAtlasMapped<1, sdfGenerator>(glyphs, config);
+                else if (floatingPointFormat)
                     success = makeAtlas<float, float, 1, sdfGenerator>(glyphs, fonts, config);
+                else if (config.streaming)
+                    success = makeAtlasStreamed<float, 1, sdfGenerator>(glyphs, config);
                 else
                     success = makeAtlas<byte, float, 1, sdfGenerator>(glyphs, fonts, config);
                 break;
             case ImageType::PSDF:
-                if (floatingPointFormat)
+                if (floatingPointFormat && config.streaming)
+                    success = makeAtlasMapped<1, psdfGenerator>(glyphs, config);
+                else if (floatingPointFormat)
                     success = makeAtlas<float, float, 1, psdfGenerator>(glyphs, fonts, config);
+                else if (config.streaming)
+                    success = makeAtlasStreamed<float, 1, psdfGenerator>(glyphs, config);
                 else
                     success = makeAtlas<byte, float, 1, psdfGenerator>(glyphs, fonts, config);
                 break;
             case ImageType::MSDF:
-                if (floatingPointFormat)
+                if (floatingPointFormat && config.streaming)
+                    success = makeAtlasMapped<3, msdfGenerator>(glyphs, config);
+                else if (floatingPointFormat)
                     success = makeAtlas<float, float, 3, msdfGenerator>(glyphs, fonts, config);
+                else if (config.streaming)
+                    success = makeAtlasStreamed<float, 3, msdfGenerator>(glyphs, config);
                 else
                     success = makeAtlas<byte, float, 3, msdfGenerator>(glyphs, fonts, config);
                 break;
             case ImageType::MTSDF:
-                if (floatingPointFormat)
+                if (floatingPointFormat && config.streaming)
+                    success = makeAtlasMapped<4, mtsdfGenerator>(glyphs, config);
+                else if (floatingPointFormat)
                     success = makeAtlas<float, float, 4, mtsdfGenerator>(glyphs, fonts, config);
+                else if (config.streaming)
+                    success = makeAtlasStreamed<float, 4, mtsdfGenerator>(glyphs, config);
                 else
                     success = makeAtlas<byte, float, 4, mtsdfGenerator>(glyphs, fonts, config);
                 break;
         }
         if (!success)
             result = 1;
+        else if (config.layoutStateFilename) {
+            if (AtlasLayoutState(glyphs.data(), (int) glyphs.size(), config.width, config.height, settingsHash).save(config.layoutStateFilename))
+                fputs("Atlas layout state saved.\n", stderr);
+            else {
+                result = 1;
+                fputs("Failed to save the atlas layout state.\n", stderr);
+            }
+        }
+    }
+
+    for (ShapeCache &shapeCache : shapeCaches) {
+        if (!shapeCache.save())
+            fputs("Warning: Failed to write shape cache file.\n", stderr);
     }
 
     if (config.csvFilename) {
@@ -1439,6 +1756,15 @@ int main(int argc, const char *const *argv) {
         }
     }
 
+    if (config.tracer) {
+        if (config.tracer->exportJSON(traceFilename))
+            fputs("Trace events written into JSON file.\n", stderr);
+        else {
+            result = 1;
+            fputs("Failed to write trace output file.\n", stderr);
+        }
+    }
+
     return result;
 }
 
@@ -0,0 +1,156 @@
+
+#include "mipmap-generation.h"
+
+#include <algorithm>
+#include <core/pixel-conversion.hpp>
+#include "Workload.h"
+
+namespace msdf_atlas {
+
+static float pixelToFloat(byte value) {
+    return msdfgen::pixelByteToFloat(value);
+}
+
+static float pixelToFloat(float value) {
+    return value;
+}
+
+static void floatToPixel(byte &pixel, float value) {
+    pixel = msdfgen::pixelFloatToByte(value);
+}
+
+static void floatToPixel(float &pixel, float value) {
+    pixel = value;
+}
+
+static float median(float a, float b, float c) {
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+int mipLevelCount(int width, int height) {
+    int levelCount = 1;
+    for (int size = std::max(width, height); size > 1; size >>= 1)
+        ++levelCount;
+    return levelCount;
+}
+
+template <typename T, int N>
+static bool generateMipLevels(std::vector<msdfgen::Bitmap<T, N>, Allocator<msdfgen::Bitmap<T, N> > > &levels, const msdfgen::BitmapConstRef<T, N> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount) {
+    if (!(atlas.pixels && atlas.width > 0 && atlas.height > 0))
+        return false;
+    levelCount = std::min(levelCount, mipLevelCount(atlas.width, atlas.height));
+    bool distanceField = imageType != ImageType::HARD_MASK && imageType != ImageType::SOFT_MASK;
+    bool multiChannel = N >= 3 && (imageType == ImageType::MSDF || imageType == ImageType::MTSDF);
+
+    // Index of the glyph box each pixel belongs to, -1 for none
+    std::vector<int, Allocator<int> > owners((size_t) atlas.width*atlas.height, -1), nextOwners;
+    for (int i = 0; i < glyphCount; ++i) {
+        int l, b, w, h;
+        glyphs[i].getBoxRect(l, b, w, h);
+        for (int y = std::max(b, 0); y < std::min(b+h, atlas.height); ++y) {
+            for (int x = std::max(l, 0); x < std::min(l+w, atlas.width); ++x)
+                owners[(size_t) atlas.width*y+x] = i;
+        }
+    }
+
+    // Levels must not be reallocated while referenced by prev
+    levels.reserve(levels.size()+std::max(levelCount-1, 0));
+    msdfgen::BitmapConstRef<T, N> prev = atlas;
+    for (int level = 1; level < levelCount; ++level) {
+        int width = std::max(prev.width>>1, 1), height = std::max(prev.height>>1, 1);
+        levels.push_back(msdfgen::Bitmap<T, N>(width, height));
+        msdfgen::BitmapRef<T, N> next = (msdfgen::BitmapRef<T, N>) levels.back();
+        nextOwners.resize((size_t) width*height);
+        if (!Workload([&](int y, int) -> bool {
+            // The last row and column of the level also cover the remainder of an odd-sized previous level
+            int y0 = std::min(2*y, prev.height-1), y1 = y == height-1 ? prev.height : std::min(2*y+2, prev.height);
+            for (int x = 0; x < width; ++x) {
+                int x0 = std::min(2*x, prev.width-1), x1 = x == width-1 ? prev.width : std::min(2*x+2, prev.width);
+                // The pixel belongs to the glyph box covering most of its source pixels, preferring boxes over empty space
+                int owner = -1, ownerCount = 0;
+                for (int sy = y0; sy < y1; ++sy) {
+                    for (int sx = x0; sx < x1; ++sx) {
+                        int candidate = owners[(size_t) prev.width*sy+sx];
+                        if (candidate == owner || (candidate < 0 && owner >= 0))
+                            continue;
+                        int count = 0;
+                        for (int cy = y0; cy < y1; ++cy) {
+                            for (int cx = x0; cx < x1; ++cx)
+                                count += owners[(size_t) prev.width*cy+cx] == candidate;
+                        }
+                        if (count > ownerCount || owner < 0) {
+                            owner = candidate;
+                            ownerCount = count;
+                        }
+                    }
+                }
+                float sum[4] = { }, medianSum = 0;
+                int count = 0;
+                for (int sy = y0; sy < y1; ++sy) {
+                    for (int sx = x0; sx < x1; ++sx) {
+                        if (owners[(size_t) prev.width*sy+sx] != owner)
+                            continue;
+                        const T *pixel = prev(sx, sy);
+                        for (int i = 0; i < N; ++i)
+                            sum[i] += pixelToFloat(pixel[i]);
+                        if (multiChannel)
+                            medianSum += median(pixelToFloat(pixel[0]), pixelToFloat(pixel[1]), pixelToFloat(pixel[2]));
+                        ++count;
+                    }
+                }
+                float value[4] = { };
+                for (int i = 0; i < N; ++i) {
+                    value[i] = sum[i]/float(count);
+                    // The same distance spans half as many pixels in the next level
+                    if (distanceField)
+                        value[i] = .5f+.5f*(value[i]-.5f);
+                }
+                if (multiChannel) {
+                    // The median of averaged channels may fall on the other side of the edge than the average of medians,
+                    // in which case the color channels are shifted so that their median matches the latter
+                    float targetMedian = .5f+.5f*(medianSum/float(count)-.5f);
+                    float actualMedian = median(value[0], value[1], value[2]);
+                    if ((actualMedian >= .5f) != (targetMedian >= .5f)) {
+                        for (int i = 0; i < 3; ++i)
+                            value[i] += targetMedian-actualMedian;
+                    }
+                }
+                T *pixel = next(x, y);
+                for (int i = 0; i < N; ++i)
+                    floatToPixel(pixel[i], value[i]);
+                nextOwners[(size_t) width*y+x] = owner;
+            }
+            return true;
+        }, height).finish(threadCount))
+            return false;
+        owners.swap(nextOwners);
+        prev = levels.back();
+    }
+    return true;
+}
+
+bool generateMipmaps(std::vector<msdfgen::Bitmap<byte, 1>, Allocator<msdfgen::Bitmap<byte, 1> > > &levels, const msdfgen::BitmapConstRef<byte, 1> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount) {
+    return generateMipLevels(levels, atlas, glyphs, glyphCount, imageType, levelCount, threadCount);
+}
+
+bool generateMipmaps(std::vector<msdfgen::Bitmap<byte, 3>, Allocator<msdfgen::Bitmap<byte, 3> > > &levels, const msdfgen::BitmapConstRef<byte, 3> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount) {
+    return generateMipLevels(levels, atlas, glyphs, glyphCount, imageType, levelCount, threadCount);
+}
+
+bool generateMipmaps(std::vector<msdfgen::Bitmap<byte, 4>, Allocator<msdfgen::Bitmap<byte, 4> > > &levels, const msdfgen::BitmapConstRef<byte, 4> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount) {
+    return generateMipLevels(levels, atlas, glyphs, glyphCount, imageType, levelCount, threadCount);
+}
+
+bool generateMipmaps(std::vector<msdfgen::Bitmap<float, 1>, Allocator<msdfgen::Bitmap<float, 1> > > &levels, const msdfgen::BitmapConstRef<float, 1> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount) {
+    return generateMipLevels(levels, atlas, glyphs, glyphCount, imageType, levelCount, threadCount);
+}
+
+bool generateMipmaps(std::vector<msdfgen::Bitmap<float, 3>, Allocator<msdfgen::Bitmap<float, 3> > > &levels, const msdfgen::BitmapConstRef<float, 3> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount) {
+    return generateMipLevels(levels, atlas, glyphs, glyphCount, imageType, levelCount, threadCount);
+}
+
+bool generateMipmaps(std::vector<msdfgen::Bitmap<float, 4>, Allocator<msdfgen::Bitmap<float, 4> > > &levels, const msdfgen::BitmapConstRef<float, 4> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount) {
+    return generateMipLevels(levels, atlas, glyphs, glyphCount, imageType, levelCount, threadCount);
+}
+
+}
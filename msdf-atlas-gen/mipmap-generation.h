@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include <msdfgen.h>
+#include "types.h"
+#include "GlyphGeometry.h"
+
+namespace msdf_atlas {
+
+// Functions to generate the mip chain of a finished atlas (level 0)
+// Each pixel of a level is averaged only from the pixels of the previous level which belong to the same glyph box, so glyphs never bleed into each other.
+// For distance field types, distances are halved with each level so that every level keeps the atlas's pixel range in its own pixels,
+// and for multi-channel distance fields, pixels whose median would end up on the wrong side of the edge are corrected.
+
+/// Returns the number of levels of a full mip chain of an image of the given dimensions (down to 1x1)
+int mipLevelCount(int width, int height);
+
+/// Generates mip levels 1 to levelCount-1 of the atlas into levels (appended) using threadCount threads for each level
+bool generateMipmaps(std::vector<msdfgen::Bitmap<byte, 1>, Allocator<msdfgen::Bitmap<byte, 1> > > &levels, const msdfgen::BitmapConstRef<byte, 1> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount);
+bool generateMipmaps(std::vector<msdfgen::Bitmap<byte, 3>, Allocator<msdfgen::Bitmap<byte, 3> > > &levels, const msdfgen::BitmapConstRef<byte, 3> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount);
+bool generateMipmaps(std::vector<msdfgen::Bitmap<byte, 4>, Allocator<msdfgen::Bitmap<byte, 4> > > &levels, const msdfgen::BitmapConstRef<byte, 4> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount);
+bool generateMipmaps(std::vector<msdfgen::Bitmap<float, 1>, Allocator<msdfgen::Bitmap<float, 1> > > &levels, const msdfgen::BitmapConstRef<float, 1> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount);
+bool generateMipmaps(std::vector<msdfgen::Bitmap<float, 3>, Allocator<msdfgen::Bitmap<float, 3> > > &levels, const msdfgen::BitmapConstRef<float, 3> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount);
+bool generateMipmaps(std::vector<msdfgen::Bitmap<float, 4>, Allocator<msdfgen::Bitmap<float, 4> > > &levels, const msdfgen::BitmapConstRef<float, 4> &atlas, const GlyphGeometry *glyphs, int glyphCount, ImageType imageType, int levelCount, int threadCount);
+
+}
@@ -18,22 +18,40 @@
 #include "Charset.h"
 #include "GlyphBox.h"
 #include "GlyphGeometry.h"
+#include "FlatHashMap.h"
+#include "FontFile.h"
 #include "FontGeometry.h"
+#include "kerning-tables.h"
+#include "ShapeCache.h"
 #include "RectanglePacker.h"
+#include "SkylinePacker.h"
 #include "rectangle-packing.h"
+#include "ThreadPool.h"
 #include "Workload.h"
+#include "Tracer.h"
 #include "size-selectors.h"
 #include "bitmap-blit.h"
 #include "AtlasStorage.h"
 #include "BitmapAtlasStorage.h"
+#include "FileMapping.h"
+#include "MappedAtlasStorage.h"
 #include "TightAtlasPacker.h"
 #include "GridAtlasPacker.h"
 #include "AtlasGenerator.h"
 #include "ImmediateAtlasGenerator.h"
+#include "AsyncAtlasGenerator.h"
+#include "StreamingAtlasGenerator.h"
 #include "DynamicAtlas.h"
+#include "GlyphCacheAtlas.h"
+#include "AtlasLayoutState.h"
 #include "glyph-generators.h"
 #include "image-encode.h"
+#include "image-load.h"
+#include "mipmap-generation.h"
+#include "block-compression.h"
+#include "texture-export.h"
 #include "image-save.h"
+#include "PngWriter.h"
 #include "artery-font-export.h"
 #include "csv-export.h"
 #include "json-export.h"
@@ -10,10 +10,16 @@ namespace msdf_atlas {
 /// Packs the rectangle array into an atlas with fixed dimensions, returns how many didn't fit (0 on success)
 template <typename RectangleType>
 int packRectangles(RectangleType *rectangles, int count, int width, int height, int spacing = 0);
+/// Same as above but uses a specific packer class (RectanglePacker or SkylinePacker)
+template <class Packer, typename RectangleType>
+int packRectangles(RectangleType *rectangles, int count, int width, int height, int spacing = 0);
 
 /// Packs the rectangle array into an atlas of unknown size, returns the minimum required dimensions constrained by SizeSelector
 template <class SizeSelector, typename RectangleType>
 std::pair<int, int> packRectangles(RectangleType *rectangles, int count, int spacing = 0);
+/// Same as above but uses a specific packer class (RectanglePacker or SkylinePacker)
+template <class Packer, class SizeSelector, typename RectangleType>
+std::pair<int, int> packRectangles(RectangleType *rectangles, int count, int spacing = 0);
 
 }
 
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "RectanglePacker.h"
+#include "SkylinePacker.h"
 
 namespace msdf_atlas {
 
@@ -18,13 +19,18 @@ static void copyRectanglePlacement(OrientedRectangle &dst, const OrientedRectang
 }
 
 template <typename RectangleType>
+int packRectangles(RectangleType *rectangles, int count, int width, int height, int spacing) {
+    return packRectangles<RectanglePacker>(rectangles, count, width, height, spacing);
+}
+
+template <class Packer, typename RectangleType>
 int packRectangles(RectangleType *rectangles, int count, int width, int height, int spacing) {
     if (spacing)
         for (int i = 0; i < count; ++i) {
             rectangles[i].w += spacing;
             rectangles[i].h += spacing;
         }
-    int result = RectanglePacker(width+spacing, height+spacing).pack(rectangles, count);
+    int result = Packer(width+spacing, height+spacing).pack(rectangles, count);
     if (spacing)
         for (int i = 0; i < count; ++i) {
             rectangles[i].w -= spacing;
@@ -34,6 +40,11 @@ int packRectangles(RectangleType *rectangles, int count, int width, int height,
 }
 
 template <class SizeSelector, typename RectangleType>
+std::pair<int, int> packRectangles(RectangleType *rectangles, int count, int spacing) {
+    return packRectangles<RectanglePacker, SizeSelector>(rectangles, count, spacing);
+}
+
+template <class Packer, class SizeSelector, typename RectangleType>
 std::pair<int, int> packRectangles(RectangleType *rectangles, int count, int spacing) {
     std::vector<RectangleType, Allocator<RectangleType>> rectanglesCopy(count);
     int totalArea = 0;
@@ -46,7 +57,7 @@ std::pair<int, int> packRectangles(RectangleType *rectangles, int count, int spa
     SizeSelector sizeSelector(totalArea);
     int width, height;
     while (sizeSelector(width, height)) {
-        if (!RectanglePacker(width+spacing, height+spacing).pack(rectanglesCopy.data(), count)) {
+        if (!Packer(width+spacing, height+spacing).pack(rectanglesCopy.data(), count)) {
             dimensions.first = width;
             dimensions.second = height;
             for (int i = 0; i < count; ++i)
@@ -0,0 +1,216 @@
+
+#include "texture-export.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace msdf_atlas {
+
+#define DDS_DXGI_FORMAT_BC4_UNORM 80u
+#define DDS_DXGI_FORMAT_BC7_UNORM 98u
+#define KTX2_VK_FORMAT_BC4_UNORM_BLOCK 139u
+#define KTX2_VK_FORMAT_BC7_UNORM_BLOCK 145u
+#define KTX2_DF_MODEL_BC4 131u
+#define KTX2_DF_MODEL_BC7 134u
+
+typedef std::vector<byte, Allocator<byte>> ByteVector;
+
+static void writeUint32(ByteVector &output, unsigned value) {
+    for (int i = 0; i < 4; ++i)
+        output.push_back(byte(value>>8*i));
+}
+
+static void writeUint64(ByteVector &output, unsigned long long value) {
+    for (int i = 0; i < 8; ++i)
+        output.push_back(byte(value>>8*i));
+}
+
+static void writeString(ByteVector &output, const char *str) {
+    output.insert(output.end(), (const byte *) str, (const byte *) str+strlen(str)+1);
+}
+
+static void alignOutput(ByteVector &output, size_t alignment) {
+    output.resize((output.size()+alignment-1)/alignment*alignment, byte(0));
+}
+
+static bool validLevels(BlockFormat format, int width, int height, const ByteVector *levels, int levelCount) {
+    if (!(width > 0 && height > 0 && levels && levelCount > 0))
+        return false;
+    for (int i = 0; i < levelCount; ++i) {
+        if (levels[i].size() != blockCompressedSize(format, std::max(width>>i, 1), std::max(height>>i, 1)))
+            return false;
+    }
+    return true;
+}
+
+static bool writeFile(const char *filename, const ByteVector &header, const ByteVector *levels, int levelCount, bool smallestFirst, size_t alignment) {
+    FILE *file = fopen(filename, "wb");
+    if (!file)
+        return false;
+    static const byte padding[16] = { };
+    size_t offset = header.size();
+    bool success = fwrite(header.data(), 1, header.size(), file) == header.size();
+    for (int i = 0; i < levelCount && success; ++i) {
+        const ByteVector &level = levels[smallestFirst ? levelCount-1-i : i];
+        size_t padded = (offset+alignment-1)/alignment*alignment;
+        success = fwrite(padding, 1, padded-offset, file) == padded-offset && fwrite(level.data(), 1, level.size(), file) == level.size();
+        offset = padded+level.size();
+    }
+    return !fclose(file) && success;
+}
+
+bool saveDds(const char *filename, BlockFormat format, int width, int height, const ByteVector *levels, int levelCount) {
+    if (!validLevels(format, width, height, levels, levelCount))
+        return false;
+    ByteVector header;
+    header.reserve(148);
+    writeUint32(header, 0x20534444u); // "DDS "
+    writeUint32(header, 124u);
+    // CAPS | HEIGHT | WIDTH | PIXELFORMAT | LINEARSIZE (| MIPMAPCOUNT)
+    writeUint32(header, 0x00081007u|(levelCount > 1 ? 0x00020000u : 0u));
+    writeUint32(header, (unsigned) height);
+    writeUint32(header, (unsigned) width);
+    writeUint32(header, (unsigned) levels[0].size());
+    writeUint32(header, 0u);
+    writeUint32(header, (unsigned) levelCount);
+    for (int i = 0; i < 11; ++i)
+        writeUint32(header, 0u);
+    // Pixel format - defined by the DX10 header extension
+    writeUint32(header, 32u);
+    writeUint32(header, 0x4u); // FOURCC
+    writeUint32(header, 0x30315844u); // "DX10"
+    for (int i = 0; i < 5; ++i)
+        writeUint32(header, 0u);
+    // TEXTURE (| COMPLEX | MIPMAP)
+    writeUint32(header, 0x1000u|(levelCount > 1 ? 0x400008u : 0u));
+    for (int i = 0; i < 4; ++i)
+        writeUint32(header, 0u);
+    // DX10 header extension
+    writeUint32(header, format == BlockFormat::BC4 ? DDS_DXGI_FORMAT_BC4_UNORM : DDS_DXGI_FORMAT_BC7_UNORM);
+    writeUint32(header, 3u); // TEXTURE2D
+    writeUint32(header, 0u);
+    writeUint32(header, 1u);
+    writeUint32(header, 0u);
+    return writeFile(filename, header, levels, levelCount, false, 1);
+}
+
+bool saveKtx2(const char *filename, BlockFormat format, int width, int height, const ByteVector *levels, int levelCount) {
+    if (!validLevels(format, width, height, levels, levelCount))
+        return false;
+    static const byte identifier[12] = { 0xab, 'K', 'T', 'X', ' ', '2', '0', 0xbb, '\r', '\n', 0x1a, '\n' };
+    size_t blockSize = blockCompressedSize(format, 4, 4);
+
+    // Data format descriptor - a single basic block with one sample
+    ByteVector dfd;
+    writeUint32(dfd, 44u);
+    writeUint32(dfd, 0u);
+    writeUint32(dfd, 2u|40u<<16);
+    writeUint32(dfd, (format == BlockFormat::BC4 ? KTX2_DF_MODEL_BC4 : KTX2_DF_MODEL_BC7)|1u<<8|1u<<16); // BT.709 primaries, linear transfer
+    writeUint32(dfd, 0x0303u);
+    writeUint32(dfd, (unsigned) blockSize);
+    writeUint32(dfd, 0u);
+    writeUint32(dfd, (unsigned) (8*blockSize-1)<<16);
+    writeUint32(dfd, 0u);
+    writeUint32(dfd, 0u);
+    writeUint32(dfd, 0xffffffffu);
+
+    // Key/value data - rows are stored from the top
+    ByteVector kvd;
+    const char *keyValues[2][2] = {
+        { "KTXorientation", "rd" },
+        { "KTXwriter", "msdf-atlas-gen" }
+    };
+    for (int i = 0; i < 2; ++i) {
+        writeUint32(kvd, (unsigned) (strlen(keyValues[i][0])+strlen(keyValues[i][1])+2));
+        writeString(kvd, keyValues[i][0]);
+        writeString(kvd, keyValues[i][1]);
+        alignOutput(kvd, 4);
+    }
+
+    size_t dfdOffset = 80+24*levelCount;
+    size_t kvdOffset = dfdOffset+dfd.size();
+    // Levels are stored from the smallest, each aligned to the block size
+    std::vector<size_t, Allocator<size_t>> levelOffsets(levelCount);
+    size_t offset = kvdOffset+kvd.size();
+    for (int i = levelCount-1; i >= 0; --i) {
+        offset = (offset+blockSize-1)/blockSize*blockSize;
+        levelOffsets[i] = offset;
+        offset += levels[i].size();
+    }
+
+    ByteVector header(identifier, identifier+sizeof(identifier));
+    header.reserve(kvdOffset+kvd.size());
+    writeUint32(header, format == BlockFormat::BC4 ? KTX2_VK_FORMAT_BC4_UNORM_BLOCK : KTX2_VK_FORMAT_BC7_UNORM_BLOCK);
+    writeUint32(header, 1u);
+    writeUint32(header, (unsigned) width);
+    writeUint32(header, (unsigned) height);
+    writeUint32(header, 0u);
+    writeUint32(header, 0u);
+    writeUint32(header, 1u);
+    writeUint32(header, (unsigned) levelCount);
+    writeUint32(header, 0u);
+    writeUint32(header, (unsigned) dfdOffset);
+    writeUint32(header, (unsigned) dfd.size());
+    writeUint32(header, (unsigned) kvdOffset);
+    writeUint32(header, (unsigned) kvd.size());
+    writeUint64(header, 0ull);
+    writeUint64(header, 0ull);
+    for (int i = 0; i < levelCount; ++i) {
+        writeUint64(header, levelOffsets[i]);
+        writeUint64(header, levels[i].size());
+        writeUint64(header, levels[i].size());
+    }
+    header.insert(header.end(), dfd.begin(), dfd.end());
+    header.insert(header.end(), kvd.begin(), kvd.end());
+    return writeFile(filename, header, levels, levelCount, true, blockSize);
+}
+
+bool saveCompressedTexture(const char *filename, ImageFormat imageFormat, BlockFormat format, int width, int height, const ByteVector *levels, int levelCount) {
+    switch (imageFormat) {
+        case ImageFormat::DDS:
+            return saveDds(filename, format, width, height, levels, levelCount);
+        case ImageFormat::KTX2:
+            return saveKtx2(filename, format, width, height, levels, levelCount);
+        default:;
+    }
+    return false;
+}
+
+template <int N>
+static bool compressAndSave(const msdfgen::BitmapConstRef<byte, N> &bitmap, const msdfgen::Bitmap<byte, N> *mipLevels, int mipLevelCount, ImageFormat format, const char *filename, int threadCount) {
+    std::vector<ByteVector, Allocator<ByteVector> > levels(1+mipLevelCount);
+    if (!compressBlocks(levels[0], bitmap, threadCount))
+        return false;
+    for (int i = 0; i < mipLevelCount; ++i) {
+        if (!compressBlocks(levels[1+i], (msdfgen::BitmapConstRef<byte, N>) mipLevels[i], threadCount))
+            return false;
+    }
+    return saveCompressedTexture(filename, format, blockFormatForChannels(N), bitmap.width, bitmap.height, levels.data(), (int) levels.size());
+}
+
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 1> &bitmap, ImageFormat format, const char *filename, int threadCount) {
+    return compressAndSave<1>(bitmap, nullptr, 0, format, filename, threadCount);
+}
+
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 3> &bitmap, ImageFormat format, const char *filename, int threadCount) {
+    return compressAndSave<3>(bitmap, nullptr, 0, format, filename, threadCount);
+}
+
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 4> &bitmap, ImageFormat format, const char *filename, int threadCount) {
+    return compressAndSave<4>(bitmap, nullptr, 0, format, filename, threadCount);
+}
+
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 1> &bitmap, const msdfgen::Bitmap<byte, 1> *mipLevels, int mipLevelCount, ImageFormat format, const char *filename, int threadCount) {
+    return compressAndSave(bitmap, mipLevels, mipLevelCount, format, filename, threadCount);
+}
+
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 3> &bitmap, const msdfgen::Bitmap<byte, 3> *mipLevels, int mipLevelCount, ImageFormat format, const char *filename, int threadCount) {
+    return compressAndSave(bitmap, mipLevels, mipLevelCount, format, filename, threadCount);
+}
+
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 4> &bitmap, const msdfgen::Bitmap<byte, 4> *mipLevels, int mipLevelCount, ImageFormat format, const char *filename, int threadCount) {
+    return compressAndSave(bitmap, mipLevels, mipLevelCount, format, filename, threadCount);
+}
+
+}
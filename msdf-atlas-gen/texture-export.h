@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+#include <msdfgen.h>
+#include "types.h"
+#include "block-compression.h"
+
+namespace msdf_atlas {
+
+// Functions to save block-compressed GPU textures as DDS (with the DX10 header extension) or KTX2 files
+// Mip levels are passed largest first, each holding its blocks in rows from the top of the image
+
+/// Saves the compressed mip levels of a texture of the given dimensions as a DDS file
+bool saveDds(const char *filename, BlockFormat format, int width, int height, const std::vector<byte, Allocator<byte>> *levels, int levelCount);
+/// Saves the compressed mip levels of a texture of the given dimensions as a KTX2 file
+bool saveKtx2(const char *filename, BlockFormat format, int width, int height, const std::vector<byte, Allocator<byte>> *levels, int levelCount);
+/// Saves the compressed mip levels of a texture as a DDS or KTX2 file depending on imageFormat
+bool saveCompressedTexture(const char *filename, ImageFormat imageFormat, BlockFormat format, int width, int height, const std::vector<byte, Allocator<byte>> *levels, int levelCount);
+
+/// Compresses the bitmap using threadCount threads and saves it as a DDS or KTX2 file depending on format
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 1> &bitmap, ImageFormat format, const char *filename, int threadCount);
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 3> &bitmap, ImageFormat format, const char *filename, int threadCount);
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 4> &bitmap, ImageFormat format, const char *filename, int threadCount);
+/// Compresses the bitmap (level 0) and its mipLevelCount following mip levels using threadCount threads and saves them as a DDS or KTX2 file depending on format
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 1> &bitmap, const msdfgen::Bitmap<byte, 1> *mipLevels, int mipLevelCount, ImageFormat format, const char *filename, int threadCount);
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 3> &bitmap, const msdfgen::Bitmap<byte, 3> *mipLevels, int mipLevelCount, ImageFormat format, const char *filename, int threadCount);
+bool saveCompressedTexture(const msdfgen::BitmapConstRef<byte, 4> &bitmap, const msdfgen::Bitmap<byte, 4> *mipLevels, int mipLevelCount, ImageFormat format, const char *filename, int threadCount);
+
+}
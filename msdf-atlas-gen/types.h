@@ -40,7 +40,19 @@ enum class ImageFormat {
     TEXT_FLOAT,
     BINARY,
     BINARY_FLOAT,
-    BINARY_FLOAT_BE
+    BINARY_FLOAT_BE,
+    DDS,
+    KTX2
+};
+
+/// Trade-off between the speed and the compression ratio of PNG encoding
+enum class PngCompression {
+    /// Fast deflate level and a fixed row filter
+    FAST,
+    /// Default deflate level and adaptive row filters
+    DEFAULT,
+    /// Maximum deflate level and adaptive row filters
+    MAX
 };
 
 /// Glyph identification
@@ -58,7 +70,9 @@ enum class YDirection {
 /// The method of computing the layout of the atlas
 enum class PackingStyle {
     TIGHT,
-    GRID
+    GRID,
+    /// Same as TIGHT but uses SkylinePacker, which is faster for very large charsets
+    SKYLINE
 };
 
 /// Constraints for the atlas's dimensions - see size selectors for more info
@@ -25,6 +25,12 @@ extern "C"
     void msGeneratePseudoSDF(float *data, int w, int h, msShape *shape, double range, double sx, double sy, double dx, double dy);
     void msGenerateMSDF(float *data, int w, int h, msShape *shape, double range, double sx, double sy, double dx, double dy);
     void msGenerateMTSDF(float *data, int w, int h, msShape *shape, double range, double sx, double sy, double dx, double dy);
+    /* Variants which write rows pitch bytes apart, e.g. into a sub-rectangle of a larger buffer (negative pitch for bottom-up rows) */
+    /* The pitch is in bytes, not floats - nothing is generated unless it is a multiple of sizeof(float) and its absolute value is at least w*channels*sizeof(float) */
+    void msGenerateSDFPitched(float *data, int w, int h, int pitch, msShape *shape, double range, double sx, double sy, double dx, double dy);
+    void msGeneratePseudoSDFPitched(float *data, int w, int h, int pitch, msShape *shape, double range, double sx, double sy, double dx, double dy);
+    void msGenerateMSDFPitched(float *data, int w, int h, int pitch, msShape *shape, double range, double sx, double sy, double dx, double dy);
+    void msGenerateMTSDFPitched(float *data, int w, int h, int pitch, msShape *shape, double range, double sx, double sy, double dx, double dy);
 
 #ifdef __cplusplus
 }
@@ -64,6 +64,8 @@ pub const Shape = opaque {
         data: [*]f32,
         w: c_int,
         h: c_int,
+        /// distance between the starts of consecutive rows in bytes, 0 for tightly packed rows
+        pitch: c_int = 0,
         range: f64,
         sx: f64,
         sy: f64,
@@ -74,19 +76,35 @@ pub const Shape = opaque {
     // generator functions
     /// 1 byte per pixel
     pub fn generateSDF(self: *Shape, desc: GenerateDesc) void {
-        msGenerateSDF(desc.data, desc.w, desc.h, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        if (desc.pitch != 0) {
+            msGenerateSDFPitched(desc.data, desc.w, desc.h, desc.pitch, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        } else {
+            msGenerateSDF(desc.data, desc.w, desc.h, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        }
     }
     /// 1 byte per pixel
     pub fn generatePseudoSDF(self: *Shape, desc: GenerateDesc) void {
-        msGeneratePseudoSDF(desc.data, desc.w, desc.h, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        if (desc.pitch != 0) {
+            msGeneratePseudoSDFPitched(desc.data, desc.w, desc.h, desc.pitch, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        } else {
+            msGeneratePseudoSDF(desc.data, desc.w, desc.h, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        }
     }
     /// 3 bytes per pixel
     pub fn generateMSDF(self: *Shape, desc: GenerateDesc) void {
-        msGenerateMSDF(desc.data, desc.w, desc.h, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        if (desc.pitch != 0) {
+            msGenerateMSDFPitched(desc.data, desc.w, desc.h, desc.pitch, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        } else {
+            msGenerateMSDF(desc.data, desc.w, desc.h, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        }
     }
     /// 4 bytes per pixel
     pub fn generateMTSDF(self: *Shape, desc: GenerateDesc) void {
-        msGenerateMTSDF(desc.data, desc.w, desc.h, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        if (desc.pitch != 0) {
+            msGenerateMTSDFPitched(desc.data, desc.w, desc.h, desc.pitch, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        } else {
+            msGenerateMTSDF(desc.data, desc.w, desc.h, self, desc.range, desc.sx, desc.sy, desc.dx, desc.dy);
+        }
     }
 };
 
@@ -117,6 +135,10 @@ extern fn msGenerateSDF(data: [*c]f32, w: c_int, h: c_int, shape: ?*Shape, range
 extern fn msGeneratePseudoSDF(data: [*c]f32, w: c_int, h: c_int, shape: ?*Shape, range: f64, sx: f64, sy: f64, dx: f64, dy: f64) void;
 extern fn msGenerateMSDF(data: [*c]f32, w: c_int, h: c_int, shape: ?*Shape, range: f64, sx: f64, sy: f64, dx: f64, dy: f64) void;
 extern fn msGenerateMTSDF(data: [*c]f32, w: c_int, h: c_int, shape: ?*Shape, range: f64, sx: f64, sy: f64, dx: f64, dy: f64) void;
+extern fn msGenerateSDFPitched(data: [*c]f32, w: c_int, h: c_int, pitch: c_int, shape: ?*Shape, range: f64, sx: f64, sy: f64, dx: f64, dy: f64) void;
+extern fn msGeneratePseudoSDFPitched(data: [*c]f32, w: c_int, h: c_int, pitch: c_int, shape: ?*Shape, range: f64, sx: f64, sy: f64, dx: f64, dy: f64) void;
+extern fn msGenerateMSDFPitched(data: [*c]f32, w: c_int, h: c_int, pitch: c_int, shape: ?*Shape, range: f64, sx: f64, sy: f64, dx: f64, dy: f64) void;
+extern fn msGenerateMTSDFPitched(data: [*c]f32, w: c_int, h: c_int, pitch: c_int, shape: ?*Shape, range: f64, sx: f64, sy: f64, dx: f64, dy: f64) void;
 
 pub const FreetypeHandle = extern struct {
     library: freetype.Library,
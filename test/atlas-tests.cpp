@@ -0,0 +1,428 @@
+
+/*
+ * MSDF ATLAS GENERATOR TESTS
+ * --------------------------
+ * Regression tests of the atlas generator classes. Returns a non-zero exit code if any test fails.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include "msdf-atlas-gen/msdf-atlas-gen.h"
+
+using namespace msdf_atlas;
+
+#define TEST_RANGE 2
+
+extern "C" void *msdfAllocate(size_t size) {
+    return malloc(size);
+}
+
+extern "C" void msdfDeallocate(void *ptr, size_t) {
+    free(ptr);
+}
+
+typedef ImmediateAtlasGenerator<float, 1, sdfGenerator, BitmapAtlasStorage<float, 1>> TestAtlasGenerator;
+
+/// Creates the glyph of a square, whose box is about side pixels wide
+static GlyphGeometry squareGlyph(int index, int side) {
+    msdfgen::Shape shape;
+    msdfgen::Contour &contour = shape.addContour();
+    double a = TEST_RANGE, b = side-TEST_RANGE;
+    contour.addEdge(msdfgen::EdgeHolder(msdfgen::Point2(a, a), msdfgen::Point2(a, b)));
+    contour.addEdge(msdfgen::EdgeHolder(msdfgen::Point2(a, b), msdfgen::Point2(b, b)));
+    contour.addEdge(msdfgen::EdgeHolder(msdfgen::Point2(b, b), msdfgen::Point2(b, a)));
+    contour.addEdge(msdfgen::EdgeHolder(msdfgen::Point2(b, a), msdfgen::Point2(a, a)));
+    GlyphGeometry glyph;
+    glyph.load(shape, 1, msdfgen::GlyphIndex(index), 0, side);
+    glyph.wrapBox(1, TEST_RANGE, 0);
+    return glyph;
+}
+
+/// Checks that each glyph's box in the atlas, according to the generator's layout, contains the same pixels as the glyph generated separately
+static bool verifyAtlas(const TestAtlasGenerator &generator, const GlyphGeometry *glyphs, int count) {
+    GeneratorAttributes attributes;
+    bool success = true;
+    for (int i = 0; i < count; ++i) {
+        const GlyphBox &box = generator.getLayout()[i];
+        msdfgen::Bitmap<float, 1> expected(box.rect.w, box.rect.h), actual(box.rect.w, box.rect.h);
+        sdfGenerator(expected, glyphs[i], attributes);
+        generator.atlasStorage(box.page).get(box.rect.x, box.rect.y, actual);
+        int mismatches = 0;
+        for (int y = 0; y < box.rect.h; ++y) {
+            for (int x = 0; x < box.rect.w; ++x)
+                mismatches += *expected(x, y) != *actual(x, y);
+        }
+        if (mismatches) {
+            fprintf(stderr, "Glyph %d (page %d, %dx%d at %d, %d) has %d incorrect pixels\n", box.index, box.page, box.rect.w, box.rect.h, box.rect.x, box.rect.y, mismatches);
+            success = false;
+        }
+    }
+    return success;
+}
+
+/// A rearrangement which enlarges the first page to its maximum side, after which the glyphs no longer fit on it, must not lose the bitmaps of existing glyphs
+static bool testRearrangeWithPageOverflow() {
+    DynamicAtlas<TestAtlasGenerator> atlas;
+    atlas.setMaxPageSide(64);
+    std::vector<GlyphGeometry> glyphs;
+    glyphs.push_back(squareGlyph(1, 12));
+    atlas.add(glyphs.data(), 1);
+    for (int i = 0; i < 4; ++i)
+        glyphs.push_back(squareGlyph(2+i, 32));
+    int changeFlags = atlas.add(glyphs.data()+1, 4, true);
+    if (!(changeFlags&DynamicAtlas<TestAtlasGenerator>::PAGE_ADDED)) {
+        fputs("Test setup did not overflow the first page\n", stderr);
+        return false;
+    }
+    return verifyAtlas(atlas.atlasGenerator(), glyphs.data(), (int) glyphs.size());
+}
+
+/// Only the boxes of generated glyphs must be reported as modified, obtaining a section of the storage alone must not count as a modification
+static bool testDirtyRectangles() {
+    TestAtlasGenerator generator(64, 64);
+    std::vector<Rectangle, Allocator<Rectangle>> dirtyRectangles;
+    generator.mutableAtlasStorage().fetchDirtyRectangles(dirtyRectangles);
+    dirtyRectangles.clear();
+    generator.mutableAtlasStorage().getSection(0, 0, 16, 16);
+    if (generator.mutableAtlasStorage().fetchDirtyRectangles(dirtyRectangles)) {
+        fputs("Obtaining a section marked it as modified\n", stderr);
+        return false;
+    }
+    GlyphGeometry glyph = squareGlyph(1, 12);
+    glyph.placeBox(40, 8);
+    generator.generate(&glyph, 1);
+    Rectangle box = glyph.getBoxRect();
+    if (generator.mutableAtlasStorage().fetchDirtyRectangles(dirtyRectangles) != 1 || dirtyRectangles[0].x != box.x || dirtyRectangles[0].y != box.y || dirtyRectangles[0].w != box.w || dirtyRectangles[0].h != box.h) {
+        fputs("The generated glyph's box was not reported as the only modified rectangle\n", stderr);
+        return false;
+    }
+    return verifyAtlas(generator, &glyph, 1);
+}
+
+/// A mapped atlas storage whose file cannot be created must report that it is not valid
+static bool testMappedStorageFailure() {
+    MappedAtlasStorage<float, 1> storage(64, 64, "nonexistent-directory/atlas.bin");
+    if (storage.isValid()) {
+        fputs("Mapped storage without a file reported as valid\n", stderr);
+        return false;
+    }
+    const MappedAtlasStorage<float, 1> resized((MappedAtlasStorage<float, 1> &&) storage, 128, 128);
+    return !resized.isValid() && !msdfgen::BitmapConstRef<float, 1>(resized).width;
+}
+
+/// Rearranging a bitmap storage of unchanged dimensions must happen in place, otherwise the rectangles are copied into the new bitmap
+static bool testBitmapStorageRearrange() {
+    BitmapAtlasStorage<float, 1> storage(16, 16);
+    float pixels[2][16];
+    for (int i = 0; i < 16; ++i)
+        pixels[0][i] = 1, pixels[1][i] = 2;
+    storage.put(0, 0, msdfgen::BitmapConstRef<float, 1>(pixels[0], 4, 4));
+    storage.put(4, 0, msdfgen::BitmapConstRef<float, 1>(pixels[1], 4, 4));
+    const float *prevPixels = msdfgen::BitmapConstRef<float, 1>((const BitmapAtlasStorage<float, 1> &) storage).pixels;
+    Remap remapping[2] = { };
+    remapping[0].source.x = 0, remapping[0].target.x = 4;
+    remapping[1].source.x = 4, remapping[1].target.x = 0;
+    remapping[0].width = remapping[0].height = remapping[1].width = remapping[1].height = 4;
+    BitmapAtlasStorage<float, 1> swapped((BitmapAtlasStorage<float, 1> &&) storage, 16, 16, remapping, 2);
+    msdfgen::BitmapConstRef<float, 1> swappedRef((const BitmapAtlasStorage<float, 1> &) swapped);
+    if (swappedRef.pixels != prevPixels || *swappedRef(0, 0) != 2 || *swappedRef(4, 3) != 1) {
+        fputs("Rectangles were not swapped in place\n", stderr);
+        return false;
+    }
+    remapping[0].source.x = 0, remapping[0].target.x = 20, remapping[0].target.y = 20;
+    const BitmapAtlasStorage<float, 1> grown((BitmapAtlasStorage<float, 1> &&) swapped, 32, 32, remapping, 1);
+    msdfgen::BitmapConstRef<float, 1> grownRef(grown);
+    if (grownRef.width != 32 || *grownRef(20, 20) != 2 || *grownRef(0, 0) != 0 || *grownRef(4, 0) != 0) {
+        fputs("Rectangles were not moved into the grown bitmap\n", stderr);
+        return false;
+    }
+    return true;
+}
+
+/// A workload run on a thread pool from another thread while the pool is busy must not wait for the pool's current workload to finish
+static bool testConcurrentThreadPoolRuns() {
+    ThreadPool threadPool(2);
+    std::atomic<bool> otherFinished(false);
+    std::thread other;
+    bool waited = threadPool.run([&](int i, int) -> bool {
+        if (i)
+            return true;
+        other = std::thread([&]() {
+            threadPool.run([](int, int) -> bool {
+                return true;
+            }, 4, 2);
+            otherFinished = true;
+        });
+        for (int j = 0; j < 500 && !otherFinished; ++j)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return otherFinished;
+    }, 2, 2);
+    other.join();
+    if (!waited)
+        fputs("Concurrent workload had to wait for the pool's current workload\n", stderr);
+    return waited;
+}
+
+/// A workload run on a thread pool from another thread while the pool is busy must be shared with the idle workers
+static bool testConcurrentThreadPoolSharing() {
+    ThreadPool threadPool(2);
+    std::atomic<bool> otherFinished(false), otherShared(false);
+    std::thread other;
+    threadPool.run([&](int i, int) -> bool {
+        if (i)
+            return true;
+        other = std::thread([&]() {
+            threadPool.run([&](int, int threadNo) -> bool {
+                if (threadNo)
+                    otherShared = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                return true;
+            }, 256, 2);
+            otherFinished = true;
+        });
+        for (int j = 0; j < 500 && !otherFinished; ++j)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return true;
+    }, 2, 2);
+    other.join();
+    if (!otherShared)
+        fputs("Concurrent workload was processed by the calling thread alone\n", stderr);
+    return otherShared;
+}
+
+/// A cached glyph replaced by a version that doesn't fit must be reported as evicted
+static bool testGlyphCacheReplacementOverflow() {
+    GlyphCacheAtlas<TestAtlasGenerator> cache(32, 32);
+    int key = 1;
+    GlyphGeometry glyph = squareGlyph(1, 12);
+    cache.add(&key, &glyph, 1);
+    glyph = squareGlyph(1, 48);
+    GlyphCacheAtlas<TestAtlasGenerator>::ChangeFlags changeFlags = cache.add(&key, &glyph, 1);
+    if (!(changeFlags&GlyphCacheAtlas<TestAtlasGenerator>::INCOMPLETE)) {
+        fputs("Test setup did not overflow the cache\n", stderr);
+        return false;
+    }
+    const std::vector<int, Allocator<int>> &evictedKeys = cache.getEvictedKeys();
+    if (cache.contains(key) || !(changeFlags&GlyphCacheAtlas<TestAtlasGenerator>::EVICTED) || evictedKeys.size() != 1 || evictedKeys[0] != key) {
+        fputs("Replaced glyph was not reported as evicted\n", stderr);
+        return false;
+    }
+    return true;
+}
+
+/// The batch callback must see its glyphs as no longer pending, and wait must not return before the callback has
+static bool testAsyncCallbackPendingCount() {
+    AsyncAtlasGenerator<float, 1, sdfGenerator, BitmapAtlasStorage<float, 1>> generator(64, 64);
+    std::atomic<int> pendingInCallback(-1);
+    std::atomic<bool> callbackReturned(false);
+    generator.setCallback([&](const GlyphBox *, int) {
+        pendingInCallback = generator.getPendingCount();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        callbackReturned = true;
+    });
+    GlyphGeometry glyph = squareGlyph(1, 12);
+    glyph.placeBox(0, 0);
+    generator.generate(&glyph, 1);
+    generator.wait();
+    if (!callbackReturned || pendingInCallback != 0) {
+        fprintf(stderr, "Callback saw %d pending glyphs, returned before wait: %s\n", (int) pendingInCallback, callbackReturned ? "yes" : "no");
+        return false;
+    }
+    return true;
+}
+
+/// A glyph evicted from the cache while still queued must not be generated over the glyph that took its place
+static bool testAsyncGlyphCacheEviction() {
+    typedef AsyncAtlasGenerator<float, 1, sdfGenerator, BitmapAtlasStorage<float, 1>> TestAsyncAtlasGenerator;
+    GlyphCacheAtlas<TestAsyncAtlasGenerator> cache(16, 16);
+    std::vector<GlyphGeometry> glyphs;
+    int keys[] = { 1, 2 };
+    // The replacement is larger so that it would be generated first in a common batch
+    glyphs.push_back(squareGlyph(1, 10));
+    glyphs.push_back(squareGlyph(2, 12));
+    // Hold the background thread in the callback of a first batch so that both glyphs are queued at the same time
+    std::mutex blocker;
+    std::atomic<bool> blocked(false);
+    blocker.lock();
+    cache.atlasGenerator().setCallback([&](const GlyphBox *, int) {
+        blocked = true;
+        std::lock_guard<std::mutex> lock(blocker);
+    });
+    GlyphGeometry first = squareGlyph(3, 12);
+    int firstKey = 3;
+    cache.add(&firstKey, &first, 1);
+    while (!blocked)
+        std::this_thread::yield();
+    cache.advanceStamp();
+    cache.add(keys, glyphs.data(), 1);
+    cache.advanceStamp();
+    cache.add(keys+1, glyphs.data()+1, 1);
+    blocker.unlock();
+    cache.atlasGenerator().wait();
+    std::vector<GlyphGeometry> expected(1, glyphs[1]);
+    const BitmapAtlasStorage<float, 1> &storage = cache.atlasGenerator().atlasStorage();
+    GeneratorAttributes attributes;
+    Rectangle box = expected[0].getBoxRect();
+    msdfgen::Bitmap<float, 1> expectedBitmap(box.w, box.h), actualBitmap(box.w, box.h);
+    sdfGenerator(expectedBitmap, expected[0], attributes);
+    storage.get(box.x, box.y, actualBitmap);
+    for (int y = 0; y < box.h; ++y) {
+        for (int x = 0; x < box.w; ++x) {
+            if (*expectedBitmap(x, y) != *actualBitmap(x, y)) {
+                fputs("Evicted glyph was generated over its replacement\n", stderr);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static std::atomic<int> blockingGeneratorCalls(0);
+static std::mutex blockingGeneratorMutex;
+
+/// Same as sdfGenerator but counts its calls and doesn't proceed while blockingGeneratorMutex is locked
+static void blockingSdfGenerator(const msdfgen::BitmapSection<float, 1> &output, const GlyphGeometry &glyph, const GeneratorAttributes &attributes) {
+    ++blockingGeneratorCalls;
+    { std::lock_guard<std::mutex> lock(blockingGeneratorMutex); }
+    sdfGenerator(output, glyph, attributes);
+}
+
+/// A glyph identical to one being generated must be copied rather than generated again
+static bool testAsyncCoalescing() {
+    AsyncAtlasGenerator<float, 1, blockingSdfGenerator, BitmapAtlasStorage<float, 1>> generator(64, 64);
+    GlyphGeometry glyphs[2] = { squareGlyph(1, 12), squareGlyph(1, 12) };
+    glyphs[0].placeBox(0, 0);
+    glyphs[1].placeBox(32, 16);
+    blockingGeneratorCalls = 0;
+    blockingGeneratorMutex.lock();
+    generator.generate(glyphs, 1);
+    while (!blockingGeneratorCalls)
+        std::this_thread::yield();
+    generator.generate(glyphs+1, 1);
+    blockingGeneratorMutex.unlock();
+    generator.wait();
+    if (blockingGeneratorCalls != 1) {
+        fprintf(stderr, "Identical glyph was generated %d times\n", (int) blockingGeneratorCalls);
+        return false;
+    }
+    GeneratorAttributes attributes;
+    for (const GlyphGeometry &glyph : glyphs) {
+        Rectangle box = glyph.getBoxRect();
+        msdfgen::Bitmap<float, 1> expected(box.w, box.h), actual(box.w, box.h);
+        sdfGenerator(expected, glyph, attributes);
+        generator.atlasStorage().get(box.x, box.y, actual);
+        for (int y = 0; y < box.h; ++y) {
+            for (int x = 0; x < box.w; ++x) {
+                if (*expected(x, y) != *actual(x, y)) {
+                    fputs("Copied glyph has incorrect pixels\n", stderr);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/// A dynamic atlas with a storage that cannot create pages by itself must add them with the page factory
+static bool testDynamicAtlasPageFactory() {
+    typedef ImmediateAtlasGenerator<float, 1, sdfGenerator, MappedAtlasStorage<float, 1>> MappedAtlasGenerator;
+    const char *filenames[] = { "atlas-tests-page0.bin", "atlas-tests-page1.bin" };
+    bool success;
+    {
+        DynamicAtlas<MappedAtlasGenerator> atlas(32, filenames[0], MappedAtlasStorage<float, 1>::RAW);
+        atlas.setMaxPageSide(32);
+        atlas.setPageFactory([&filenames](MappedAtlasGenerator &generator, int width, int height) -> int {
+            return generator.getPageCount() < 2 ? generator.addPage(width, height, filenames[generator.getPageCount()], MappedAtlasStorage<float, 1>::RAW) : -1;
+        });
+        std::vector<GlyphGeometry> glyphs;
+        for (int i = 0; i < 2; ++i)
+            glyphs.push_back(squareGlyph(1+i, 24));
+        atlas.add(glyphs.data(), (int) glyphs.size());
+        success = atlas.atlasGenerator().getPageCount() == 2 && atlas.atlasGenerator().atlasStorage(1).isValid();
+        if (!success)
+            fputs("Second page was not added by the page factory\n", stderr);
+    }
+    for (const char *filename : filenames)
+        remove(filename);
+    return success;
+}
+
+/// A key appearing more than once in a batch must only occupy space in the cache once
+static bool testGlyphCacheDuplicateKeys() {
+    GlyphCacheAtlas<TestAtlasGenerator> cache(32, 32);
+    int keys[3] = { 1, 1, 2 };
+    GlyphGeometry glyphs[3] = { squareGlyph(1, 12), squareGlyph(1, 12), squareGlyph(2, 12) };
+    GlyphCacheAtlas<TestAtlasGenerator>::ChangeFlags changeFlags = cache.add(keys, glyphs, 2);
+    if (changeFlags != GlyphCacheAtlas<TestAtlasGenerator>::NO_CHANGE || cache.getGlyphCount() != 1) {
+        fputs("Duplicate key was not added as a single glyph\n", stderr);
+        return false;
+    }
+    // Three more glyphs only fit if the duplicate didn't leak its rectangle
+    keys[0] = 2, keys[1] = 3, keys[2] = 4;
+    for (int i = 0; i < 3; ++i)
+        glyphs[i] = squareGlyph(2+i, 12);
+    changeFlags = cache.add(keys, glyphs, 3);
+    if (changeFlags != GlyphCacheAtlas<TestAtlasGenerator>::NO_CHANGE || cache.getGlyphCount() != 4) {
+        fputs("Space of the duplicate key's first glyph was not reclaimed\n", stderr);
+        return false;
+    }
+    return true;
+}
+
+/// A layout state file whose entry count exceeds its size must be rejected without allocating for the count
+static bool testLayoutStateEntryCount() {
+    const char *filename = "atlas-tests-layout.bin";
+    GlyphGeometry glyph = squareGlyph(1, 8);
+    glyph.placeBox(0, 0);
+    bool success = AtlasLayoutState(&glyph, 1, 16, 16, 0).save(filename);
+    if (FILE *f = success ? fopen(filename, "r+b") : nullptr) {
+        const unsigned char count[4] = { 0xff, 0xff, 0xff, 0x7f };
+        success = !fseek(f, 12, SEEK_SET) && fwrite(count, 1, 4, f) == 4;
+        success = !fclose(f) && success;
+    } else
+        success = false;
+    if (!success) {
+        fputs("Test setup failed to write the layout state\n", stderr);
+        remove(filename);
+        return false;
+    }
+    AtlasLayoutState layoutState;
+    success = !layoutState.load(filename);
+    if (!success)
+        fputs("Layout state with an excessive entry count was loaded\n", stderr);
+    remove(filename);
+    return success;
+}
+
+int main() {
+    struct {
+        const char *name;
+        bool (*run)();
+    } tests[] = {
+        { "rearrange with page overflow", &testRearrangeWithPageOverflow },
+        { "dirty rectangles", &testDirtyRectangles },
+        { "mapped storage failure", &testMappedStorageFailure },
+        { "bitmap storage rearrange", &testBitmapStorageRearrange },
+        { "concurrent thread pool runs", &testConcurrentThreadPoolRuns },
+        { "concurrent thread pool sharing", &testConcurrentThreadPoolSharing },
+        { "glyph cache replacement overflow", &testGlyphCacheReplacementOverflow },
+        { "glyph cache duplicate keys", &testGlyphCacheDuplicateKeys },
+        { "async callback pending count", &testAsyncCallbackPendingCount },
+        { "async glyph cache eviction", &testAsyncGlyphCacheEviction },
+        { "async coalescing", &testAsyncCoalescing },
+        { "dynamic atlas page factory", &testDynamicAtlasPageFactory },
+        { "layout state entry count", &testLayoutStateEntryCount }
+    };
+    int failed = 0;
+    for (const auto &test : tests) {
+        bool passed = test.run();
+        printf("%s: %s\n", test.name, passed ? "passed" : "FAILED");
+        failed += !passed;
+    }
+    return failed ? 1 : 0;
+}